@@ -23,6 +23,11 @@ namespace PAMELA
 		delete m_adjacencySparseMatrix;
 	}
 
+	std::size_t Adjacency::get_MemoryFootprint() const
+	{
+		return sizeof(Adjacency) + sizeof(CSRMatrix) + m_adjacencySparseMatrix->getMemoryFootprint() + m_weights.capacity() * sizeof(double);
+	}
+
 	std::pair<std::vector<int>, std::vector<int>> Adjacency::get_SingleElementAdjacency(int i) const
 	{
 		auto firstColumnIndex = m_adjacencySparseMatrix->columnIndex.begin() + m_adjacencySparseMatrix->rowPtr[i];
@@ -36,17 +41,15 @@ namespace PAMELA
 
 	Adjacency* Adjacency::transposed(Adjacency* input)
 	{
-		Adjacency* adj = new Adjacency(input->get_targetFamily(), input->get_sourceFamily(), input->get_baseFamily(), input->m_targetElementCollection, input->m_sourceElementCollection, input->m_baseElementCollection);
-		adj->m_adjacencySparseMatrix = CSRMatrix::transpose(input->m_adjacencySparseMatrix);
-		return  adj;
+		return new Adjacency(input->get_targetFamily(), input->get_sourceFamily(), input->get_baseFamily(), input->m_targetElementCollection, input->m_sourceElementCollection, input->m_baseElementCollection,
+			CSRMatrix::transpose(input->m_adjacencySparseMatrix));
 	}
 
 
 	Adjacency* Adjacency::multiply(Adjacency* input_lhs, Adjacency* input_rhs)
 	{
-		Adjacency* adj = new Adjacency(input_rhs->get_targetFamily(), input_lhs->get_sourceFamily(), input_lhs->get_targetFamily(), input_rhs->m_targetElementCollection, input_lhs->m_sourceElementCollection, input_lhs->m_targetElementCollection);
-		adj->m_adjacencySparseMatrix = CSRMatrix::product(input_lhs->m_adjacencySparseMatrix, input_rhs->m_adjacencySparseMatrix);
-		return adj;
+		return new Adjacency(input_lhs->get_sourceFamily(), input_rhs->get_targetFamily(), input_lhs->get_targetFamily(), input_lhs->m_sourceElementCollection, input_rhs->m_targetElementCollection, input_lhs->m_targetElementCollection,
+			CSRMatrix::product(input_lhs->m_adjacencySparseMatrix, input_rhs->m_adjacencySparseMatrix));
 	}
 	
 }
@@ -42,6 +42,13 @@ namespace PAMELA
 
 		CSRMatrix* get_adjacencySparseMatrix() { return m_adjacencySparseMatrix; }
 
+		//Weights, one per nonzero of the sparse matrix (e.g. transmissibilities). Empty if the adjacency is not weighted.
+		std::vector<double>& get_Weights() { return m_weights; }
+		const std::vector<double>& get_Weights() const { return m_weights; }
+		bool IsWeighted() const { return !m_weights.empty(); }
+
+		std::size_t get_MemoryFootprint() const;
+
 		//Utils
 		static Adjacency* transposed(Adjacency* input);
 		static Adjacency* multiply(Adjacency* input_lhs, Adjacency* input_rhs);
@@ -71,6 +78,7 @@ namespace PAMELA
 
 		//data
 		CSRMatrix* m_adjacencySparseMatrix;
+		std::vector<double> m_weights;
 	};
 
 
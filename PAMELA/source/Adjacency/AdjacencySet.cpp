@@ -14,172 +14,349 @@
 
 #include "Adjacency/AdjacencySet.hpp"
 #include "Utils/Logger.hpp"
+#include "Utils/Statistics.hpp"
 #include "Elements/Polyhedron.hpp"
 #include "Adjacency/Adjacency.hpp"
+#include <numeric>
 
 namespace PAMELA
 {
 	
 
-	Adjacency* AdjacencySet::get_TopologicalAdjacency(ELEMENTS::FAMILY source, ELEMENTS::FAMILY target, ELEMENTS::FAMILY base)
+	namespace
 	{
-		if (adjacencyExist(source, target, base) != nullptr)
+		// Topological adjacencies between two families are based on the highest dimension one
+		ELEMENTS::FAMILY baseFamily(ELEMENTS::FAMILY family1, ELEMENTS::FAMILY family2)
 		{
-			return adjacencyExist(source, target, base);
+			return static_cast<int>(family1) > static_cast<int>(family2) ? family1 : family2;
 		}
 
-		// SOURCE = POLYHEDRON ; TARGET = POINT ; BASE = POLYHEDRON
-		if ((source == ELEMENTS::FAMILY::POLYHEDRON) && (target == ELEMENTS::FAMILY::POINT) && (base == ELEMENTS::FAMILY::POLYHEDRON))
+		std::string familyName(ELEMENTS::FAMILY family)
 		{
-			return get_TopologicalAdjacency(m_mesh->get_PolyhedronCollection(), m_mesh->get_PointCollection(), m_mesh->get_PolyhedronCollection());
+			switch (family)
+			{
+			case ELEMENTS::FAMILY::POLYHEDRON: return "Polyhedron";
+			case ELEMENTS::FAMILY::POLYGON: return "Polygon";
+			case ELEMENTS::FAMILY::LINE: return "Line";
+			case ELEMENTS::FAMILY::POINT: return "Point";
+			default: return "Unknown";
+			}
 		}
+	}
 
-		// SOURCE = POINT ; TARGET = POLYHEDRON ; BASE = POLYHEDRON
-		if ((source == ELEMENTS::FAMILY::POINT) && (target == ELEMENTS::FAMILY::POLYHEDRON) && (base == ELEMENTS::FAMILY::POLYHEDRON))
+	AdjacencySet::~AdjacencySet()
+	{
+		for (auto& adj : TopologicalAdjacencyMap)
 		{
-			return get_TopologicalAdjacency(m_mesh->get_PointCollection(), m_mesh->get_PolyhedronCollection(), m_mesh->get_PolyhedronCollection());
+			delete adj.second;
 		}
+		for (auto& adj : NonTopologicalAdjacencyMap)
+		{
+			delete adj.second;
+		}
+	}
 
+	Adjacency* AdjacencySet::get_TopologicalAdjacency(ELEMENTS::FAMILY source, ELEMENTS::FAMILY target, ELEMENTS::FAMILY base)
+	{
+		auto adj = adjacencyExist(source, target, base);
+		if (adj != nullptr)
+		{
+			return adj;
+		}
 
-		// SOURCE = POLYHEDRON ; TARGET = POLYGON ; BASE = POLYHEDRON
-		if ((source == ELEMENTS::FAMILY::POLYHEDRON) && (target == ELEMENTS::FAMILY::POLYGON) && (base == ELEMENTS::FAMILY::POLYHEDRON))
+		adj = DeriveTopologicalAdjacency(source, target, base);
+		if (adj == nullptr)
 		{
-			return get_TopologicalAdjacency(m_mesh->get_PolyhedronCollection(), m_mesh->get_PolygonCollection(), m_mesh->get_PolyhedronCollection());
+			LOGERROR("Adjacency " + familyName(source) + " to " + familyName(target) + " through " + familyName(base) + " not implemented yet");
+			return nullptr;
 		}
 
-		// SOURCE = POLYGON ; TARGET = POLYHEDRON ; BASE = POLYHEDRON
-		if ((source == ELEMENTS::FAMILY::POLYGON) && (target == ELEMENTS::FAMILY::POLYHEDRON) && (base == ELEMENTS::FAMILY::POLYHEDRON))
+		familyTriplet tri = std::make_tuple(source, target, base);
+		TopologicalAdjacencyMap[tri] = adj;
+		m_derivedAdjacencies.insert(tri);
+		return adj;
+
+	}
+
+	Adjacency* AdjacencySet::DeriveTopologicalAdjacency(ELEMENTS::FAMILY source, ELEMENTS::FAMILY target, ELEMENTS::FAMILY base)
+	{
+		PAMELA_REGION("AdjacencySet::DeriveTopologicalAdjacency");
+
+		// Primitive: element to its vertices
+		if ((target == ELEMENTS::FAMILY::POINT) && (base == source))
+		{
+			switch (source)
+			{
+			case ELEMENTS::FAMILY::POLYHEDRON: return BuildVertexAdjacency(m_mesh->get_PolyhedronCollection());
+			case ELEMENTS::FAMILY::POLYGON: return BuildVertexAdjacency(m_mesh->get_PolygonCollection());
+			case ELEMENTS::FAMILY::LINE: return BuildVertexAdjacency(m_mesh->get_LineCollection());
+			default: return nullptr;
+			}
+		}
+
+		// Upward adjacency: transpose of the downward one
+		if ((source != target) && (base == baseFamily(source, target)) && (base == target))
 		{
-			return get_TopologicalAdjacency(m_mesh->get_PolygonCollection(), m_mesh->get_PolyhedronCollection(), m_mesh->get_PolyhedronCollection());
+			return Adjacency::transposed(get_TopologicalAdjacency(target, source, base));
 		}
 
-		// SOURCE = POLYHEDRON ; TARGET = POLYHEDRON ; BASE = POLYGON
-		if ((source == ELEMENTS::FAMILY::POLYHEDRON) && (target == ELEMENTS::FAMILY::POLYHEDRON) && (base == ELEMENTS::FAMILY::POLYGON))
+		// Through an intermediate family: product source -> base -> target
+		if ((base != source) && (base != target))
 		{
-			return get_TopologicalAdjacency(m_mesh->get_PolyhedronCollection(), m_mesh->get_PolyhedronCollection(), m_mesh->get_PolygonCollection());
+			Adjacency* adj1 = get_TopologicalAdjacency(source, base, baseFamily(source, base));
+			Adjacency* adj2 = get_TopologicalAdjacency(base, target, baseFamily(base, target));
+			return Adjacency::multiply(adj1, adj2);
 		}
 
-		LOGERROR("Adjacency not implemented yet");
-		return nullptr;
+		// Downward adjacencies other than to the vertices are registered when the elements are created
+		if ((source == ELEMENTS::FAMILY::POLYHEDRON) && (target == ELEMENTS::FAMILY::POLYGON))
+		{
+			LOGERROR("This adjacency must be created while creating Polygons from Polyhedra");
+		}
 
+		return nullptr;
 
 	}
 
-	void AdjacencySet::ClearAfterPartitioning(std::set<int>& PolyhedronOwned, std::set<int>& PolyheronGhost,std::set<int>& PolygonOwned, std::set<int>& PolygonGhost)
+	void AdjacencySet::Add_TopologicalAdjacency(Adjacency* adj)
 	{
+		familyTriplet tri = std::make_tuple(adj->get_sourceFamily(), adj->get_targetFamily(), adj->get_baseFamily());
 
-                utils::pamela_unused(PolyhedronOwned);
-                utils::pamela_unused(PolyheronGhost);
-		//Topological
-		auto adjacency = get_TopologicalAdjacency(ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::FAMILY::POLYGON, ELEMENTS::FAMILY::POLYHEDRON);
-		auto new_adjacency = ClearAfterPartitioning_Topological(adjacency, PolygonOwned, PolygonGhost);
-		delete adjacency;
-		TopologicalAdjacencyMap.clear();
-		TopologicalAdjacencyMap[std::make_tuple(ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::FAMILY::POLYGON, ELEMENTS::FAMILY::POLYHEDRON)] = new_adjacency;
+		// Everything derived may depend on the adjacency being replaced
+		InvalidateTopologicalAdjacencies();
+		auto it = TopologicalAdjacencyMap.find(tri);
+		if ((it != TopologicalAdjacencyMap.end()) && (it->second != adj))
+		{
+			delete it->second;
+		}
+		TopologicalAdjacencyMap[tri] = adj;
+	}
 
-		//Others
+	void AdjacencySet::InvalidateTopologicalAdjacencies(ELEMENTS::FAMILY family)
+	{
+		for (auto it = m_derivedAdjacencies.begin(); it != m_derivedAdjacencies.end();)
+		{
+			if ((std::get<0>(*it) == family) || (std::get<1>(*it) == family) || (std::get<2>(*it) == family))
+			{
+				// Derived adjacencies are recursively built from others, so drop them all
+				InvalidateTopologicalAdjacencies();
+				return;
+			}
+			++it;
+		}
+	}
 
-		/*for (auto it = NonTopologicalAdjacencyMap.begin();it!= NonTopologicalAdjacencyMap.end();++it)
+	void AdjacencySet::InvalidateTopologicalAdjacencies()
+	{
+		for (auto& tri : m_derivedAdjacencies)
 		{
-			auto adj = it->second;
-			auto label = it->first;
-			if((adj->get_sourceFamily()==ELEMENTS::FAMILY::POLYHEDRON)&& (adj->get_targetFamily() == ELEMENTS::FAMILY::POLYHEDRON)&& (adj->get_baseFamily() == ELEMENTS::FAMILY::UNKNOWN))
+			auto it = TopologicalAdjacencyMap.find(tri);
+			if (it != TopologicalAdjacencyMap.end())
 			{
-				ClearAfterPartitioning_NonTopological(adj, PolyhedronOwned, PolyheronGhost);
-				NonTopologicalAdjacencyMap[label] = adj;
+				delete it->second;
+				TopologicalAdjacencyMap.erase(it);
 			}
-		}*/
+		}
+		m_derivedAdjacencies.clear();
+	}
 
+	std::size_t AdjacencySet::get_MemoryFootprint(ELEMENTS::FAMILY source, ELEMENTS::FAMILY target, ELEMENTS::FAMILY base) const
+	{
+		auto it = TopologicalAdjacencyMap.find(std::make_tuple(source, target, base));
+		if (it == TopologicalAdjacencyMap.end())
+		{
+			return 0;
+		}
+		return it->second->get_MemoryFootprint();
 	}
 
+	std::size_t AdjacencySet::get_MemoryFootprint() const
+	{
+		std::size_t size = 0;
+		for (auto& adj : TopologicalAdjacencyMap)
+		{
+			size += adj.second->get_MemoryFootprint();
+		}
+		for (auto& adj : NonTopologicalAdjacencyMap)
+		{
+			size += adj.second->get_MemoryFootprint();
+		}
+		return size;
+	}
 
+	void AdjacencySet::LogMemoryFootprint() const
+	{
+		for (auto& adj : TopologicalAdjacencyMap)
+		{
+			auto& tri = adj.first;
+			std::string kind = m_derivedAdjacencies.count(tri) == 1 ? "cached" : "registered";
+			LOGINFO(familyName(std::get<0>(tri)) + " to " + familyName(std::get<1>(tri)) + " through " + familyName(std::get<2>(tri)) + " (" + kind + "): "
+				+ std::to_string(get_MemoryFootprint(std::get<0>(tri), std::get<1>(tri), std::get<2>(tri))) + " bytes");
+		}
+		for (auto& adj : NonTopologicalAdjacencyMap)
+		{
+			LOGINFO(adj.first + ": " + std::to_string(adj.second->get_MemoryFootprint()) + " bytes");
+		}
+		LOGINFO("Total adjacency memory: " + std::to_string(get_MemoryFootprint()) + " bytes");
+	}
 
-	Adjacency* AdjacencySet::ClearAfterPartitioning_Topological(Adjacency* adjacency, std::set<int>& PolygonOwned, std::set<int>& PolygonGhost)
+	void AdjacencySet::ClearAfterPartitioning()
 	{
-		auto polyhedra = static_cast<PolyhedronCollection*>(adjacency->get_sourceElementCollection());
-		auto polygons = static_cast<PolygonCollection*>(adjacency->get_targetElementCollection());
-		auto csr_matrix = adjacency->get_adjacencySparseMatrix();
+		PAMELA_REGION("AdjacencySet::ClearAfterPartitioning");
+		//Topological: the registered adjacencies (element to face, and element to edge once edges are created) cannot be
+		//derived again and are restricted to the partition
+		get_TopologicalAdjacency(ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::FAMILY::POLYGON, ELEMENTS::FAMILY::POLYHEDRON);
+		std::vector<std::pair<familyTriplet, Adjacency*>> restricted;
+		for (auto& adj : TopologicalAdjacencyMap)
+		{
+			if (m_derivedAdjacencies.count(adj.first) == 0)
+			{
+				restricted.push_back(std::make_pair(adj.first, ClearAfterPartitioning_Topological(adj.second)));
+			}
+		}
+
+		//Everything else refers to the global numbering and is rebuilt on demand
+		for (auto& adj : TopologicalAdjacencyMap)
+		{
+			delete adj.second;
+		}
+		TopologicalAdjacencyMap.clear();
+		m_derivedAdjacencies.clear();
+		TopologicalAdjacencyMap.insert(restricted.begin(), restricted.end());
 
-		auto& columIndex = csr_matrix->columnIndex;
-		auto& rowPtr = csr_matrix->rowPtr;
-		auto& val = csr_matrix->values;
+		//Others
+		for (auto it = NonTopologicalAdjacencyMap.begin(); it != NonTopologicalAdjacencyMap.end(); ++it)
+		{
+			auto adj = it->second;
+			if ((adj->get_sourceFamily() == ELEMENTS::FAMILY::POLYHEDRON) && (adj->get_targetFamily() == ELEMENTS::FAMILY::POLYHEDRON))
+			{
+				it->second = ClearAfterPartitioning_NonTopological(adj);
+				delete adj;
+			}
+		}
 
-		auto new_csr_matrix = new CSRMatrix;
-		auto& new_nnz = new_csr_matrix->nnz = 0;
-		auto& new_columIndex = new_csr_matrix->columnIndex;
-		auto& new_rowPtr = new_csr_matrix->rowPtr;
-		auto& new_val = new_csr_matrix->values;
+	}
 
-		for (auto it = polyhedra->begin(); it != polyhedra->end(); ++it)
+	namespace
+	{
+		//Restrict an adjacency on the global numbering to the rows of the partition. Columns are renumbered with
+		//targetGlobalToLocal and dropped if they are not in the partition, values and weights follow their column.
+		template <class SourceCollection>
+		Adjacency* RestrictToPartition(Adjacency* adjacency, SourceCollection* polyhedra, ParallelEnsembleBase* target, const IndexMap& targetGlobalToLocal)
 		{
-			auto polyhedron_global_index = (*it)->get_globalIndex();
-			auto polyhedron_local_index = (*it)->get_localIndex();
-			auto i0 = rowPtr[polyhedron_global_index];
-			auto i1 = rowPtr[polyhedron_global_index + 1];
-			std::vector<int> sub_columnIndex(columIndex.begin() + i0, columIndex.begin() + i1);
-			std::vector<int> sub_val(val.begin() + i0, val.begin() + i1);
-			std::vector<int> temp;
-			for (size_t i = 0; i != sub_columnIndex.size(); ++i)
+			typedef CSRMatrix::offset_type offset_type;
+			typedef CSRMatrix::index_type index_type;
+
+			auto csr_matrix = adjacency->get_adjacencySparseMatrix();
+			auto& columnIndex = csr_matrix->columnIndex;
+			auto& rowPtr = csr_matrix->rowPtr;
+			auto& val = csr_matrix->values;
+			auto& weights = adjacency->get_Weights();
+			bool hasValues = val.size() == columnIndex.size();
+			bool weighted = adjacency->IsWeighted();
+
+			auto new_csr_matrix = new CSRMatrix(static_cast<index_type>(polyhedra->size_all()), static_cast<index_type>(target->size_all()));
+			auto& new_rowPtr = new_csr_matrix->rowPtr;
+
+			//Row sizes first so that the new matrix is allocated once
+			for (auto it = polyhedra->begin(); it != polyhedra->end(); ++it)
+			{
+				auto irow = (*it)->get_globalIndex();
+				ASSERT(irow + 1 < static_cast<int>(rowPtr.size()), "Element out of the adjacency rows");
+				offset_type n = 0;
+				for (auto j = rowPtr[irow]; j != rowPtr[irow + 1]; ++j)
+				{
+					n += targetGlobalToLocal.find(static_cast<int>(columnIndex[j])) >= 0;
+				}
+				new_rowPtr[(*it)->get_localIndex() + 1] = n;
+			}
+			std::partial_sum(new_rowPtr.begin(), new_rowPtr.end(), new_rowPtr.begin());
+			auto nnz = new_rowPtr.back();
+			new_csr_matrix->nnz = nnz;
+			new_csr_matrix->columnIndex.resize(nnz);
+			new_csr_matrix->values.resize(nnz);
+			auto new_adjacency = new Adjacency(adjacency->get_sourceFamily(), adjacency->get_targetFamily(), adjacency->get_baseFamily(), polyhedra, target, adjacency->get_baseElementCollection(), new_csr_matrix);
+			auto& new_weights = new_adjacency->get_Weights();
+			if (weighted)
 			{
-				auto polygon_global_index = sub_columnIndex[i];
+				new_weights.resize(nnz);
+			}
 
-				if ((PolygonOwned.count(polygon_global_index) == 1) || (PolygonGhost.count(polygon_global_index) == 1))	//face is in the partition
+			//Renumbered entries, sorted by local column
+			std::vector<std::pair<index_type, offset_type>> row;
+			for (auto it = polyhedra->begin(); it != polyhedra->end(); ++it)
+			{
+				auto irow = (*it)->get_globalIndex();
+				row.clear();
+				for (auto j = rowPtr[irow]; j != rowPtr[irow + 1]; ++j)
 				{
-					auto polygon_local_index = polygons->get_GlobalToLocalIndex().at(polygon_global_index);
-					temp.push_back(polygon_local_index);
-					new_val.push_back(polyhedron_local_index);
-					++new_nnz;
+					auto icol = targetGlobalToLocal.find(static_cast<int>(columnIndex[j]));
+					if (icol >= 0)
+					{
+						row.push_back(std::make_pair(static_cast<index_type>(icol), j));
+					}
+				}
+				std::sort(row.begin(), row.end());
+				auto k = new_rowPtr[(*it)->get_localIndex()];
+				for (auto& entry : row)
+				{
+					new_csr_matrix->columnIndex[k] = entry.first;
+					new_csr_matrix->values[k] = hasValues ? val[entry.second] : 1;
+					if (weighted)
+					{
+						new_weights[k] = weights[entry.second];
+					}
+					++k;
 				}
 			}
-			std::sort(temp.begin(), temp.end());
-			new_columIndex.insert(new_columIndex.end(), temp.begin(), temp.end());
-			new_rowPtr.push_back(new_nnz);
+			return new_adjacency;
 		}
-		return new Adjacency(ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::FAMILY::POLYGON, ELEMENTS::FAMILY::POLYHEDRON, polyhedra, polyhedra, polygons, new_csr_matrix);
 	}
 
-
-	Adjacency* AdjacencySet::ClearAfterPartitioning_NonTopological(Adjacency* adjacency, std::set<int>& Polyhedron_owned, std::set<int>& Polyhedron_ghost)
+	namespace
 	{
-		auto polyhedra = static_cast<PolyhedronCollection*>(adjacency->get_sourceElementCollection());
-		auto csr_matrix = adjacency->get_adjacencySparseMatrix();
-
-		auto& columIndex = csr_matrix->columnIndex;
-		auto& rowPtr = csr_matrix->rowPtr;
-		auto& val = csr_matrix->values;
-
-		auto new_csr_matrix = new CSRMatrix;
-		auto& new_nnz = new_csr_matrix->nnz = 0;
-		auto& new_columIndex = new_csr_matrix->columnIndex;
-		auto& new_rowPtr = new_csr_matrix->rowPtr;
-		auto& new_val = new_csr_matrix->values;
-
-		for (auto it = polyhedra->begin(); it != polyhedra->end(); ++it)
+		template <class SourceCollection, class TargetCollection>
+		Adjacency* RestrictTopologicalToPartition(Adjacency* adjacency)
 		{
-			auto polyhedron_global_index = (*it)->get_globalIndex();
-			auto polyhedron_local_index = (*it)->get_localIndex();
-			auto i0 = rowPtr[polyhedron_global_index];
-			auto i1 = rowPtr[polyhedron_global_index + 1];
-			std::vector<int> sub_columnIndex(columIndex.begin() + i0, columIndex.begin() + i1);
-			std::vector<int> sub_val(val.begin() + i0, val.begin() + i1);
-			std::vector<int> temp;
-			for (size_t i = 0; i != sub_columnIndex.size(); ++i)
-			{
-				auto polyhedron2_global_index = sub_columnIndex[i];
+			auto source = static_cast<SourceCollection*>(adjacency->get_sourceElementCollection());
+			auto target = static_cast<TargetCollection*>(adjacency->get_targetElementCollection());
+			auto new_adjacency = RestrictToPartition(adjacency, source, target, target->get_GlobalToLocalIndex());
 
-				if ((Polyhedron_owned.count(polyhedron2_global_index) == 1) || (Polyhedron_ghost.count(polyhedron2_global_index) == 1))	//face is in the partition
-				{
-					auto polyhedron2_local_index = polyhedra->get_GlobalToLocalIndex().at(polyhedron2_global_index);
-					temp.push_back(polyhedron2_local_index);
-					new_val.push_back(polyhedron_local_index);
-					++new_nnz;
-				}
+			//Values hold the local index of the source element
+			auto new_csr_matrix = new_adjacency->get_adjacencySparseMatrix();
+			for (CSRMatrix::index_type irow = 0; irow != new_csr_matrix->dimRow; ++irow)
+			{
+				std::fill(new_csr_matrix->values.begin() + new_csr_matrix->rowPtr[irow], new_csr_matrix->values.begin() + new_csr_matrix->rowPtr[irow + 1], irow);
 			}
-			std::sort(temp.begin(), temp.end());
-			new_columIndex.insert(new_columIndex.end(), temp.begin(), temp.end());
-			new_rowPtr.push_back(new_nnz);
+			return new_adjacency;
 		}
-		return new Adjacency(ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::FAMILY::POLYGON, ELEMENTS::FAMILY::POLYHEDRON, polyhedra, polyhedra, polyhedra, new_csr_matrix);
+	}
+
+	Adjacency* AdjacencySet::ClearAfterPartitioning_Topological(Adjacency* adjacency)
+	{
+		auto source = adjacency->get_sourceFamily();
+		auto target = adjacency->get_targetFamily();
+		if ((source == ELEMENTS::FAMILY::POLYHEDRON) && (target == ELEMENTS::FAMILY::POLYGON))
+		{
+			return RestrictTopologicalToPartition<PolyhedronCollection, PolygonCollection>(adjacency);
+		}
+		if ((source == ELEMENTS::FAMILY::POLYHEDRON) && (target == ELEMENTS::FAMILY::LINE))
+		{
+			return RestrictTopologicalToPartition<PolyhedronCollection, LineCollection>(adjacency);
+		}
+		if ((source == ELEMENTS::FAMILY::POLYGON) && (target == ELEMENTS::FAMILY::LINE))
+		{
+			return RestrictTopologicalToPartition<PolygonCollection, LineCollection>(adjacency);
+		}
+		LOGERROR("Adjacency " + familyName(source) + " to " + familyName(target) + " cannot be restricted to the partition");
+		return nullptr;
+	}
+
+
+	Adjacency* AdjacencySet::ClearAfterPartitioning_NonTopological(Adjacency* adjacency)
+	{
+		auto polyhedra = static_cast<PolyhedronCollection*>(adjacency->get_sourceElementCollection());
+		return RestrictToPartition(adjacency, polyhedra, polyhedra, polyhedra->get_GlobalToLocalIndex());
 	}
 
 	void AdjacencySet::Add_NonTopologicalAdjacencySum(std::string label, std::vector<Adjacency*> sumAdj)
@@ -204,32 +381,33 @@ namespace PAMELA
 	}
 
 
-	// Polyhedra to Points adjacency 
-	Adjacency* AdjacencySet::get_TopologicalAdjacency(PolyhedronCollection* source, PointCollection* target, PolyhedronCollection* base)
+	// Elements to Points adjacency
+	template <typename ElementCollectionType>
+	Adjacency* AdjacencySet::BuildVertexAdjacency(ElementCollectionType* source)
 	{
 
-		Adjacency* adj = new Adjacency(ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::FAMILY::POINT, ELEMENTS::FAMILY::POLYHEDRON, source, target, base);
+		PointCollection* target = m_mesh->get_PointCollection();
+		Adjacency* adj = new Adjacency(source->get_family(), ELEMENTS::FAMILY::POINT, source->get_family(), source, target, source);
 		auto collectionSize = source->size_all();
 		int nbVertex = 0;
 		int vertexIndex = 0;
-		int PolyhedronIndex = 0;
-		int nval = 0;
+		int ElementIndex = 0;
+		CSRMatrix::offset_type nval = 0;
 		int nrow = 0;
 
 		auto csr_mat = adj->get_adjacencySparseMatrix();
 
-		csr_mat->rowPtr[0];
 		for (size_t i = 0; i != collectionSize; i++)
 		{
-			Polyhedron* polyhedron = source->operator[](static_cast<int>(i));
-			PolyhedronIndex = polyhedron->get_localIndex();
-			const std::vector<Point*>& vertexList = polyhedron->get_vertexList();
+			auto element = source->operator[](static_cast<int>(i));
+			ElementIndex = element->get_localIndex();
+			const std::vector<Point*>& vertexList = element->get_vertexList();
 			nbVertex = static_cast<int>(vertexList.size());
 			for (auto j = 0; j < nbVertex; j++)
 			{
 				vertexIndex = vertexList[j]->get_localIndex();
 				csr_mat->columnIndex.push_back(vertexIndex);
-				csr_mat->values.push_back(PolyhedronIndex);
+				csr_mat->values.push_back(ElementIndex);
 				nval++;
 			}
 			nrow++;
@@ -239,58 +417,9 @@ namespace PAMELA
 		csr_mat->sortRowIndexAndMoveValues();
 		csr_mat->checkMatrix();
 
-		//Add to map
-		TopologicalAdjacencyMap[std::make_tuple(source->get_family(), target->get_family(), base->get_family())] = adj;
-
-		return adj;
-	}
-
-	// Points to Polyhedra adjacency 
-	Adjacency* AdjacencySet::get_TopologicalAdjacency(PointCollection* source, PolyhedronCollection* target, PolyhedronCollection* base)
-	{
-                utils::pamela_unused(source);
-                utils::pamela_unused(target);
-                utils::pamela_unused(base);
-		Adjacency* adj = Adjacency::transposed(get_TopologicalAdjacency(ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::FAMILY::POINT, ELEMENTS::FAMILY::POLYHEDRON));
-		return adj;
-	}
-
-
-	// Polyhedra to Face adjacency
-	Adjacency* AdjacencySet::get_TopologicalAdjacency(PolyhedronCollection* source, PolygonCollection* target, PolyhedronCollection* base)
-	{
-
-                utils::pamela_unused(source);
-                utils::pamela_unused(target);
-                utils::pamela_unused(base);
-		LOGERROR("This adjacency must be created while creating Polygons from Polyhedra");
-		return nullptr;
-	}
-
-	Adjacency* AdjacencySet::get_TopologicalAdjacency(PolygonCollection* source, PolyhedronCollection* target, PolyhedronCollection* base)
-	{
-
-                utils::pamela_unused(source);
-                utils::pamela_unused(target);
-                utils::pamela_unused(base);
-		Adjacency* adj = Adjacency::transposed(get_TopologicalAdjacency(ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::FAMILY::POLYGON, ELEMENTS::FAMILY::POLYHEDRON));
-		return adj;
-	}
-
-
-
-	Adjacency* AdjacencySet::get_TopologicalAdjacency(PolyhedronCollection* source, PolyhedronCollection* target, PolygonCollection* base)
-	{
-                utils::pamela_unused(source);
-                utils::pamela_unused(target);
-                utils::pamela_unused(base);
-		Adjacency* adj1 = get_TopologicalAdjacency(ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::FAMILY::POLYGON, ELEMENTS::FAMILY::POLYHEDRON);
-		Adjacency* adj2 = get_TopologicalAdjacency(ELEMENTS::FAMILY::POLYGON, ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::FAMILY::POLYHEDRON);
-		Adjacency* adj = Adjacency::multiply(adj1, adj2);
 		return adj;
 	}
 
-
 	Adjacency* AdjacencySet::adjacencyExist(ELEMENTS::FAMILY source, ELEMENTS::FAMILY target, ELEMENTS::FAMILY base)
 	{
 		familyTriplet tri = std::make_tuple(source, target, base);
@@ -16,6 +16,7 @@
 
 #include <cstddef>
 #include <tuple>
+#include <unordered_set>
 #include "Elements/Element.hpp"
 #include "Collection/Collection.hpp"
 
@@ -39,27 +40,43 @@ namespace PAMELA
 	class AdjacencySet
 	{
 		friend class Mesh;
+		friend class MeshCheckpoint;
 
 
 	public:
 
 
 		AdjacencySet(Mesh * mesh) : m_mesh(mesh) {}
-		~AdjacencySet()=default;
+		~AdjacencySet();
 
 		//General getter
+		// Any topological adjacency is derived on first request from the primitive ones (element vertex lists and
+		// adjacencies registered while creating elements) by transposition and product, then cached.
 		Adjacency* get_TopologicalAdjacency(ELEMENTS::FAMILY source, ELEMENTS::FAMILY target, ELEMENTS::FAMILY base);
-		void ClearAfterPartitioning(std::set<int>& PolyhedronOwned, std::set<int>& PolyheronGhost, std::set<int>& PolygonOwned, std::set<int>& PolygonGhost);
-		Adjacency* ClearAfterPartitioning_Topological(Adjacency* adj, std::set<int>& PolygonOwned,
-		                                        std::set<int>& PolygonGhost);
-		Adjacency* ClearAfterPartitioning_NonTopological(Adjacency* adjacency, std::set<int>& Polyhedron_owned,
-		                                                 std::set<int>& Polyhedron_ghost);
+		// To be called once the collections are shrunk. The registered topological adjacencies (Polyhedron to Polygon, and
+		// Polyhedron and Polygon to Line once edges are created) and the Polyhedron to Polyhedron non-topological ones are
+		// restricted to the partition in the local numbering, the derived ones are dropped.
+		void ClearAfterPartitioning();
+		Adjacency* ClearAfterPartitioning_Topological(Adjacency* adj);
+		Adjacency* ClearAfterPartitioning_NonTopological(Adjacency* adjacency);
+
+		// Register an adjacency built along with the elements (e.g. Polyhedron to Polygon when creating faces)
+		void Add_TopologicalAdjacency(Adjacency* adj);
+
+		// Drop the cached adjacencies involving a family, to be called when its collection is modified
+		void InvalidateTopologicalAdjacencies(ELEMENTS::FAMILY family);
+		void InvalidateTopologicalAdjacencies();
 
 		void Add_NonTopologicalAdjacency(std::string label, Adjacency* adj) { NonTopologicalAdjacencyMap[label] = adj; }
 		void Add_NonTopologicalAdjacencySum(std::string label, std::vector<Adjacency*> sumAdj);
 
 		Adjacency* get_NonTopologicalAdjacency(std::string label) { return NonTopologicalAdjacencyMap.at(label); }
 
+		//Memory
+		std::size_t get_MemoryFootprint(ELEMENTS::FAMILY source, ELEMENTS::FAMILY target, ELEMENTS::FAMILY base) const;
+		std::size_t get_MemoryFootprint() const;
+		void LogMemoryFootprint() const;
+
 	private:
 
 		Mesh* m_mesh;
@@ -71,12 +88,13 @@ namespace PAMELA
 		std::unordered_map<std::string, Adjacency*> NonTopologicalAdjacencyMap;
 		std::unordered_map<familyTriplet, Adjacency*, TripletHash> TopologicalAdjacencyMap;
 
-		//Adjacency internal getter or builder
-		Adjacency* get_TopologicalAdjacency(PolyhedronCollection* source, PointCollection* target, PolyhedronCollection* base);
-		Adjacency* get_TopologicalAdjacency(PointCollection* source, PolyhedronCollection* target, PolyhedronCollection* base);
-		Adjacency* get_TopologicalAdjacency(PolyhedronCollection* source, PolygonCollection* target, PolyhedronCollection* base);
-		Adjacency* get_TopologicalAdjacency(PolygonCollection* source, PolyhedronCollection* target, PolyhedronCollection* base);
-		Adjacency* get_TopologicalAdjacency(PolyhedronCollection* source, PolyhedronCollection* target, PolygonCollection* base);
+		//Adjacencies of TopologicalAdjacencyMap that can be rebuilt, as opposed to the registered ones
+		std::unordered_set<familyTriplet, TripletHash> m_derivedAdjacencies;
+
+		//Adjacency builders
+		Adjacency* DeriveTopologicalAdjacency(ELEMENTS::FAMILY source, ELEMENTS::FAMILY target, ELEMENTS::FAMILY base);
+		template <typename ElementCollectionType>
+		Adjacency* BuildVertexAdjacency(ElementCollectionType* source);
 
 
 	};
@@ -24,6 +24,10 @@
 namespace PAMELA
 {
 
+	/**
+	* \brief Compressed row storage of a graph. SizeType is used for the row offsets, IndexType for the adjacent vertices
+	* so that large graphs can get 64-bit offsets while keeping 32-bit indices.
+	*/
 	template <typename SizeType, typename IndexType, typename DataType>
 	class CSRGraph
 	{
@@ -48,22 +52,25 @@ namespace PAMELA
 
 		void resize(size_type nvert, size_type nedge);
 
-		size_type getNumNodes() const { return m_row_start.size() - 1; }
-		size_type getNumEdges() const { return m_adj_index.size(); }
+		size_type getNumNodes() const { return static_cast<size_type>(rowPtr.size() - 1); }
+		size_type getNumEdges() const { return static_cast<size_type>(columnIndex.size()); }
 
-		row_start_vec& getRowStart() { return m_row_start; }
-		adj_index_vec& getAdjIndex() { return m_adj_index; }
-		adj_data_vec&  getAdjData() { return m_adj_data; }
+		std::size_t getMemoryFootprint() const
+		{
+			return rowPtr.capacity() * sizeof(size_type) + columnIndex.capacity() * sizeof(index_type) + values.capacity() * sizeof(data_type);
+		}
 
-		const row_start_vec& getRowStart() const { return m_row_start; }
-		const adj_index_vec& getAdjIndex() const { return m_adj_index; }
-		const adj_data_vec&  getAdjData()  const { return m_adj_data; }
+		row_start_vec& getRowStart() { return rowPtr; }
+		adj_index_vec& getAdjIndex() { return columnIndex; }
+		adj_data_vec&  getAdjData() { return values; }
 
-	private:
+		const row_start_vec& getRowStart() const { return rowPtr; }
+		const adj_index_vec& getAdjIndex() const { return columnIndex; }
+		const adj_data_vec&  getAdjData()  const { return values; }
 
-		row_start_vec m_row_start;
-		adj_index_vec m_adj_index;
-		adj_data_vec  m_adj_data;
+		row_start_vec rowPtr;
+		adj_index_vec columnIndex;
+		adj_data_vec  values;
 
 	};
 
@@ -82,13 +89,13 @@ namespace PAMELA
 	template<typename SizeType2, typename IndexType2, typename DataType2>
 	CSRGraph<SizeType, IndexType, DataType>::CSRGraph(const CSRGraph<SizeType2, IndexType2, DataType2>& other)
 	{
-		m_row_start.resize(other.getNumNodes() + 1);
-		m_adj_index.resize(other.getNumEdges());
-		m_adj_data.resize(other.getNumEdges());
+		rowPtr.resize(other.getRowStart().size());
+		columnIndex.resize(other.getNumEdges());
+		values.resize(other.getAdjData().size());
 
-		utils::copy(other.getRowStart().begin(), other.getRowStart().end(), m_row_start.begin());
-		utils::copy(other.getAdjIndex().begin(), other.getAdjIndex().end(), m_adj_index.begin());
-		utils::copy(other.getAdjData().begin(), other.getAdjData().end(), m_adj_data.begin());
+		utils::copy(other.getRowStart().begin(), other.getRowStart().end(), rowPtr.begin());
+		utils::copy(other.getAdjIndex().begin(), other.getAdjIndex().end(), columnIndex.begin());
+		utils::copy(other.getAdjData().begin(), other.getAdjData().end(), values.begin());
 	}
 
 	template <typename SizeType, typename IndexType, typename DataType>
@@ -99,9 +106,9 @@ namespace PAMELA
 	template <typename SizeType, typename IndexType, typename DataType>
 	void CSRGraph<SizeType, IndexType, DataType>::resize(size_type nvert, size_type nedge)
 	{
-		m_row_start.resize(nvert + 1);
-		m_adj_index.resize(nedge);
-		m_adj_data.resize(nedge);
+		rowPtr.resize(nvert + 1);
+		columnIndex.resize(nedge);
+		values.resize(nedge);
 	}
 
 }
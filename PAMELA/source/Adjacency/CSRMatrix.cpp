@@ -16,12 +16,24 @@
 #include "Utils/Logger.hpp"
 #include "Utils/Assert.hpp"
 #include "Utils/Utils.hpp"
+#include "Utils/ThreadUtils.hpp"
 #include <algorithm>
 
 namespace PAMELA
 {
 
-	bool CSRMatrix::checkMatrix()
+	namespace
+	{
+		// Below this number of non-zeros, spawning threads costs more than it saves
+		const long long TRANSPOSE_PARALLEL_THRESHOLD = 1 << 20;
+		const long long SORT_PARALLEL_THRESHOLD = 1 << 20;
+
+		// Rows up to this length are sorted by insertion
+		const long long SORT_INSERTION_MAX_LENGTH = 32;
+	}
+
+	template <typename OffsetType, typename IndexType>
+	bool CSRMatrixT<OffsetType, IndexType>::checkMatrix()
 	{
 
 		if (!(dimRow > 0 && dimColumn > 0))
@@ -29,8 +41,8 @@ namespace PAMELA
 			LOGWARNING("The CSR matrix has a zero dimension");
 		}
 
-		int row_start = 0;
-		for (int row = 0; row < dimRow - 1; ++row)
+		offset_type row_start = 0;
+		for (index_type row = 0; row < dimRow - 1; ++row)
 		{
 			if (rowPtr[row] > rowPtr[row + 1])
 			{
@@ -44,8 +56,8 @@ namespace PAMELA
 				//return false;
 			}
 
-			int row_stop = rowPtr[row + 1];
-			for (int nnz_index = row_start; nnz_index < row_stop - 1; ++nnz_index)
+			offset_type row_stop = rowPtr[row + 1];
+			for (offset_type nnz_index = row_start; nnz_index < row_stop - 1; ++nnz_index)
 			{
 				if (columnIndex[nnz_index] > columnIndex[nnz_index + 1])
 				{
@@ -64,63 +76,107 @@ namespace PAMELA
 		return true;
 	}
 
-	void CSRMatrix::sortRowIndexAndMoveValues()
+	template <typename OffsetType, typename IndexType>
+	void CSRMatrixT<OffsetType, IndexType>::sortRowIndexAndMoveValues()
 	{
 
-		for (auto i = 0; i < dimRow; ++i)
+		int nThreads = 1;
+		if (rowPtr[dimRow] >= SORT_PARALLEL_THRESHOLD)
 		{
-			sortRowIndexAndMoveValues(i);
+			nThreads = threadUtils::NumberOfThreads();
 		}
 
+		threadUtils::ParallelChunks(dimRow, nThreads, [&](int, index_type row_begin, index_type row_end)
+		{
+			std::vector<index_type> scratch;
+			for (auto i = row_begin; i < row_end; ++i)
+			{
+				sortRowIndexAndMoveValues(i, scratch);
+			}
+		});
+
 	}
 
-	void CSRMatrix::sortRowIndexAndMoveValues(int i)
+	template <typename OffsetType, typename IndexType>
+	void CSRMatrixT<OffsetType, IndexType>::sortRowIndexAndMoveValues(index_type i)
 	{
+		std::vector<index_type> scratch;
+		sortRowIndexAndMoveValues(i, scratch);
+	}
 
-		int i0 = rowPtr[i];
-		int i1 = rowPtr[i + 1];
-		std::vector<int> column(columnIndex.begin() + i0, columnIndex.begin() + i1);
-		std::vector<int> val(values.begin() + i0, values.begin() + i1);
+	template <typename OffsetType, typename IndexType>
+	void CSRMatrixT<OffsetType, IndexType>::sortRowIndexAndMoveValues(index_type i, std::vector<index_type>& scratch)
+	{
 
-		//Zip values
-		std::vector<std::pair<int, int>> zipped;
-		for (size_t j = 0; j < column.size(); ++j)
+		offset_type i0 = rowPtr[i];
+		offset_type i1 = rowPtr[i + 1];
+		index_type n = static_cast<index_type>(i1 - i0);
+		index_type* column = columnIndex.data() + i0;
+		value_type* val = values.data() + i0;
+
+		if (std::is_sorted(column, column + n))
 		{
-			zipped.push_back(std::make_pair(column[j], val[j]));
+			return;
 		}
 
-		//Sort
-		std::sort(std::begin(zipped), std::end(zipped),
-			[&](const std::pair<int, int>& a, const std::pair<int, int>& b)
+		//Short rows (cell to vertex, face to vertex...): insertion sort moving both arrays in place
+		if (n <= SORT_INSERTION_MAX_LENGTH)
 		{
-			return a.first < b.first;
-		});
+			for (index_type j = 1; j < n; ++j)
+			{
+				index_type c = column[j];
+				value_type v = val[j];
+				index_type k = j - 1;
+				for (; k >= 0 && column[k] > c; --k)
+				{
+					column[k + 1] = column[k];
+					val[k + 1] = val[k];
+				}
+				column[k + 1] = c;
+				val[k + 1] = v;
+			}
+			return;
+		}
 
-		for (size_t j = 0; j < column.size(); j++)
+		//Long rows: sort a permutation then gather both arrays through the scratch buffer
+		if (static_cast<index_type>(scratch.size()) < 2 * n)
 		{
-			column[j] = zipped[j].first;
-			val[j] = zipped[j].second;
+			scratch.resize(2 * n);
 		}
+		index_type* perm = scratch.data();
+		index_type* gathered = scratch.data() + n;
+		for (index_type j = 0; j < n; ++j)
+		{
+			perm[j] = j;
+		}
+		//Column indices are unique within a row, std::sort is enough and unlike std::stable_sort does not allocate
+		std::sort(perm, perm + n, [column](index_type a, index_type b) { return column[a] < column[b]; });
 
-		//Copy back
-		for (size_t j = 0; j < column.size(); j++)
+		for (index_type j = 0; j < n; ++j)
 		{
-			columnIndex[j + i0] = column[j];
-			values[j + i0] = val[j];
+			gathered[j] = column[perm[j]];
 		}
+		std::copy(gathered, gathered + n, column);
+		for (index_type j = 0; j < n; ++j)
+		{
+			gathered[j] = val[perm[j]];
+		}
+		std::copy(gathered, gathered + n, val);
 
 	}
 
-	void CSRMatrix::shrink()
+	template <typename OffsetType, typename IndexType>
+	void CSRMatrixT<OffsetType, IndexType>::shrink()
 	{
-		int size = rowPtr[dimRow];
+		offset_type size = rowPtr[dimRow];
 		values.resize(size);
 		values.shrink_to_fit();
 		columnIndex.resize(size);
 		columnIndex.shrink_to_fit();
 	}
 
-	void CSRMatrix::fillEmpty(int dim_row, int dim_col)
+	template <typename OffsetType, typename IndexType>
+	void CSRMatrixT<OffsetType, IndexType>::fillEmpty(index_type dim_row, index_type dim_col)
 	{
                 utils::pamela_unused(dim_col);
 		values.resize(0);
@@ -128,22 +184,22 @@ namespace PAMELA
 		columnIndex.resize(0);
 	}
 
-	CSRMatrix* CSRMatrix::product(CSRMatrix* matrix_lhs, CSRMatrix* matrix_rhs)
+	template <typename OffsetType, typename IndexType>
+	CSRMatrixT<OffsetType, IndexType>* CSRMatrixT<OffsetType, IndexType>::product(CSRMatrixT* matrix_lhs, CSRMatrixT* matrix_rhs)
 	{
 		ASSERT(matrix_lhs->checkMatrix(), "Problem with CSR matrix data structure");
 		ASSERT(matrix_rhs->checkMatrix(), "Problem with CSR matrix data structure");
 		ASSERT(matrix_lhs->dimColumn == matrix_rhs->dimRow, "Matrix dimensions are not compatible for product operation");
 
 		//Dimensions
-		int nnz_lhs = matrix_lhs->nnz;
-		int Nr_lhs = matrix_lhs->dimRow;
-		int nnz_rhs = matrix_rhs->nnz;
+		offset_type nnz_lhs = matrix_lhs->nnz;
+		index_type Nr_lhs = matrix_lhs->dimRow;
+		index_type Nc_rhs = matrix_rhs->dimColumn;
+		offset_type nnz_rhs = matrix_rhs->nnz;
 
 		//Dynamic allocation of trans_mat
-		int nnz_guess = (nnz_lhs + nnz_rhs) * 10;
-		CSRMatrix* mult_mat = new CSRMatrix(Nr_lhs, Nr_lhs, nnz_guess);
-
-		int Mnnz = mult_mat->nnz;
+		offset_type nnz_guess = (nnz_lhs + nnz_rhs) * 10;
+		CSRMatrixT* mult_mat = new CSRMatrixT(Nr_lhs, Nc_rhs, nnz_guess);
 
 		//Work data
 		auto& rowPtr_lhs = matrix_lhs->rowPtr;
@@ -154,25 +210,25 @@ namespace PAMELA
 		auto& McolumnIndex = mult_mat->columnIndex;
 		auto& Mvalues = mult_mat->values;
 
-		std::vector<int> iw(Mnnz, -1);
-		int len = -1;
+		std::vector<offset_type> iw(Nc_rhs, -1);
+		offset_type len = -1;
 
 		MrowPtr[0] = 0;
-		for (int ii = 0; ii < Nr_lhs; ++ii)
+		for (index_type ii = 0; ii < Nr_lhs; ++ii)
 		{
-			for (int ka = rowPtr_lhs[ii]; ka < rowPtr_lhs[ii + 1]; ++ka)
+			for (offset_type ka = rowPtr_lhs[ii]; ka < rowPtr_lhs[ii + 1]; ++ka)
 			{
-				int jj = columnIndex_lhs[ka];
-				for (int kb = rowPtr_rhs[jj]; kb < rowPtr_rhs[jj + 1]; ++kb)
+				index_type jj = columnIndex_lhs[ka];
+				for (offset_type kb = rowPtr_rhs[jj]; kb < rowPtr_rhs[jj + 1]; ++kb)
 				{
-					int jcol = columnIndex_rhs[kb];
-					int jpos = iw[jcol];
+					index_type jcol = columnIndex_rhs[kb];
+					offset_type jpos = iw[jcol];
 					if (jpos == -1)
 					{
 						len++;
 						McolumnIndex[len] = jcol;
 						iw[jcol] = len;
-						int temp;
+						value_type temp;
 						if (ii == jcol)
 						{
 							temp = -1;
@@ -186,7 +242,7 @@ namespace PAMELA
 					}
 					else
 					{
-						int temp;
+						value_type temp;
 						if (ii == jcol)
 						{
 							temp = -1;
@@ -201,7 +257,7 @@ namespace PAMELA
 				}
 			}
 
-			for (int k = MrowPtr[ii]; k < len + 1; ++k)
+			for (offset_type k = MrowPtr[ii]; k < len + 1; ++k)
 			{
 				iw[McolumnIndex[k]] = -1;
 			}
@@ -212,7 +268,7 @@ namespace PAMELA
 		MrowPtr[Nr_lhs] = len + 1;
 
 		//
-		mult_mat->nnz = len;
+		mult_mat->nnz = len + 1;
 		mult_mat->shrink();
 		mult_mat->sortRowIndexAndMoveValues();
 		ASSERT(mult_mat->checkMatrix(), "Something wrong with the resulting transposed matrix");
@@ -221,7 +277,8 @@ namespace PAMELA
 
 	}
 
-	CSRMatrix* CSRMatrix::sum(CSRMatrix* matrix_lhs, CSRMatrix* matrix_rhs)
+	template <typename OffsetType, typename IndexType>
+	CSRMatrixT<OffsetType, IndexType>* CSRMatrixT<OffsetType, IndexType>::sum(CSRMatrixT* matrix_lhs, CSRMatrixT* matrix_rhs)
 	{
 
 		ASSERT(matrix_lhs->checkMatrix(), "Problem with CSR matrix data structure");
@@ -229,15 +286,15 @@ namespace PAMELA
 		ASSERT(matrix_lhs->dimColumn == matrix_rhs->dimRow, "Matrix dimensions are not compatible for sum operation");
 
 		//Dimensions
-		int nnz_lhs = matrix_lhs->nnz;
-		int Nr_lhs = matrix_lhs->dimRow;
-		int nnz_rhs = matrix_rhs->nnz;
+		offset_type nnz_lhs = matrix_lhs->nnz;
+		index_type Nr_lhs = matrix_lhs->dimRow;
+		offset_type nnz_rhs = matrix_rhs->nnz;
 
 		//Dynamic allocation of trans_mat
-		int nnz_guess = (nnz_lhs + nnz_rhs) * 10;
-		CSRMatrix* sum_mat = new CSRMatrix(Nr_lhs, Nr_lhs, nnz_guess);
+		offset_type nnz_guess = (nnz_lhs + nnz_rhs) * 10;
+		CSRMatrixT* sum_mat = new CSRMatrixT(Nr_lhs, Nr_lhs, nnz_guess);
 
-		int MNc = sum_mat->dimColumn;
+		index_type MNc = sum_mat->dimColumn;
 
 		//Work data
 		auto& rowPtr_lhs = matrix_lhs->rowPtr;
@@ -249,12 +306,12 @@ namespace PAMELA
 		auto& Mvalues = sum_mat->values;
 
 
-		int ka, kb;
-		int j1, j2;
-		int kc = 0;
-		int nelea_left, neleb_left;
+		offset_type ka, kb;
+		index_type j1, j2;
+		offset_type kc = 0;
+		offset_type nelea_left, neleb_left;
 		MrowPtr[1] = kc;
-		for (int ii = 0; ii < Nr_lhs; ++ii)
+		for (index_type ii = 0; ii < Nr_lhs; ++ii)
 		{
 			ka = rowPtr_lhs[ii];
 			kb = rowPtr_rhs[ii];
@@ -326,17 +383,18 @@ namespace PAMELA
 
 	}
 
-	CSRMatrix* CSRMatrix::transpose(CSRMatrix* matrix)
+	template <typename OffsetType, typename IndexType>
+	CSRMatrixT<OffsetType, IndexType>* CSRMatrixT<OffsetType, IndexType>::transpose(CSRMatrixT* matrix)
 	{
 		ASSERT(matrix->checkMatrix(), "Problem with CSR matrix data structure");
 
 		//Dimensions
-		int nnz = matrix->nnz;
-		int Nc = matrix->dimColumn;
-		int Nr = matrix->dimRow;
+		offset_type nnz = matrix->rowPtr[matrix->dimRow];
+		index_type Nc = matrix->dimColumn;
+		index_type Nr = matrix->dimRow;
 
 		//Dynamic allocation of trans_mat
-		CSRMatrix* trans_mat = new CSRMatrix(Nc, Nr, nnz);
+		CSRMatrixT* trans_mat = new CSRMatrixT(Nc, Nr, nnz);
 
 		//Work data
 		auto& rowPtr = matrix->rowPtr;
@@ -346,56 +404,90 @@ namespace PAMELA
 		auto& TcolumnIndex = trans_mat->columnIndex;
 		auto& Tvalues = trans_mat->values;
 
+		// Counting sort on the column index. Rows are split in contiguous chunks of similar nnz, each chunk owning
+		// a private histogram, so that scattering chunk after chunk keeps the rows of the transpose sorted.
+		// The number of chunks is bounded so that the histograms never weigh more than the matrix itself.
+		int nChunks = 1;
+		if (nnz >= TRANSPOSE_PARALLEL_THRESHOLD && Nc > 0)
+		{
+			nChunks = static_cast<int>(std::max<offset_type>(1, std::min<offset_type>(threadUtils::NumberOfThreads(), nnz / Nc)));
+		}
+
+		std::vector<index_type> chunkRowStart(nChunks + 1, Nr);
+		chunkRowStart[0] = 0;
+		for (int chunk = 1; chunk < nChunks; ++chunk)
+		{
+			offset_type nnz_target = static_cast<offset_type>(static_cast<long long>(nnz) * chunk / nChunks);
+			chunkRowStart[chunk] = static_cast<index_type>(std::lower_bound(rowPtr.begin(), rowPtr.begin() + Nr, nnz_target) - rowPtr.begin());
+		}
+
+		std::vector<std::vector<offset_type>> histogram(nChunks);
 
 		//
-		// Stage 1: Compute pattern for B
+		// Stage 1: Histogram of the column indices per chunk
 		//
-		int row_start = 0;
-		for (int row = 0; row < Nr; ++row)
+		threadUtils::ParallelChunks(nChunks, nChunks, [&](int, int chunk_begin, int chunk_end)
 		{
-			int row_stop = rowPtr[row + 1];
+			for (int chunk = chunk_begin; chunk < chunk_end; ++chunk)
+			{
+				auto& count = histogram[chunk];
+				count.assign(Nc, 0);
+				for (offset_type nnz_index = rowPtr[chunkRowStart[chunk]]; nnz_index < rowPtr[chunkRowStart[chunk + 1]]; ++nnz_index)
+				{
+					count[columnIndex[nnz_index]]++;
+				}
+			}
+		});
 
-			for (int nnz_index = row_start; nnz_index < row_stop; ++nnz_index)
+		//
+		// Stage 2: Per column, turn counts into offsets within the column and store the column size
+		//
+		int nThreads = nChunks == 1 ? 1 : threadUtils::NumberOfThreads();
+		threadUtils::ParallelChunks(Nc, nThreads, [&](int, index_type col_begin, index_type col_end)
+		{
+			for (index_type col = col_begin; col < col_end; ++col)
 			{
-				int ival = TrowPtr[columnIndex[nnz_index]];
-				TrowPtr[columnIndex[nnz_index]] = ival + 1;
+				offset_type offset = 0;
+				for (int chunk = 0; chunk < nChunks; ++chunk)
+				{
+					offset_type tmp = histogram[chunk][col];
+					histogram[chunk][col] = offset;
+					offset += tmp;
+				}
+				TrowPtr[col] = offset;
 			}
-			row_start = row_stop;
-		}
-		TrowPtr[Nc] = 1;
+		});
 
 		// Bring row-start array in place using exclusive-scan:
-		int offset = 0;
-
-		for (int row = 0; row < Nc; ++row)
+		offset_type offset = 0;
+		for (index_type row = 0; row < Nc; ++row)
 		{
-			int tmp = TrowPtr[row];
+			offset_type tmp = TrowPtr[row];
 			TrowPtr[row] = offset;
 			offset += tmp;
 		}
 		TrowPtr[Nc] = offset;
 
 		//
-		// Stage 2: Fill with data
+		// Stage 3: Fill with data, every chunk writing in its own slots
 		//
-		std::vector<int> B_offsets = TrowPtr; // index of first unwritten element per row
-
-		row_start = 0;
-		for (int row = 0; row < Nr; ++row)
+		threadUtils::ParallelChunks(nChunks, nChunks, [&](int, int chunk_begin, int chunk_end)
 		{
-			int row_stop = rowPtr[row + 1];
-
-			for (int nnz_index = row_start; nnz_index < row_stop; ++nnz_index)
+			for (int chunk = chunk_begin; chunk < chunk_end; ++chunk)
 			{
-				int col_in_A = columnIndex[nnz_index];
-				int B_nnz_index = B_offsets[col_in_A];
-				TcolumnIndex[B_nnz_index] = row;
-				Tvalues[B_nnz_index] = values[nnz_index];
-				B_offsets[col_in_A] += 1;
+				auto& position = histogram[chunk];
+				for (index_type row = chunkRowStart[chunk]; row < chunkRowStart[chunk + 1]; ++row)
+				{
+					for (offset_type nnz_index = rowPtr[row]; nnz_index < rowPtr[row + 1]; ++nnz_index)
+					{
+						index_type col_in_A = columnIndex[nnz_index];
+						offset_type B_nnz_index = TrowPtr[col_in_A] + position[col_in_A]++;
+						TcolumnIndex[B_nnz_index] = row;
+						Tvalues[B_nnz_index] = values[nnz_index];
+					}
+				}
 			}
-
-			row_start = row_stop;
-		}
+		});
 
 		ASSERT(trans_mat->checkMatrix(), "Something wrong with the resulting transposed matrix");
 
@@ -403,4 +495,9 @@ namespace PAMELA
 
 	}
 
+	template struct CSRMatrixT<std::int32_t, std::int32_t>;
+	template struct CSRMatrixT<std::int64_t, std::int32_t>;
+	template struct CSRMatrixT<std::int32_t, std::int64_t>;
+	template struct CSRMatrixT<std::int64_t, std::int64_t>;
+
 }
@@ -13,42 +13,70 @@
  */
 
 #pragma once
+#include "Adjacency/CSRGraph.hpp"
+#include "Utils/Types.hpp"
 #include <vector>
 
 namespace PAMELA
 {
 
-	struct CSRMatrix
+	/**
+	* \brief Sparse matrix built on CSRGraph. OffsetType is used for rowPtr and nnz, IndexType for the dimensions,
+	* the column indices and the values.
+	*/
+	template <typename OffsetType, typename IndexType>
+	struct CSRMatrixT : public CSRGraph<OffsetType, IndexType, IndexType>
 	{
 
-		CSRMatrix(int dim_row, int dim_col, int nn_z) : nnz(nn_z), dimRow(dim_row), dimColumn(dim_col), dimRow_owned(dim_row),
+		using Graph = CSRGraph<OffsetType, IndexType, IndexType>;
+		using offset_type = OffsetType;
+		using index_type = IndexType;
+		using value_type = IndexType;
+
+		using Graph::rowPtr;
+		using Graph::columnIndex;
+		using Graph::values;
+
+		CSRMatrixT(index_type dim_row, index_type dim_col, offset_type nn_z) : Graph(dim_row, nn_z), nnz(nn_z), dimRow(dim_row), dimColumn(dim_col), dimRow_owned(dim_row),
 		                                               dimColumn_owned(dim_col), dimRow_ghost(0), dimColumn_ghost(0)
 		{
-			values.resize(nnz);
-			rowPtr.resize(dim_row + 1);
-			columnIndex.resize(nnz);
 		}
-		CSRMatrix(int dim_row, int dim_col) :CSRMatrix(dim_row, dim_col, 0) {}
-		CSRMatrix() :CSRMatrix(0, 0, 0) {}
+		CSRMatrixT(index_type dim_row, index_type dim_col) :CSRMatrixT(dim_row, dim_col, 0) {}
+		CSRMatrixT() :CSRMatrixT(0, 0, 0) {}
 
-		static CSRMatrix* transpose(CSRMatrix* matrix);
-		static CSRMatrix* product(CSRMatrix* matrix_lhs, CSRMatrix* matrix_rhs);
-		static CSRMatrix* sum(CSRMatrix* matrix_lhs, CSRMatrix* matrix_rhs);
+		template <typename OffsetType2, typename IndexType2>
+		explicit CSRMatrixT(const CSRMatrixT<OffsetType2, IndexType2>& other) : Graph(other), nnz(static_cast<offset_type>(other.nnz)),
+			dimRow(static_cast<index_type>(other.dimRow)), dimColumn(static_cast<index_type>(other.dimColumn)),
+			dimRow_owned(static_cast<index_type>(other.dimRow_owned)), dimColumn_owned(static_cast<index_type>(other.dimColumn_owned)),
+			dimRow_ghost(static_cast<index_type>(other.dimRow_ghost)), dimColumn_ghost(static_cast<index_type>(other.dimColumn_ghost))
+		{
+		}
+
+		static CSRMatrixT* transpose(CSRMatrixT* matrix);
+		static CSRMatrixT* product(CSRMatrixT* matrix_lhs, CSRMatrixT* matrix_rhs);
+		static CSRMatrixT* sum(CSRMatrixT* matrix_lhs, CSRMatrixT* matrix_rhs);
 		bool checkMatrix();
 
 		void sortRowIndexAndMoveValues();
-		void sortRowIndexAndMoveValues(int i);
+		void sortRowIndexAndMoveValues(index_type i);
+		void sortRowIndexAndMoveValues(index_type i, std::vector<index_type>& scratch);
 		void shrink();
-		void fillEmpty(int dim_row, int dim_col);
+		void fillEmpty(index_type dim_row, index_type dim_col);
 
 
-		int nnz;
-		int dimRow, dimColumn;
-		int dimRow_owned, dimColumn_owned;
-		int dimRow_ghost, dimColumn_ghost;
-		std::vector<int> rowPtr, columnIndex;
-		std::vector<int> values;
+		offset_type nnz;
+		index_type dimRow, dimColumn;
+		index_type dimRow_owned, dimColumn_owned;
+		index_type dimRow_ghost, dimColumn_ghost;
 
 	};
 
+	// Instantiated in CSRMatrix.cpp for 32/64-bit offsets and indices
+	extern template struct CSRMatrixT<std::int32_t, std::int32_t>;
+	extern template struct CSRMatrixT<std::int64_t, std::int32_t>;
+	extern template struct CSRMatrixT<std::int32_t, std::int64_t>;
+	extern template struct CSRMatrixT<std::int64_t, std::int64_t>;
+
+	using CSRMatrix = CSRMatrixT<Types::csr_offset_t, Types::csr_index_t>;
+
 }
@@ -187,8 +187,14 @@ namespace PAMELA
 				addAndCreateGroup(label);
 			}
 			auto grp = m_labelToGroup[label];
-			grp->push_back_unique(cur_element);
 			auto returnedElement = this->push_back_unique(cur_element);//TODO:index twice
+			//The group shares the element kept by the collection, but not its numbering
+			auto element = returnedElement.first;
+			auto localIndex = element->get_localIndex();
+			auto globalIndex = element->get_globalIndex();
+			grp->push_back_unique(element);
+			element->set_localIndex(localIndex);
+			element->set_globalIndex(globalIndex);
 			return returnedElement;
 		}
 
@@ -226,7 +232,20 @@ namespace PAMELA
 		ElementEnsemble<T, ElementHash<T>, ElementEqual<T>>* get_Group(std::string label) { ASSERT(groupExist(label), "The group does not exist"); return m_labelToGroup.at(label); }
 
 		//Parallel
-		void ClearAfterPartitioning(std::set<int> owned, std::set<int> ghost);
+		void ClearAfterPartitioning(const std::set<int>& owned, const std::set<int>& ghost);
+
+		//Memory, groups included
+		std::size_t get_MemoryFootprint() const override;
+
+		template <class Relocation>
+		void Relocate(const Relocation& relocation)
+		{
+			for (auto it = m_labelToGroup.begin(); it != m_labelToGroup.end(); ++it)
+			{
+				it->second->Relocate(relocation);
+			}
+			ElementEnsemble<T, ElementHash<T>, ElementEqual<T>>::Relocate(relocation);
+		}
 
 	protected:
 
@@ -241,7 +260,7 @@ namespace PAMELA
 	};
 
 	template <class T>
-	void ElementCollection<T>::ClearAfterPartitioning(std::set<int> owned, std::set<int> ghost)
+	void ElementCollection<T>::ClearAfterPartitioning(const std::set<int>& owned, const std::set<int>& ghost)
 	{
 
 		//Groups
@@ -255,6 +274,17 @@ namespace PAMELA
 
 	}
 
+	template <class T>
+	std::size_t ElementCollection<T>::get_MemoryFootprint() const
+	{
+		auto size = ElementEnsemble<T, ElementHash<T>, ElementEqual<T>>::get_MemoryFootprint();
+		for (auto it = m_labelToGroup.begin(); it != m_labelToGroup.end(); ++it)
+		{
+			size += it->second->get_MemoryFootprint();
+		}
+		return size;
+	}
+
 	typedef ElementCollection<Point*> PointCollection;
 
 	typedef ElementCollection<Line*> LineCollection;
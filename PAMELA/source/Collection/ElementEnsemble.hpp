@@ -17,6 +17,7 @@
 #include <unordered_map>
 #include "Elements/Element.hpp"
 #include "Parallel/ParallelEnsemble.hpp"
+#include "Utils/IndexMap.hpp"
 
 namespace PAMELA
 {
@@ -34,6 +35,23 @@ namespace PAMELA
 	};
 
 
+	//Update the vertex list of an element whose vertices have been moved in memory
+	template <class E, class Relocation>
+	void RelocateVertices(E* element, const Relocation& relocation)
+	{
+		for (auto& vertex : element->get_vertexList())
+		{
+			vertex = relocation(vertex);
+		}
+	}
+
+	//A point is its own vertex
+	template <class Relocation>
+	void RelocateVertices(Element<ELEMENTS::FAMILY::POINT>*, const Relocation&)
+	{
+	}
+
+
 	template <class T, class HashStruct = std::hash<T>, class EqualStruct = DefaultEqual<T>>
 	class ElementEnsemble : public ParallelEnsemble<T>
 	{
@@ -123,7 +141,7 @@ namespace PAMELA
 
 
 		//Getter
-		std::unordered_map<int, int> & get_GlobalToLocalIndex() { return m_GlobalToLocalIndex; }
+		const IndexMap& get_GlobalToLocalIndex() const { return m_GlobalToLocalIndex; }
 
 
 		//Make Empty
@@ -137,11 +155,11 @@ namespace PAMELA
 		}
 
 		//Shrink
-		void Shrink(std::set<int> owned, std::set<int> ghost, int dimension = 1) override
+		void Shrink(const std::set<int>& owned, const std::set<int>& ghost, int dimension = 1) override
 		{
 			//Copy ghost elements amd owned elements in temporary vector
 			std::vector<T> ghost_vec_temp; ghost_vec_temp.reserve(ghost.size() * dimension);
-			std::vector<T> owned_vec_temp; ghost_vec_temp.reserve(owned.size() * dimension);
+			std::vector<T> owned_vec_temp; owned_vec_temp.reserve(owned.size() * dimension);
 			for (auto it = this->m_data.begin(); it != this->m_data.end(); ++it)
 			{
 				if (ghost.count((*it)->get_globalIndex()) == 1)
@@ -155,42 +173,93 @@ namespace PAMELA
 				}
 				else
 				{
-					//delete *it;  //TODO, need to delete dynamics objects but delete multiple time now. Smart pointer?
-					//*it = nullptr;
+					//Elements are owned by the element arena of the mesh
 				}
 			}
 
-			//Rebuilt data
-			this->m_data.clear();
-			this->m_data.reserve(ghost_vec_temp.size() + owned_vec_temp.size());
-			this->m_data.insert(this->m_data.end(), owned_vec_temp.begin(), owned_vec_temp.end());
-			this->m_data.insert(this->m_data.end(), ghost_vec_temp.begin(), ghost_vec_temp.end());
+			//Rebuilt data, releasing the storage of the global ensemble
+			std::vector<T> data;
+			data.reserve(ghost_vec_temp.size() + owned_vec_temp.size());
+			data.insert(data.end(), owned_vec_temp.begin(), owned_vec_temp.end());
+			data.insert(data.end(), ghost_vec_temp.begin(), ghost_vec_temp.end());
+			this->m_data.swap(data);
 			this->resize_owned(static_cast<int>(owned_vec_temp.size()));
 			this->resize_ghost(static_cast<int>(ghost_vec_temp.size()));
 
 			//Update Numbering and map
-			int i = 0;
-			m_pointerToLocalIndex.clear();
-			m_GlobalToLocalIndex.clear();
-			for (auto it = this->m_data.begin(); it != this->m_data.end(); ++it)
-			{
-				(*it)->set_localIndex(i);
-				m_pointerToLocalIndex.insert(std::make_pair((*it), static_cast<int>(it - this->m_data.begin())));
-				m_GlobalToLocalIndex.insert(std::make_pair((*it)->get_globalIndex(), static_cast<int>(it - this->m_data.begin())));
-				i++;
-			}
+			Renumber(true);
 
 			//Test for emptyness
 			if (this->m_data.size() == 0) MakeEmpty();
 
 		}
 
+		//Replace the content by elements kept in this order, owned first then ghosts (e.g. read back from a saved mesh)
+		void Assign(std::vector<T> data, std::size_t nOwned, bool buildGlobalToLocalIndex)
+		{
+			this->m_data.swap(data);
+			this->m_sizeGhost = 0;
+			this->resize_owned(nOwned);
+			this->resize_ghost(this->m_data.size() - nOwned);
+			for (auto it = this->begin_ghost(); it != this->end_ghost(); ++it)
+			{
+				(*it)->set_IsGhost();
+			}
+			Renumber(buildGlobalToLocalIndex);
+		}
+
+		//Replace the elements moved in memory by ElementArena::Compact, relocation giving the new address of an element
+		template <class Relocation>
+		void Relocate(const Relocation& relocation)
+		{
+			decltype(m_pointerToLocalIndex) pointerToLocalIndex(this->m_data.size());
+			for (auto it = this->m_data.begin(); it != this->m_data.end(); ++it)
+			{
+				*it = relocation(*it);
+				RelocateVertices(*it, relocation);
+				pointerToLocalIndex.insert(std::make_pair((*it), static_cast<int>(it - this->m_data.begin())));
+			}
+			m_pointerToLocalIndex.swap(pointerToLocalIndex);
+		}
+
+		//Memory
+		std::size_t get_MemoryFootprint() const override
+		{
+			//Nodes of the pointer map hold the pair and the link to the next node
+			auto mapSize = m_pointerToLocalIndex.bucket_count() * sizeof(void*) + m_pointerToLocalIndex.size() * (sizeof(std::pair<const T, int>) + sizeof(void*));
+			return ParallelEnsemble<T>::get_MemoryFootprint() + mapSize + m_GlobalToLocalIndex.get_MemoryFootprint();
+		}
+
 	protected:
 
+		//Local index is the position in the ensemble
+		void Renumber(bool buildGlobalToLocalIndex)
+		{
+			int i = 0;
+			decltype(m_pointerToLocalIndex) pointerToLocalIndex(this->m_data.size());
+			std::vector<int> globalIndices; globalIndices.reserve(this->m_data.size());
+			for (auto it = this->m_data.begin(); it != this->m_data.end(); ++it)
+			{
+				(*it)->set_localIndex(i);
+				pointerToLocalIndex.insert(std::make_pair((*it), i));
+				globalIndices.push_back((*it)->get_globalIndex());
+				i++;
+			}
+			m_pointerToLocalIndex.swap(pointerToLocalIndex);
+			if (buildGlobalToLocalIndex)
+			{
+				m_GlobalToLocalIndex.Build(globalIndices);
+			}
+			else
+			{
+				m_GlobalToLocalIndex.clear();
+			}
+		}
+
 		//Pointer to Index
 		std::unordered_map<T, int, HashStruct, EqualStruct> m_pointerToLocalIndex;
 
-		std::unordered_map<int, int> m_GlobalToLocalIndex;
+		IndexMap m_GlobalToLocalIndex;
 
 
 	};
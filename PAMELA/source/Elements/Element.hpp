@@ -122,6 +122,8 @@ namespace PAMELA
 		int get_dimension() { return ELEMENTS::dimension.at(static_cast<int>(m_family)); }
 		ELEMENTS::FAMILY get_family() { return m_family; }
 		ELEMENTS::TYPE get_vtkType() { return m_vtkType; }
+		int get_partitionOwner() const { return m_partitionOwner; }
+		bool get_IsGhost() const { return m_IsGhost; }
 
 		//Setters
 		void set_index(int i) { set_localIndex(i); }
@@ -0,0 +1,286 @@
+/*
+ * ------------------------------------------------------------------------------------------------------------
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ * Copyright (c) 2018-2020 Lawrence Livermore National Security LLC
+ * Copyright (c) 2018-2020 The Board of Trustees of the Leland Stanford Junior University
+ * Copyright (c) 2018-2020 Total, S.A
+ * Copyright (c) 2020-     GEOSX Contributors
+ * All right reserved
+ *
+ * See top level LICENSE, COPYRIGHT, CONTRIBUTORS, NOTICE, and ACKNOWLEDGEMENTS files for details.
+ * ------------------------------------------------------------------------------------------------------------
+ */
+
+#include "Elements/ElementArena.hpp"
+#include <algorithm>
+
+namespace PAMELA
+{
+
+	std::atomic<std::size_t>& ElementArena::NextTypeId()
+	{
+		static std::atomic<std::size_t> next(0);
+		return next;
+	}
+
+	ElementArena::Pool& ElementArena::get_Pool(std::size_t id, std::size_t size, std::size_t alignment, void(*destroy)(void*), void(*relocate)(void*, void*))
+	{
+		if (id >= m_Pools.size())
+		{
+			m_Pools.resize(id + 1);
+		}
+		if (!m_Pools[id])
+		{
+			m_Pools[id].reset(new Pool());
+			auto& pool = *m_Pools[id];
+			pool.slotSize = (size + alignment - 1) / alignment * alignment;
+			pool.alignment = alignment;
+			pool.destroy = destroy;
+			pool.relocate = relocate;
+		}
+		return *m_Pools[id];
+	}
+
+	void* ElementArena::Allocate(Pool& pool)
+	{
+		if (pool.freeSlots.empty())
+		{
+			AddBlock(pool);
+		}
+		auto slot = pool.freeSlots.back();
+		pool.freeSlots.pop_back();
+		slot.first->live[slot.second] = true;
+		slot.first->nLive++;
+		return slot.first->data + slot.second * pool.slotSize;
+	}
+
+	void ElementArena::AddBlock(Pool& pool)
+	{
+		std::unique_ptr<Block> block(new Block());
+		block->pool = &pool;
+		block->data = static_cast<char*>(::operator new(pool.slotSize * BLOCK_SLOTS));
+		block->live.assign(BLOCK_SLOTS, false);
+		block->nLive = 0;
+
+		//Reversed so that consecutive allocations are contiguous
+		for (std::size_t i = BLOCK_SLOTS; i != 0; --i)
+		{
+			pool.freeSlots.push_back(std::make_pair(block.get(), i - 1));
+		}
+		m_BlockTable[block->data] = block.get();
+		pool.blocks.push_back(std::move(block));
+	}
+
+	void ElementArena::FreeBlock(Block* block)
+	{
+		auto& pool = *block->pool;
+		for (std::size_t i = 0; i != BLOCK_SLOTS; ++i)
+		{
+			if (block->live[i])
+			{
+				pool.destroy(block->data + i * pool.slotSize);
+			}
+		}
+		m_BlockTable.erase(block->data);
+		::operator delete(block->data);
+		block->data = nullptr;
+	}
+
+	ElementArena::Block* ElementArena::FindBlock(const void* element) const
+	{
+		auto address = static_cast<const char*>(element);
+		auto it = m_BlockTable.upper_bound(address);
+		if (it == m_BlockTable.begin())
+		{
+			return nullptr;
+		}
+		--it;
+		auto block = it->second;
+		if (address >= block->data + block->pool->slotSize * BLOCK_SLOTS)
+		{
+			return nullptr;
+		}
+		return block;
+	}
+
+	bool ElementArena::Release(const void* element)
+	{
+		auto block = FindBlock(element);
+		if (block == nullptr)
+		{
+			return false;
+		}
+		auto& pool = *block->pool;
+		auto slot = (static_cast<const char*>(element) - block->data) / pool.slotSize;
+		if (!block->live[slot])
+		{
+			return false;
+		}
+		pool.destroy(block->data + slot * pool.slotSize);
+		block->live[slot] = false;
+		block->nLive--;
+		pool.freeSlots.push_back(std::make_pair(block, slot));
+		return true;
+	}
+
+	std::size_t ElementArena::ReleaseAllExcept(std::vector<const void*> kept)
+	{
+		std::sort(kept.begin(), kept.end());
+		std::size_t nReleased = 0;
+		for (auto& pool : m_Pools)
+		{
+			if (!pool)
+			{
+				continue;
+			}
+
+			//Destroy unreferenced elements, then free empty blocks and rebuild the free list in address order
+			for (auto& block : pool->blocks)
+			{
+				for (std::size_t i = 0; i != BLOCK_SLOTS; ++i)
+				{
+					const void* element = block->data + i * pool->slotSize;
+					if (block->live[i] && !std::binary_search(kept.begin(), kept.end(), element))
+					{
+						pool->destroy(block->data + i * pool->slotSize);
+						block->live[i] = false;
+						block->nLive--;
+						nReleased++;
+					}
+				}
+				if (block->nLive == 0)
+				{
+					FreeBlock(block.get());
+				}
+			}
+			pool->blocks.erase(std::remove_if(pool->blocks.begin(), pool->blocks.end(),
+				[](const std::unique_ptr<Block>& block) { return block->data == nullptr; }), pool->blocks.end());
+			RebuildFreeSlots(*pool);
+		}
+		return nReleased;
+	}
+
+	std::vector<std::pair<const void*, void*>> ElementArena::Compact()
+	{
+		std::vector<std::pair<const void*, void*>> relocations;
+		for (auto& pool : m_Pools)
+		{
+			if (!pool)
+			{
+				continue;
+			}
+			auto& blocks = pool->blocks;
+			std::size_t nLive = 0;
+			for (auto& block : blocks)
+			{
+				nLive += block->nLive;
+			}
+			auto nKept = (nLive + BLOCK_SLOTS - 1) / BLOCK_SLOTS;
+			if (nKept == blocks.size())
+			{
+				continue;
+			}
+
+			//The fullest blocks are kept so that the fewest elements move
+			std::stable_sort(blocks.begin(), blocks.end(),
+				[](const std::unique_ptr<Block>& a, const std::unique_ptr<Block>& b) { return a->nLive > b->nLive; });
+			std::vector<std::pair<Block*, std::size_t>> targets;
+			for (std::size_t b = 0; b != nKept; ++b)
+			{
+				for (std::size_t i = 0; i != BLOCK_SLOTS; ++i)
+				{
+					if (!blocks[b]->live[i])
+					{
+						targets.push_back(std::make_pair(blocks[b].get(), i));
+					}
+				}
+			}
+
+			auto target = targets.begin();
+			for (auto b = nKept; b != blocks.size(); ++b)
+			{
+				auto& block = *blocks[b];
+				for (std::size_t i = 0; i != BLOCK_SLOTS && block.nLive != 0; ++i)
+				{
+					if (block.live[i])
+					{
+						void* from = block.data + i * pool->slotSize;
+						void* to = target->first->data + target->second * pool->slotSize;
+						pool->relocate(from, to);
+						block.live[i] = false;
+						block.nLive--;
+						target->first->live[target->second] = true;
+						target->first->nLive++;
+						relocations.push_back(std::make_pair(from, to));
+						++target;
+					}
+				}
+				FreeBlock(&block);
+			}
+			blocks.resize(nKept);
+			RebuildFreeSlots(*pool);
+		}
+		std::sort(relocations.begin(), relocations.end());
+		return relocations;
+	}
+
+	void ElementArena::RebuildFreeSlots(Pool& pool)
+	{
+		//In address order within a block, as for a new block
+		pool.freeSlots.clear();
+		for (auto it = pool.blocks.rbegin(); it != pool.blocks.rend(); ++it)
+		{
+			for (std::size_t i = BLOCK_SLOTS; i != 0; --i)
+			{
+				if (!(*it)->live[i - 1])
+				{
+					pool.freeSlots.push_back(std::make_pair(it->get(), i - 1));
+				}
+			}
+		}
+	}
+
+	void ElementArena::Clear()
+	{
+		for (auto& pool : m_Pools)
+		{
+			if (!pool)
+			{
+				continue;
+			}
+			for (auto& block : pool->blocks)
+			{
+				FreeBlock(block.get());
+			}
+			pool->blocks.clear();
+			pool->freeSlots.clear();
+		}
+		m_BlockTable.clear();
+	}
+
+	std::size_t ElementArena::get_ElementCount() const
+	{
+		std::size_t count = 0;
+		for (auto& block : m_BlockTable)
+		{
+			count += block.second->nLive;
+		}
+		return count;
+	}
+
+	std::size_t ElementArena::get_MemoryFootprint() const
+	{
+		std::size_t footprint = sizeof(ElementArena) + m_Pools.capacity() * sizeof(std::unique_ptr<Pool>);
+		for (auto& pool : m_Pools)
+		{
+			if (pool)
+			{
+				footprint += sizeof(Pool) + pool->freeSlots.capacity() * sizeof(std::pair<Block*, std::size_t>)
+					+ pool->blocks.size() * (sizeof(Block) + pool->slotSize * BLOCK_SLOTS + BLOCK_SLOTS / 8);
+			}
+		}
+		return footprint;
+	}
+
+}
@@ -0,0 +1,121 @@
+/*
+ * ------------------------------------------------------------------------------------------------------------
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ * Copyright (c) 2018-2020 Lawrence Livermore National Security LLC
+ * Copyright (c) 2018-2020 The Board of Trustees of the Leland Stanford Junior University
+ * Copyright (c) 2018-2020 Total, S.A
+ * Copyright (c) 2020-     GEOSX Contributors
+ * All right reserved
+ *
+ * See top level LICENSE, COPYRIGHT, CONTRIBUTORS, NOTICE, and ACKNOWLEDGEMENTS files for details.
+ * ------------------------------------------------------------------------------------------------------------
+ */
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace PAMELA
+{
+
+	/**
+	* \brief Block allocator for mesh elements. Elements are constructed in fixed-size blocks, one pool per concrete
+	* element type, and destroyed in bulk when the arena is cleared or destroyed. Elements must not be deleted directly.
+	*/
+	class ElementArena
+	{
+
+	public:
+
+		ElementArena() = default;
+		~ElementArena() { Clear(); }
+
+		ElementArena(const ElementArena&) = delete;
+		ElementArena& operator=(const ElementArena&) = delete;
+
+		//Construct an element of concrete type T in the pool of T
+		template <class T, class... Args>
+		T* Create(Args&&... args)
+		{
+			auto& pool = get_Pool(TypeId<T>(), sizeof(T), alignof(T), &Destroy<T>, &Relocate<T>);
+			return new (Allocate(pool)) T(std::forward<Args>(args)...);
+		}
+
+		//Destroy a single element and recycle its slot. Returns false if the element is not owned by the arena
+		bool Release(const void* element);
+		bool Owns(const void* element) const { return FindBlock(element) != nullptr; }
+
+		//Destroy every element not listed in kept, and free the blocks left empty
+		std::size_t ReleaseAllExcept(std::vector<const void*> kept);
+
+		//Move the elements of each pool into as few blocks as possible and free the others. Returns the old and new
+		//address of the moved elements sorted by old address: every pointer to them must be updated by the caller.
+		std::vector<std::pair<const void*, void*>> Compact();
+
+		//Destroy all elements and free all blocks
+		void Clear();
+
+		std::size_t get_ElementCount() const;
+		std::size_t get_MemoryFootprint() const;
+
+	private:
+
+		static const std::size_t BLOCK_SLOTS = 1024;
+
+		struct Block;
+
+		struct Pool
+		{
+			std::size_t slotSize;
+			std::size_t alignment;
+			void(*destroy)(void*);
+			void(*relocate)(void*, void*);
+			std::vector<std::unique_ptr<Block>> blocks;
+			std::vector<std::pair<Block*, std::size_t>> freeSlots;
+		};
+
+		struct Block
+		{
+			Pool* pool;
+			char* data;
+			std::vector<bool> live;
+			std::size_t nLive;
+		};
+
+		template <class T>
+		static void Destroy(void* element) { static_cast<T*>(element)->~T(); }
+
+		template <class T>
+		static void Relocate(void* from, void* to)
+		{
+			new (to) T(std::move(*static_cast<T*>(from)));
+			static_cast<T*>(from)->~T();
+		}
+
+		template <class T>
+		static std::size_t TypeId()
+		{
+			static const std::size_t id = NextTypeId()++;
+			return id;
+		}
+		static std::atomic<std::size_t>& NextTypeId();
+
+		Pool& get_Pool(std::size_t id, std::size_t size, std::size_t alignment, void(*destroy)(void*), void(*relocate)(void*, void*));
+		void* Allocate(Pool& pool);
+		void AddBlock(Pool& pool);
+		void FreeBlock(Block* block);
+		void RebuildFreeSlots(Pool& pool);
+		Block* FindBlock(const void* element) const;
+
+		std::vector<std::unique_ptr<Pool>> m_Pools {};
+		std::map<const char*, Block*> m_BlockTable {};  //Blocks by start address
+
+	};
+
+}
@@ -19,64 +19,114 @@ namespace PAMELA
 {
   namespace ElementFactory {
 
-    Point* makePoint(ELEMENTS::TYPE elementType, int index, double x, double y, double z)
-    {
-      ASSERT(elementType == ELEMENTS::TYPE::VTK_VERTEX, "Cannot make a point with this type");
-      (void) elementType;
-      return new Vertex(index, x, y, z);
-    }
-
-    Line* makeLine(ELEMENTS::TYPE elementType, int index, const std::vector<Point*>& vertexList)
+    namespace
     {
-      ASSERT(elementType == ELEMENTS::TYPE::VTK_LINE, "Cannot make a line with this type");
-      (void) elementType;
-      return new ElementSpe<ELEMENTS::FAMILY::LINE, ELEMENTS::TYPE::VTK_LINE>(index, vertexList);
-    }
+      //Heap allocation when no arena is given
+      template <class T, class... Args>
+      T* Make(ElementArena* arena, Args&&... args)
+      {
+        return arena ? arena->Create<T>(std::forward<Args>(args)...) : new T(std::forward<Args>(args)...);
+      }
 
-    Polygon* makePolygon(ELEMENTS::TYPE elementType, int index, const std::vector<Point*>& vertexList)
-    {
+      Point* MakePoint(ElementArena* arena, ELEMENTS::TYPE elementType, int index, double x, double y, double z)
+      {
+        ASSERT(elementType == ELEMENTS::TYPE::VTK_VERTEX, "Cannot make a point with this type");
+        (void) elementType;
+        return Make<Vertex>(arena, index, x, y, z);
+      }
 
-      ASSERT(ELEMENTS::TypeToFamily.at(static_cast<int>(elementType)) == ELEMENTS::FAMILY::POLYGON, "Element type is not a polygon");
+      Line* MakeLine(ElementArena* arena, ELEMENTS::TYPE elementType, int index, const std::vector<Point*>& vertexList)
+      {
+        ASSERT(elementType == ELEMENTS::TYPE::VTK_LINE, "Cannot make a line with this type");
+        (void) elementType;
+        return Make<ElementSpe<ELEMENTS::FAMILY::LINE, ELEMENTS::TYPE::VTK_LINE>>(arena, index, vertexList);
+      }
 
-      switch (elementType)
+      Polygon* MakePolygon(ElementArena* arena, ELEMENTS::TYPE elementType, int index, const std::vector<Point*>& vertexList)
       {
-        case ELEMENTS::TYPE::VTK_TRIANGLE:
-          return new ElementSpe<ELEMENTS::FAMILY::POLYGON, ELEMENTS::TYPE::VTK_TRIANGLE>(index, vertexList);
 
-        case ELEMENTS::TYPE::VTK_QUAD:
-          return new ElementSpe<ELEMENTS::FAMILY::POLYGON, ELEMENTS::TYPE::VTK_QUAD>(index, vertexList);
+        ASSERT(ELEMENTS::TypeToFamily.at(static_cast<int>(elementType)) == ELEMENTS::FAMILY::POLYGON, "Element type is not a polygon");
+
+        switch (elementType)
+        {
+          case ELEMENTS::TYPE::VTK_TRIANGLE:
+            return Make<ElementSpe<ELEMENTS::FAMILY::POLYGON, ELEMENTS::TYPE::VTK_TRIANGLE>>(arena, index, vertexList);
+
+          case ELEMENTS::TYPE::VTK_QUAD:
+            return Make<ElementSpe<ELEMENTS::FAMILY::POLYGON, ELEMENTS::TYPE::VTK_QUAD>>(arena, index, vertexList);
+
+          default:
+            LOGERROR("Element type is unknown");
+            return nullptr;
+        }
 
-        default:
-          LOGERROR("Element type is unknown");
-          return nullptr;
       }
 
+      Polyhedron* MakePolyhedron(ElementArena* arena, ELEMENTS::TYPE elementType, int index, const std::vector<Point*>& vertexList)
+      {
+
+        ASSERT(ELEMENTS::TypeToFamily.at(static_cast<int>(elementType)) == ELEMENTS::FAMILY::POLYHEDRON, "Element type is not a polyhedron");
+
+        switch (elementType)
+        {
+
+          case ELEMENTS::TYPE::VTK_HEXAHEDRON:
+            return Make<ElementSpe<ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::TYPE::VTK_HEXAHEDRON>>(arena, index, vertexList);
+
+          case ELEMENTS::TYPE::VTK_TETRA:
+            return Make<ElementSpe<ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::TYPE::VTK_TETRA>>(arena, index, vertexList);
+
+          case ELEMENTS::TYPE::VTK_PYRAMID:
+            return Make<ElementSpe<ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::TYPE::VTK_PYRAMID>>(arena, index, vertexList);
+
+          case ELEMENTS::TYPE::VTK_WEDGE:
+            return Make<ElementSpe<ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::TYPE::VTK_WEDGE>>(arena, index, vertexList);
+
+          default:
+            LOGERROR("Element type is unknown");
+            return nullptr;
+        }
+      }
     }
 
-    Polyhedron* makePolyhedron(ELEMENTS::TYPE elementType, int index, const std::vector<Point*>& vertexList)
+    Point* makePoint(ELEMENTS::TYPE elementType, int index, double x, double y, double z)
     {
+      return MakePoint(nullptr, elementType, index, x, y, z);
+    }
 
-      ASSERT(ELEMENTS::TypeToFamily.at(static_cast<int>(elementType)) == ELEMENTS::FAMILY::POLYHEDRON, "Element type is not a polyhedron");
+    Line* makeLine(ELEMENTS::TYPE elementType, int index, const std::vector<Point*>& vertexList)
+    {
+      return MakeLine(nullptr, elementType, index, vertexList);
+    }
 
-      switch (elementType)
-      {
+    Polygon* makePolygon(ELEMENTS::TYPE elementType, int index, const std::vector<Point*>& vertexList)
+    {
+      return MakePolygon(nullptr, elementType, index, vertexList);
+    }
 
-        case ELEMENTS::TYPE::VTK_HEXAHEDRON:
-          return new ElementSpe<ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::TYPE::VTK_HEXAHEDRON>(index, vertexList);
+    Polyhedron* makePolyhedron(ELEMENTS::TYPE elementType, int index, const std::vector<Point*>& vertexList)
+    {
+      return MakePolyhedron(nullptr, elementType, index, vertexList);
+    }
 
-        case ELEMENTS::TYPE::VTK_TETRA:
-          return new ElementSpe<ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::TYPE::VTK_TETRA>(index, vertexList);
+    Point* makePoint(ElementArena& arena, ELEMENTS::TYPE elementType, int index, double x, double y, double z)
+    {
+      return MakePoint(&arena, elementType, index, x, y, z);
+    }
 
-        case ELEMENTS::TYPE::VTK_PYRAMID:
-          return new ElementSpe<ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::TYPE::VTK_PYRAMID>(index, vertexList);
+    Line* makeLine(ElementArena& arena, ELEMENTS::TYPE elementType, int index, const std::vector<Point*>& vertexList)
+    {
+      return MakeLine(&arena, elementType, index, vertexList);
+    }
 
-        case ELEMENTS::TYPE::VTK_WEDGE:
-          return new ElementSpe<ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::TYPE::VTK_WEDGE>(index, vertexList);
+    Polygon* makePolygon(ElementArena& arena, ELEMENTS::TYPE elementType, int index, const std::vector<Point*>& vertexList)
+    {
+      return MakePolygon(&arena, elementType, index, vertexList);
+    }
 
-        default:
-          LOGERROR("Element type is unknown");
-          return nullptr;
-      }
+    Polyhedron* makePolyhedron(ElementArena& arena, ELEMENTS::TYPE elementType, int index, const std::vector<Point*>& vertexList)
+    {
+      return MakePolyhedron(&arena, elementType, index, vertexList);
     }
   }
 }
@@ -19,6 +19,7 @@
 #include "Elements/Polygon.hpp"
 #include "Elements/Line.hpp"
 #include "Elements/Point.hpp"
+#include "Elements/ElementArena.hpp"
 
 namespace PAMELA
 {
@@ -27,5 +28,11 @@ namespace PAMELA
     Line*  makeLine(ELEMENTS::TYPE  elementType, int index, const std::vector<Point*>& vertexList);
     Polygon*  makePolygon(ELEMENTS::TYPE  elementType, int index, const std::vector<Point*>& vertexList);
     Polyhedron* makePolyhedron(ELEMENTS::TYPE elementType, int index, const std::vector<Point*>& vertexList);
+
+    //Same, allocated in an arena which owns the element
+    Point* makePoint(ElementArena& arena, ELEMENTS::TYPE  elementType, int index, double x, double y, double z);
+    Line*  makeLine(ElementArena& arena, ELEMENTS::TYPE  elementType, int index, const std::vector<Point*>& vertexList);
+    Polygon*  makePolygon(ElementArena& arena, ELEMENTS::TYPE  elementType, int index, const std::vector<Point*>& vertexList);
+    Polyhedron* makePolyhedron(ElementArena& arena, ELEMENTS::TYPE elementType, int index, const std::vector<Point*>& vertexList);
   }
 }
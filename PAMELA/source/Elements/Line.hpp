@@ -39,6 +39,7 @@ namespace PAMELA
 
 		//Getter
 		const std::vector<Point*>& get_vertexList() const { return m_vertexList; }
+		std::vector<Point*>& get_vertexList() { return m_vertexList; }
 
 	protected:
 
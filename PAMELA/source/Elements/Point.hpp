@@ -37,6 +37,15 @@ namespace PAMELA
                         m_index.Init = index;
 		}
 
+		//The vertex list of a copy refers to the copy
+		Element(const Element& other) :ElementBase(other), m_coordinates(other.m_coordinates), m_vertexList({ this }) {}
+		Element& operator=(const Element& other)
+		{
+			ElementBase::operator=(other);
+			m_coordinates = other.m_coordinates;
+			return *this;
+		}
+
 
 		//Getters
 		const Coordinates& get_coordinates() const { return m_coordinates; }
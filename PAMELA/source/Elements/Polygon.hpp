@@ -13,11 +13,14 @@
  */
 
 #pragma once
+#include <array>
+#include <cmath>
 #include <vector>
 #include "Elements/Point.hpp"
 #include "Utils/SimpleMaths.hpp"
 #include "Line.hpp"
 #include "Elements/Element.hpp"
+#include "Elements/ShapeFunctions.hpp"
 #include "Utils/Assert.hpp"
 #include "Utils/Utils.hpp"
 
@@ -52,106 +55,10 @@ namespace PAMELA
 
 		std::vector<Point*> m_vertexList;
 
-		//Functions
-		virtual std::vector <double> get_BasisFunctions(double xi_1, double xi_2) = 0;
-		virtual std::vector<std::vector<double>> get_BasisFunctionDerivatives(double xi_1, double xi_2) = 0;
-		std::vector <double> get_RealSpaceCoordinatesFromReferenceSpace(double xi_1, double xi_2);
-		std::pair<std::vector<std::vector<double>>, std::vector <double>> get_JacobianMatrixAndCrossProduct(double xi_1, double xi_2);
-		std::pair<std::vector <double>, std::vector <double>> get_NormalVectorAndCoordinates(double xi_1, double xi_2);
-
-
 	};
 
 	typedef Element<ELEMENTS::FAMILY::POLYGON> Polygon;
 
-	/**
-	 * \brief From reference to real space
-	 * \param xi_1
-	 * \param xi_2
-	 * \return
-	 */
-	inline std::vector<double> Element<ELEMENTS::FAMILY::POLYGON>::get_RealSpaceCoordinatesFromReferenceSpace(double xi_1, double xi_2)
-	{
-		std::vector<double> coordinate = { 0, 0, 0 };
-		std::vector<double> basis_function = get_BasisFunctions(xi_1, xi_2);
-
-		for (auto i = 0; i != static_cast<int>(m_vertexList.size()); ++i)
-		{
-			coordinate[0] = coordinate[0] + m_vertexList[i]->get_coordinates().x * basis_function[i];
-			coordinate[1] = coordinate[1] + m_vertexList[i]->get_coordinates().y * basis_function[i];
-			coordinate[2] = coordinate[2] + m_vertexList[i]->get_coordinates().z * basis_function[i];
-		}
-
-		return coordinate;
-
-	}
-
-	/**
-	 * \brief
-	 * \param xi_1
-	 * \param xi_2
-	 * \return
-	 */
-	inline std::pair<std::vector<std::vector<double>>, std::vector<double>> Element<ELEMENTS::FAMILY::POLYGON>::get_JacobianMatrixAndCrossProduct(double xi_1, double xi_2)
-	{
-		std::vector<std::vector<double>> matrix;
-		auto basis_function_derivatives_matrix = get_BasisFunctionDerivatives(xi_1, xi_2);
-		std::pair<std::vector<std::vector<double>>, std::vector<double>> result;
-
-		matrix = { { 0, 0 },{ 0, 0 },{ 0, 0 } };
-
-
-		for (auto i = 0; i != 2; ++i)
-		{
-			for (auto j = 0; j != static_cast<int>(m_vertexList.size()); ++j)
-			{
-				matrix[0][i] = matrix[0][i] + m_vertexList[j]->get_coordinates().x * basis_function_derivatives_matrix[j][i];
-				matrix[1][i] = matrix[1][i] + m_vertexList[j]->get_coordinates().y * basis_function_derivatives_matrix[j][i];
-				matrix[2][i] = matrix[2][i] + m_vertexList[j]->get_coordinates().z * basis_function_derivatives_matrix[j][i];
-			}
-		}
-
-		std::vector<double> vector_1 = { matrix[0][0], matrix[1][0], matrix[2][0] };
-		std::vector<double> vector_2 = { matrix[0][1], matrix[1][1], matrix[2][1] };
-
-		std::vector<double> cross_product_vector = cross_product(vector_1, vector_2);
-
-		result.first = matrix;
-		result.second = cross_product_vector;
-
-		return result;
-
-	}
-
-
-	/**
-	 * \brief
-	 * \param xi_1
-	 * \param xi_2
-	 * \return
-	 */
-	inline std::pair<std::vector<double>, std::vector<double>> Element<ELEMENTS::FAMILY::POLYGON>::get_NormalVectorAndCoordinates(double xi_1, double xi_2)
-	{
-
-		std::pair<std::vector<double>, std::vector<double>>  result;
-
-		std::vector<double> cross_product_vector = get_JacobianMatrixAndCrossProduct(xi_1, xi_2).second;
-		double vnorm = norm(cross_product_vector);
-		std::vector<double> normal_vector(3);
-		for (auto i = 0; i != 3; ++i)
-		{
-			normal_vector[i] = cross_product_vector[i] / vnorm;
-		}
-
-		std::vector<double> coordinates = get_RealSpaceCoordinatesFromReferenceSpace(xi_1, xi_2);
-
-		result.first = normal_vector;
-		result.second = coordinates;
-
-		return result;
-	}
-
-
 	/**
 	 * \brief
 	 * \tparam elementType
@@ -176,10 +83,11 @@ namespace PAMELA
 
 	private:
 
+		typedef shape::ShapeFunctions<elementType> Shape;
+
 		//Functions
-		std::vector <double> get_BasisFunctions(double xi_1, double xi_2) override;
-		std::vector<std::vector<double>> get_BasisFunctionDerivatives(double xi_1, double xi_2) override;
 		std::pair<std::vector <double>, std::vector <double>> get_NormalVectorAndCoordinates() override;
+		std::array<double, 3> get_JacobianCrossProduct(const typename Shape::Derivatives& dN) const;
 
 
 	};
@@ -187,34 +95,20 @@ namespace PAMELA
 
 
 
-	//-------------------------------------------------------------------------------VTK_QUAD
-
 	/**
-	* \brief Provide surface area
+	* \brief Provide surface area, Gauss integration of the norm of the Jacobian cross product
 	* \return
 	*/
-	template <>
-	inline double ElementSpe<ELEMENTS::FAMILY::POLYGON, ELEMENTS::TYPE::VTK_QUAD>::get_SurfaceArea()
+	template <ELEMENTS::TYPE elementType>
+	inline double ElementSpe<ELEMENTS::FAMILY::POLYGON, elementType>::get_SurfaceArea()
 	{
-		std::vector<double> Gauss_weight(4);
-		Gauss_weight[0] = 1.;
-		Gauss_weight[1] = 1.;
-		Gauss_weight[2] = 1.;
-		Gauss_weight[3] = 1.;
-
-		double alpha = 1. / sqrt(3);
-		std::vector<std::vector<double>> Gauss_point(4);
-		Gauss_point[0] = { -alpha, -alpha };
-		Gauss_point[1] = { alpha, -alpha };
-		Gauss_point[2] = { alpha, alpha };
-		Gauss_point[3] = { -alpha, alpha };
+		static constexpr auto table = shape::MakeGaussTable<elementType>();
 
 		double surface_area = 0;
-		std::vector<double> cross_product_vector;
-		for (auto i = 0; i != 4; ++i)
+		for (auto g = 0; g != Shape::nGauss; ++g)
 		{
-			cross_product_vector = get_JacobianMatrixAndCrossProduct(Gauss_point[i][0], Gauss_point[i][1]).second;
-			surface_area = surface_area + Gauss_weight[i] * norm(cross_product_vector);
+			auto cross_product_vector = get_JacobianCrossProduct(table.dN[g]);
+			surface_area = surface_area + table.weight[g] * std::sqrt(cross_product_vector[0] * cross_product_vector[0] + cross_product_vector[1] * cross_product_vector[1] + cross_product_vector[2] * cross_product_vector[2]);
 		}
 
 		return surface_area;
@@ -222,131 +116,72 @@ namespace PAMELA
 
 
 	/**
-	* \brief
-	* \return
-	*/
-	template <>
-	inline std::vector<double> ElementSpe<ELEMENTS::FAMILY::POLYGON, ELEMENTS::TYPE::VTK_QUAD>::get_centroidCoordinates()
-	{
-		return get_RealSpaceCoordinatesFromReferenceSpace(0, 0);
-	}
-
-
-	/**
-	* \brief Provide normal vector and its location
+	* \brief Image of the center of the reference element
 	* \return
 	*/
-	template <>
-	inline std::pair<std::vector<double>, std::vector<double>> ElementSpe<ELEMENTS::FAMILY::POLYGON, ELEMENTS::TYPE::VTK_QUAD>::get_NormalVectorAndCoordinates()
-	{
-		return Element<ELEMENTS::FAMILY::POLYGON>::get_NormalVectorAndCoordinates(0., 0.);
-	}
-
-	template <>
-	inline std::vector<double> ElementSpe<ELEMENTS::FAMILY::POLYGON, ELEMENTS::TYPE::VTK_QUAD>::get_BasisFunctions(double xi_1, double xi_2)
+	template <ELEMENTS::TYPE elementType>
+	inline std::vector<double> ElementSpe<ELEMENTS::FAMILY::POLYGON, elementType>::get_centroidCoordinates()
 	{
-		std::vector<double> basis_functions;
+		static constexpr auto table = shape::MakeGaussTable<elementType>();
 
-		basis_functions.push_back(1. / 4. * (1 - xi_1) * (1 - xi_2));
-		basis_functions.push_back(1. / 4. * (1 + xi_1) * (1 - xi_2));
-		basis_functions.push_back(1. / 4. * (1 + xi_1) * (1 + xi_2));
-		basis_functions.push_back(1. / 4. * (1 - xi_1) * (1 + xi_2));
-
-		return basis_functions;
-
-	}
-
-	template <>
-	inline std::vector<std::vector<double>> ElementSpe<ELEMENTS::FAMILY::POLYGON, ELEMENTS::TYPE::VTK_QUAD>::get_BasisFunctionDerivatives(double xi_1, double xi_2)
-	{
-		std::vector<double> row;
-		std::vector<std::vector<double>> matrix;
-
-		row = { -1. / 4. * (1 - xi_2), -1. / 4. * (1 - xi_1) };
-		matrix.push_back(row);
-		row = { 1. / 4. * (1 - xi_2), -1. / 4. * (1 + xi_1) };
-		matrix.push_back(row);
-		row = { 1. / 4. * (1 + xi_2), 1. / 4. * (1 + xi_1) };
-		matrix.push_back(row);
-		row = { -1. / 4. * (1 + xi_2), 1. / 4. * (1 - xi_1) };
-		matrix.push_back(row);
-		return matrix;
+		std::vector<double> coordinate = { 0, 0, 0 };
+		for (auto i = 0; i != Shape::nVertex; ++i)
+		{
+			const auto& xyz = m_vertexList[i]->get_coordinates();
+			coordinate[0] = coordinate[0] + xyz.x * table.centerN[i];
+			coordinate[1] = coordinate[1] + xyz.y * table.centerN[i];
+			coordinate[2] = coordinate[2] + xyz.z * table.centerN[i];
+		}
 
+		return coordinate;
 	}
 
-	//-------------------------------------------------------------------------------VTK_TRIANGLE
 
 	/**
-	* \brief Provide surface area
+	* \brief Provide unit normal vector and its location, both at the center of the reference element
 	* \return
 	*/
-	template <>
-	inline double ElementSpe<ELEMENTS::FAMILY::POLYGON, ELEMENTS::TYPE::VTK_TRIANGLE>::get_SurfaceArea()
-	{
-		double surface_area = 0;
-		std::vector<double> cross_product_vector;
-		cross_product_vector = get_JacobianMatrixAndCrossProduct(0, 0).second;
-		surface_area = norm(cross_product_vector);
-
-		return surface_area;
-	}
-
-	/**
-	* \brief Provide normal vector and its location
-	* \return
-	*/
-	template <>
-	inline std::pair<std::vector<double>, std::vector<double>> ElementSpe<ELEMENTS::FAMILY::POLYGON, ELEMENTS::TYPE::VTK_TRIANGLE>::get_NormalVectorAndCoordinates()
-	{
-		return Element<ELEMENTS::FAMILY::POLYGON>::get_NormalVectorAndCoordinates(0., 0.);
-	}
-
-	template <>
-	inline std::vector<double> ElementSpe<ELEMENTS::FAMILY::POLYGON, ELEMENTS::TYPE::VTK_TRIANGLE>::get_BasisFunctions(double xi_1, double xi_2)
+	template <ELEMENTS::TYPE elementType>
+	inline std::pair<std::vector<double>, std::vector<double>> ElementSpe<ELEMENTS::FAMILY::POLYGON, elementType>::get_NormalVectorAndCoordinates()
 	{
-		std::vector<double> basis_functions;
-
-		basis_functions.push_back(1 - xi_1 - xi_2);
-		basis_functions.push_back(xi_1);
-		basis_functions.push_back(xi_2);
-
-		return basis_functions;
-
-	}
+		static constexpr auto table = shape::MakeGaussTable<elementType>();
 
+		auto cross_product_vector = get_JacobianCrossProduct(table.centerDN);
+		double vnorm = std::sqrt(cross_product_vector[0] * cross_product_vector[0] + cross_product_vector[1] * cross_product_vector[1] + cross_product_vector[2] * cross_product_vector[2]);
+		std::vector<double> normal_vector(3);
+		for (auto i = 0; i != 3; ++i)
+		{
+			normal_vector[i] = cross_product_vector[i] / vnorm;
+		}
 
-	///**
-	//* \brief
-	//* \return
-	//*/
-	template <>
-	inline std::vector<double> ElementSpe<ELEMENTS::FAMILY::POLYGON, ELEMENTS::TYPE::VTK_TRIANGLE>::get_centroidCoordinates()
-	{
-		return get_RealSpaceCoordinatesFromReferenceSpace(1. / 3., 1. / 3.);
+		return std::make_pair(normal_vector, get_centroidCoordinates());
 	}
 
 
 	/**
-	* \brief
-	* \param xi_1
-	* \param xi_2
+	* \brief Cross product of the two columns of the Jacobian matrix
+	* \param dN basis function derivatives at a point of the reference element
 	* \return
 	*/
-	template <>
-	inline std::vector<std::vector<double>> ElementSpe<ELEMENTS::FAMILY::POLYGON, ELEMENTS::TYPE::VTK_TRIANGLE>::get_BasisFunctionDerivatives(double xi_1, double xi_2)
+	template <ELEMENTS::TYPE elementType>
+	inline std::array<double, 3> ElementSpe<ELEMENTS::FAMILY::POLYGON, elementType>::get_JacobianCrossProduct(const typename Shape::Derivatives& dN) const
 	{
-                utils::pamela_unused(xi_1);
-                utils::pamela_unused(xi_2);
-		std::vector<double> row;
-		std::vector<std::vector<double>> matrix;
-
-		row = { -1,-1 };
-		matrix.push_back(row);
-		row = { 1,0 };
-		matrix.push_back(row);
-		row = { 0,1 };
-		matrix.push_back(row);
-		return matrix;
+		double matrix[3][2] = { { 0, 0 },{ 0, 0 },{ 0, 0 } };
+
+		for (auto j = 0; j != Shape::nVertex; ++j)
+		{
+			const auto& xyz = m_vertexList[j]->get_coordinates();
+			for (auto i = 0; i != 2; ++i)
+			{
+				matrix[0][i] = matrix[0][i] + xyz.x * dN[j][i];
+				matrix[1][i] = matrix[1][i] + xyz.y * dN[j][i];
+				matrix[2][i] = matrix[2][i] + xyz.z * dN[j][i];
+			}
+		}
+
+		return {{ matrix[1][0] * matrix[2][1] - matrix[2][0] * matrix[1][1],
+		          matrix[2][0] * matrix[0][1] - matrix[0][0] * matrix[2][1],
+		          matrix[0][0] * matrix[1][1] - matrix[1][0] * matrix[0][1] }};
 	}
 
 
@@ -0,0 +1,293 @@
+/*
+ * ------------------------------------------------------------------------------------------------------------
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ * Copyright (c) 2018-2020 Lawrence Livermore National Security LLC
+ * Copyright (c) 2018-2020 The Board of Trustees of the Leland Stanford Junior University
+ * Copyright (c) 2018-2020 Total, S.A
+ * Copyright (c) 2020-     GEOSX Contributors
+ * All right reserved
+ *
+ * See top level LICENSE, COPYRIGHT, CONTRIBUTORS, NOTICE, and ACKNOWLEDGEMENTS files for details.
+ * ------------------------------------------------------------------------------------------------------------
+ */
+
+#pragma once
+#include <array>
+#include <utility>
+#include "Elements/Element.hpp"
+
+namespace PAMELA
+{
+
+	namespace shape
+	{
+
+		// 1/sqrt(3), abscissa of the two-point Gauss rule on [-1,1]
+		constexpr double GAUSS_2 = 0.57735026918962576451;
+
+		/**
+		 * \brief Basis functions of the reference element of a given type.
+		 * Each specialization provides nVertex, dimension, nGauss, the Gauss points and weights, the reference
+		 * center used for centroids and normals, and the basis functions N and their derivatives dN as constexpr functions.
+		 */
+		template <ELEMENTS::TYPE elementType>
+		struct ShapeFunctions;
+
+		//-------------------------------------------------------------------------------VTK_TRIANGLE
+
+		template <>
+		struct ShapeFunctions<ELEMENTS::TYPE::VTK_TRIANGLE>
+		{
+			static constexpr int nVertex = 3;
+			static constexpr int dimension = 2;
+			static constexpr int nGauss = 1;
+			typedef std::array<double, dimension> ReferencePoint;
+			typedef std::array<double, nVertex> Values;
+			typedef std::array<std::array<double, dimension>, nVertex> Derivatives;
+
+			static constexpr ReferencePoint center() { return {{ 1. / 3., 1. / 3. }}; }
+			static constexpr ReferencePoint gaussPoint(int) { return center(); }
+			static constexpr double gaussWeight(int) { return 1. / 2.; }
+
+			static constexpr Values N(const ReferencePoint& xi)
+			{
+				return {{ 1 - xi[0] - xi[1], xi[0], xi[1] }};
+			}
+
+			static constexpr Derivatives dN(const ReferencePoint&)
+			{
+				return {{ {{ -1, -1 }}, {{ 1, 0 }}, {{ 0, 1 }} }};
+			}
+		};
+
+		//-------------------------------------------------------------------------------VTK_QUAD
+
+		template <>
+		struct ShapeFunctions<ELEMENTS::TYPE::VTK_QUAD>
+		{
+			static constexpr int nVertex = 4;
+			static constexpr int dimension = 2;
+			static constexpr int nGauss = 4;
+			typedef std::array<double, dimension> ReferencePoint;
+			typedef std::array<double, nVertex> Values;
+			typedef std::array<std::array<double, dimension>, nVertex> Derivatives;
+
+			static constexpr ReferencePoint center() { return {{ 0, 0 }}; }
+			static constexpr ReferencePoint gaussPoint(int g)
+			{
+				constexpr double sign[4][2] = { { -1, -1 },{ 1, -1 },{ 1, 1 },{ -1, 1 } };
+				return {{ GAUSS_2 * sign[g][0], GAUSS_2 * sign[g][1] }};
+			}
+			static constexpr double gaussWeight(int) { return 1.; }
+
+			static constexpr Values N(const ReferencePoint& xi)
+			{
+				return {{ 1. / 4. * (1 - xi[0]) * (1 - xi[1]),
+				          1. / 4. * (1 + xi[0]) * (1 - xi[1]),
+				          1. / 4. * (1 + xi[0]) * (1 + xi[1]),
+				          1. / 4. * (1 - xi[0]) * (1 + xi[1]) }};
+			}
+
+			static constexpr Derivatives dN(const ReferencePoint& xi)
+			{
+				return {{ {{ -1. / 4. * (1 - xi[1]), -1. / 4. * (1 - xi[0]) }},
+				          {{ 1. / 4. * (1 - xi[1]), -1. / 4. * (1 + xi[0]) }},
+				          {{ 1. / 4. * (1 + xi[1]), 1. / 4. * (1 + xi[0]) }},
+				          {{ -1. / 4. * (1 + xi[1]), 1. / 4. * (1 - xi[0]) }} }};
+			}
+		};
+
+		//-------------------------------------------------------------------------------VTK_TETRA
+
+		template <>
+		struct ShapeFunctions<ELEMENTS::TYPE::VTK_TETRA>
+		{
+			static constexpr int nVertex = 4;
+			static constexpr int dimension = 3;
+			static constexpr int nGauss = 1;
+			typedef std::array<double, dimension> ReferencePoint;
+			typedef std::array<double, nVertex> Values;
+			typedef std::array<std::array<double, dimension>, nVertex> Derivatives;
+
+			static constexpr ReferencePoint center() { return {{ 1. / 4., 1. / 4., 1. / 4. }}; }
+			static constexpr ReferencePoint gaussPoint(int) { return center(); }
+			static constexpr double gaussWeight(int) { return 1. / 6.; }
+
+			static constexpr Values N(const ReferencePoint& xi)
+			{
+				return {{ 1 - xi[0] - xi[1] - xi[2], xi[0], xi[1], xi[2] }};
+			}
+
+			static constexpr Derivatives dN(const ReferencePoint&)
+			{
+				return {{ {{ -1, -1, -1 }}, {{ 1, 0, 0 }}, {{ 0, 1, 0 }}, {{ 0, 0, 1 }} }};
+			}
+		};
+
+		//-------------------------------------------------------------------------------VTK_HEXAHEDRON
+
+		template <>
+		struct ShapeFunctions<ELEMENTS::TYPE::VTK_HEXAHEDRON>
+		{
+			static constexpr int nVertex = 8;
+			static constexpr int dimension = 3;
+			static constexpr int nGauss = 8;
+			typedef std::array<double, dimension> ReferencePoint;
+			typedef std::array<double, nVertex> Values;
+			typedef std::array<std::array<double, dimension>, nVertex> Derivatives;
+
+			static constexpr ReferencePoint center() { return {{ 0, 0, 0 }}; }
+			static constexpr ReferencePoint gaussPoint(int g)
+			{
+				constexpr double sign[8][3] = { { -1, -1, -1 },{ 1, -1, -1 },{ 1, 1, -1 },{ -1, 1, -1 },
+				                                { -1, -1, 1 },{ 1, -1, 1 },{ 1, 1, 1 },{ -1, 1, 1 } };
+				return {{ GAUSS_2 * sign[g][0], GAUSS_2 * sign[g][1], GAUSS_2 * sign[g][2] }};
+			}
+			static constexpr double gaussWeight(int) { return 1.; }
+
+			static constexpr Values N(const ReferencePoint& xi)
+			{
+				return {{ 1. / 8. * (1 - xi[0]) * (1 - xi[1]) * (1 - xi[2]),
+				          1. / 8. * (1 + xi[0]) * (1 - xi[1]) * (1 - xi[2]),
+				          1. / 8. * (1 + xi[0]) * (1 + xi[1]) * (1 - xi[2]),
+				          1. / 8. * (1 - xi[0]) * (1 + xi[1]) * (1 - xi[2]),
+				          1. / 8. * (1 - xi[0]) * (1 - xi[1]) * (1 + xi[2]),
+				          1. / 8. * (1 + xi[0]) * (1 - xi[1]) * (1 + xi[2]),
+				          1. / 8. * (1 + xi[0]) * (1 + xi[1]) * (1 + xi[2]),
+				          1. / 8. * (1 - xi[0]) * (1 + xi[1]) * (1 + xi[2]) }};
+			}
+
+			static constexpr Derivatives dN(const ReferencePoint& xi)
+			{
+				return {{ {{ -1. / 8. * (1 - xi[1]) * (1 - xi[2]), -1. / 8. * (1 - xi[0]) * (1 - xi[2]), -1. / 8. * (1 - xi[0]) * (1 - xi[1]) }},
+				          {{ 1. / 8. * (1 - xi[1]) * (1 - xi[2]), -1. / 8. * (1 + xi[0]) * (1 - xi[2]), -1. / 8. * (1 + xi[0]) * (1 - xi[1]) }},
+				          {{ 1. / 8. * (1 + xi[1]) * (1 - xi[2]), 1. / 8. * (1 + xi[0]) * (1 - xi[2]), -1. / 8. * (1 + xi[0]) * (1 + xi[1]) }},
+				          {{ -1. / 8. * (1 + xi[1]) * (1 - xi[2]), 1. / 8. * (1 - xi[0]) * (1 - xi[2]), -1. / 8. * (1 - xi[0]) * (1 + xi[1]) }},
+				          {{ -1. / 8. * (1 - xi[1]) * (1 + xi[2]), -1. / 8. * (1 - xi[0]) * (1 + xi[2]), 1. / 8. * (1 - xi[0]) * (1 - xi[1]) }},
+				          {{ 1. / 8. * (1 - xi[1]) * (1 + xi[2]), -1. / 8. * (1 + xi[0]) * (1 + xi[2]), 1. / 8. * (1 + xi[0]) * (1 - xi[1]) }},
+				          {{ 1. / 8. * (1 + xi[1]) * (1 + xi[2]), 1. / 8. * (1 + xi[0]) * (1 + xi[2]), 1. / 8. * (1 + xi[0]) * (1 + xi[1]) }},
+				          {{ -1. / 8. * (1 + xi[1]) * (1 + xi[2]), 1. / 8. * (1 - xi[0]) * (1 + xi[2]), 1. / 8. * (1 - xi[0]) * (1 + xi[1]) }} }};
+			}
+		};
+
+		//-------------------------------------------------------------------------------VTK_WEDGE
+
+		/**
+		 * \brief Triangle (vertices 0,1,2 and 3,4,5) extruded along xi_3 in [-1,1].
+		 * Three-point triangle rule times two-point Gauss rule.
+		 */
+		template <>
+		struct ShapeFunctions<ELEMENTS::TYPE::VTK_WEDGE>
+		{
+			static constexpr int nVertex = 6;
+			static constexpr int dimension = 3;
+			static constexpr int nGauss = 6;
+			typedef std::array<double, dimension> ReferencePoint;
+			typedef std::array<double, nVertex> Values;
+			typedef std::array<std::array<double, dimension>, nVertex> Derivatives;
+
+			static constexpr ReferencePoint center() { return {{ 1. / 3., 1. / 3., 0 }}; }
+			static constexpr ReferencePoint gaussPoint(int g)
+			{
+				constexpr double triangle[3][2] = { { 1. / 6., 1. / 6. },{ 2. / 3., 1. / 6. },{ 1. / 6., 2. / 3. } };
+				return {{ triangle[g % 3][0], triangle[g % 3][1], g < 3 ? -GAUSS_2 : GAUSS_2 }};
+			}
+			static constexpr double gaussWeight(int) { return 1. / 6.; }
+
+			static constexpr Values N(const ReferencePoint& xi)
+			{
+				return {{ 1. / 2. * (1 - xi[0] - xi[1]) * (1 - xi[2]),
+				          1. / 2. * xi[0] * (1 - xi[2]),
+				          1. / 2. * xi[1] * (1 - xi[2]),
+				          1. / 2. * (1 - xi[0] - xi[1]) * (1 + xi[2]),
+				          1. / 2. * xi[0] * (1 + xi[2]),
+				          1. / 2. * xi[1] * (1 + xi[2]) }};
+			}
+
+			static constexpr Derivatives dN(const ReferencePoint& xi)
+			{
+				return {{ {{ -1. / 2. * (1 - xi[2]), -1. / 2. * (1 - xi[2]), -1. / 2. * (1 - xi[0] - xi[1]) }},
+				          {{ 1. / 2. * (1 - xi[2]), 0, -1. / 2. * xi[0] }},
+				          {{ 0, 1. / 2. * (1 - xi[2]), -1. / 2. * xi[1] }},
+				          {{ -1. / 2. * (1 + xi[2]), -1. / 2. * (1 + xi[2]), 1. / 2. * (1 - xi[0] - xi[1]) }},
+				          {{ 1. / 2. * (1 + xi[2]), 0, 1. / 2. * xi[0] }},
+				          {{ 0, 1. / 2. * (1 + xi[2]), 1. / 2. * xi[1] }} }};
+			}
+		};
+
+		//-------------------------------------------------------------------------------VTK_PYRAMID
+
+		/**
+		 * \brief Hexahedron collapsed on its top face: base vertices 0..3 at xi_3 = -1, apex 4 at xi_3 = 1.
+		 * The 2x2x2 Gauss rule is exact, the center is the centroid of the reference pyramid.
+		 */
+		template <>
+		struct ShapeFunctions<ELEMENTS::TYPE::VTK_PYRAMID>
+		{
+			static constexpr int nVertex = 5;
+			static constexpr int dimension = 3;
+			static constexpr int nGauss = 8;
+			typedef std::array<double, dimension> ReferencePoint;
+			typedef std::array<double, nVertex> Values;
+			typedef std::array<std::array<double, dimension>, nVertex> Derivatives;
+
+			static constexpr ReferencePoint center() { return {{ 0, 0, -1. / 2. }}; }
+			static constexpr ReferencePoint gaussPoint(int g)
+			{
+				return ShapeFunctions<ELEMENTS::TYPE::VTK_HEXAHEDRON>::gaussPoint(g);
+			}
+			static constexpr double gaussWeight(int) { return 1.; }
+
+			static constexpr Values N(const ReferencePoint& xi)
+			{
+				return {{ 1. / 8. * (1 - xi[0]) * (1 - xi[1]) * (1 - xi[2]),
+				          1. / 8. * (1 + xi[0]) * (1 - xi[1]) * (1 - xi[2]),
+				          1. / 8. * (1 + xi[0]) * (1 + xi[1]) * (1 - xi[2]),
+				          1. / 8. * (1 - xi[0]) * (1 + xi[1]) * (1 - xi[2]),
+				          1. / 2. * (1 + xi[2]) }};
+			}
+
+			static constexpr Derivatives dN(const ReferencePoint& xi)
+			{
+				return {{ {{ -1. / 8. * (1 - xi[1]) * (1 - xi[2]), -1. / 8. * (1 - xi[0]) * (1 - xi[2]), -1. / 8. * (1 - xi[0]) * (1 - xi[1]) }},
+				          {{ 1. / 8. * (1 - xi[1]) * (1 - xi[2]), -1. / 8. * (1 + xi[0]) * (1 - xi[2]), -1. / 8. * (1 + xi[0]) * (1 - xi[1]) }},
+				          {{ 1. / 8. * (1 + xi[1]) * (1 - xi[2]), 1. / 8. * (1 + xi[0]) * (1 - xi[2]), -1. / 8. * (1 + xi[0]) * (1 + xi[1]) }},
+				          {{ -1. / 8. * (1 + xi[1]) * (1 - xi[2]), 1. / 8. * (1 - xi[0]) * (1 - xi[2]), -1. / 8. * (1 - xi[0]) * (1 + xi[1]) }},
+				          {{ 0, 0, 1. / 2. }} }};
+			}
+		};
+
+
+		/**
+		 * \brief Basis functions derivatives and weights at the Gauss points, basis functions and derivatives at the center.
+		 */
+		template <ELEMENTS::TYPE elementType>
+		struct GaussTable
+		{
+			typedef ShapeFunctions<elementType> Shape;
+			std::array<typename Shape::Derivatives, Shape::nGauss> dN;
+			std::array<double, Shape::nGauss> weight;
+			typename Shape::Values centerN;
+			typename Shape::Derivatives centerDN;
+		};
+
+		template <ELEMENTS::TYPE elementType, std::size_t... G>
+		constexpr GaussTable<elementType> MakeGaussTable(std::index_sequence<G...>)
+		{
+			typedef ShapeFunctions<elementType> Shape;
+			return { {{ Shape::dN(Shape::gaussPoint(G))... }}, {{ Shape::gaussWeight(G)... }}, Shape::N(Shape::center()), Shape::dN(Shape::center()) };
+		}
+
+		/**
+		 * \brief Gauss table of an element type, to be stored in a static constexpr variable so that it is built at compile time.
+		 */
+		template <ELEMENTS::TYPE elementType>
+		constexpr GaussTable<elementType> MakeGaussTable()
+		{
+			return MakeGaussTable<elementType>(std::make_index_sequence<ShapeFunctions<elementType>::nGauss>());
+		}
+
+	}
+
+}
@@ -19,6 +19,7 @@
 #include <map>
 #include "Parallel/Communicator.hpp"
 #include "Utils/Utils.hpp"
+#include "Utils/Statistics.hpp"
 #include "Adjacency/Adjacency.hpp"
 #include <algorithm>    // std::sort
 
@@ -50,8 +51,41 @@ namespace PAMELA
 		m_TypeMap[static_cast<int>(ECLIPSE_MESH_TYPE::VERTEX)] = ELEMENTS::TYPE::VTK_VERTEX;
 	}
 
+	std::vector<std::string> Eclipse_mesh::IncludedFiles(const File& file, const std::string& file_content)
+	{
+		std::vector<std::string> file_list;
+		std::istringstream mesh_file(file_content);
+		std::string line, buffer;
+		while (StringUtils::safeGetline(mesh_file, line))
+		{
+			StringUtils::RemoveStringAndFollowingContentFromLine("--", line);
+			StringUtils::RemoveExtraSpaces(line);
+			StringUtils::RemoveEndOfLine(line);
+			StringUtils::RemoveTab(line);
+			StringUtils::Trim(line);
+			if (line == "INCLUDE")
+			{
+				mesh_file >> buffer;
+				LOGINFO("---- Found Include file " + buffer + " found.");
+				buffer = StringUtils::RemoveString("'", buffer);
+				buffer = StringUtils::RemoveString("'", buffer);
+				buffer = StringUtils::RemoveString("/", buffer);
+				if (file.getDirectory().empty())
+				{
+					file_list.push_back(buffer);
+				}
+				else
+				{
+					file_list.push_back(file.getDirectory() + "/" + buffer);
+				}
+			}
+		}
+		return file_list;
+	}
+
 	Mesh* Eclipse_mesh::CreateMeshFromGRDECL(File file)
 	{
+		PAMELA_REGION("Eclipse_mesh::CreateMeshFromGRDECL");
 
 		//Init map
 		InitElementsMapping();
@@ -75,37 +109,12 @@ namespace PAMELA
 			ASSERT(mesh_file_.is_open(), file.getFullName() + " Could not be open");
 
 			//Seek for include files
-			std::istringstream mesh_file;
 			file_content = { std::istreambuf_iterator<char>(mesh_file_), std::istreambuf_iterator<char>() };
 			mesh_file_.close();
-			mesh_file.str(file_content);
-			std::string line, buffer;
-			while (StringUtils::safeGetline(mesh_file, line))
+			for (auto& path : IncludedFiles(file, file_content))
 			{
-				StringUtils::RemoveStringAndFollowingContentFromLine("--", line);
-				StringUtils::RemoveExtraSpaces(line);
-				StringUtils::RemoveEndOfLine(line);
-				StringUtils::RemoveTab(line);
-				StringUtils::Trim(line);
-				if (line == "INCLUDE")
-				{
-					mesh_file >> buffer;
-					LOGINFO("---- Found Include file " + buffer + " found.");
-					buffer = StringUtils::RemoveString("'", buffer);
-					buffer = StringUtils::RemoveString("'", buffer);
-					buffer = StringUtils::RemoveString("/", buffer);
-                                        std::string path;
-                                        if( file.getDirectory().empty() )
-                                        {
-                                          path = buffer;
-                                        }
-                                        else
-                                        {
-                                          path = file.getDirectory() + "/" + buffer;
-                                        }
-					file_list.push_back(path);
-					nfiles++;
-				}
+				file_list.push_back(path);
+				nfiles++;
 			}
 			mesh_file_.close();
 
@@ -226,6 +235,7 @@ namespace PAMELA
 
 	Mesh* Eclipse_mesh::CreateMeshFromEclipseBinaryFiles(File egrid_file)
 	{
+		PAMELA_REGION("Eclipse_mesh::CreateMeshFromEclipseBinaryFiles");
 
 		//Init map
 		InitElementsMapping();
@@ -320,18 +330,14 @@ namespace PAMELA
 		LOGINFO("*** Converting content into internal mesh format");
 		auto mesh = ConvertMesh();
 
-		//Create transmissibility from egrid/init
-		LOGINFO("*** Generating TPFA data structure from imported content");
-		CreateEclipseGeneratedTrans();
+		//Create transmissibility adjacency from egrid/init
+		LOGINFO("*** Generating TPFA adjacency graph");
+		CreateEclipseGeneratedTrans(mesh);
 
 		//Fill mesh with imported properties
 		LOGINFO("*** Filling mesh with imported properties");
 		FillMeshWithProperties(mesh);
 
-		//Create adjacency from TPFA data
-		LOGINFO("*** Generating TPFA adjacency graph");
-		CreateAdjacencyFromTPFAdata("PreProc", m_EclipseGeneratedTrans, mesh);
-
 		//Create NNC adjacency
 		LOGINFO("*** Generating NNCs adjacency graph");
 		CreateAdjacencyFromTPFAdata("NNCs", m_NNCs, mesh);
@@ -370,6 +376,11 @@ namespace PAMELA
 			m_ACTNUM = std::vector<int>(m_nTotalCells, 1);
 		}
 
+		m_Active2IJK.clear();
+		m_Active2IJK.reserve(m_nActiveCells);
+		m_IJK2Polyhedron.assign(m_nTotalCells, -1);
+		m_Polyhedron2IJK.clear();
+
 		int idx_over_all_hexas = 0;
 		int idx_over_active_hexas_only = 0;
         int n_valid_hexa_that_will_be_added_to_the_geosx_mesh = 0;
@@ -585,14 +596,14 @@ namespace PAMELA
                                     // This hexa is valid and will be added to the GEOSX mesh
                                     valid_hexa_for_the_geosx_mesh = true;
                                     n_valid_hexa_that_will_be_added_to_the_geosx_mesh++;
+                                    m_IJK2Polyhedron[idx_over_all_hexas] = static_cast<int>(m_Polyhedron2IJK.size());
+                                    m_Polyhedron2IJK.push_back(idx_over_all_hexas);
                                 }
                             }
                         }
 
                         // increments and maps of indices
-                        m_IndexTotal2Active[idx_over_all_hexas] = idx_over_active_hexas_only;
-						m_IJK2Index[IJK(i,j,k)] = idx_over_active_hexas_only;
-						m_Index2IJK[idx_over_active_hexas_only] = IJK(i, j, k);
+						m_Active2IJK.push_back(idx_over_all_hexas);
 						idx_over_active_hexas_only++;
                     }
                     
@@ -650,12 +661,12 @@ namespace PAMELA
 			}
 		}
 
-		//--Delete NNC on inactive blocks
+		//--Delete NNC on blocks that are not in the mesh (inactive, flat, ill-shaped or duplicated)
 		temp_int.clear();
 		
 		for(unsigned int i=0;i!=m_NNCs.size();++i)
 		{
-			if (m_ACTNUM[m_NNCs[i].downstream_index]==1&& m_ACTNUM[m_NNCs[i].upstream_index]==1)
+			if (m_IJK2Polyhedron[m_NNCs[i].downstream_index] >= 0 && m_IJK2Polyhedron[m_NNCs[i].upstream_index] >= 0)
 			{
 				temp_int.push_back(i);
 			}
@@ -669,8 +680,8 @@ namespace PAMELA
 		m_NNCs = temp_NNC;
 		for (auto it = m_NNCs.begin(); it != m_NNCs.end(); ++it)
 		{
-			it->downstream_index = m_IndexTotal2Active.at(it->downstream_index);
-			it->upstream_index = m_IndexTotal2Active.at(it->upstream_index);
+			it->downstream_index = m_IJK2Polyhedron[it->downstream_index];
+			it->upstream_index = m_IJK2Polyhedron[it->upstream_index];
 		}
 
 		LOGINFO(std::to_string(m_nTotalCells) + "  total GRDECL hexas");
@@ -1102,6 +1113,7 @@ namespace PAMELA
 				last_rowptr = csr_mat->rowPtr[irow + 1];
 				csr_mat->columnIndex.push_back(icol);
 				csr_mat->values.push_back(1);
+				new_adj->get_Weights().push_back(data[i].transmissibility);
 				csr_mat->nnz++;
 			}
 			std::fill(csr_mat->rowPtr.begin() + last_irow + 1, csr_mat->rowPtr.end(), last_rowptr);
@@ -1111,69 +1123,114 @@ namespace PAMELA
 
 	}
 
-	void Eclipse_mesh::CreateEclipseGeneratedTrans()
+	int Eclipse_mesh::get_PolyhedronIndex(int i, int j, int k) const
 	{
-
-		if (!m_CellProperties_double.at("TRANX").empty())
+		int nx = static_cast<int>(m_SPECGRID[0]), ny = static_cast<int>(m_SPECGRID[1]), nz = static_cast<int>(m_SPECGRID[2]);
+		std::string ijk = "(" + std::to_string(i + 1) + "," + std::to_string(j + 1) + "," + std::to_string(k + 1) + ")";
+		if (i < 0 || i >= nx || j < 0 || j >= ny || k < 0 || k >= nz)
 		{
-			ASSERT(m_CellProperties_double.at("TRANX").size() == m_CellProperties_double.at("TRANY").size() && m_CellProperties_double.at("TRANY").size() == m_CellProperties_double.at("TRANZ").size(), "Size mismatch");
+			LOGERROR("Cell " + ijk + " is out of the grid bounds");
+		}
+		int index = m_IJK2Polyhedron[i + nx * (j + ny * k)];
+		if (index < 0)
+		{
+			LOGERROR("Cell " + ijk + " is not in the mesh (inactive, flat, ill-shaped or duplicated)");
+		}
+		return index;
+	}
 
-			auto ntran = static_cast<int>(m_CellProperties_double.at("TRANX").size());
-			auto& tranx = m_CellProperties_double.at("TRANX");
+	void Eclipse_mesh::CreateEclipseGeneratedTrans(Mesh* mesh)
+	{
+		typedef CSRMatrix::offset_type offset_type;
+		typedef CSRMatrix::index_type index_type;
+
+		auto new_adj = new Adjacency(ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::FAMILY::UNKNOWN, mesh->get_PolyhedronCollection(), mesh->get_PolyhedronCollection(), nullptr);
+		auto csr_mat = new_adj->get_adjacencySparseMatrix();
+		auto nb_polyhedron = static_cast<index_type>(mesh->get_PolyhedronCollection()->size_all());
+		csr_mat->fillEmpty(nb_polyhedron, nb_polyhedron);
+
+		auto itx = m_CellProperties_double.find("TRANX");
+		if ((itx != m_CellProperties_double.end()) && (!itx->second.empty()))
+		{
+			auto& tranx = itx->second;
 			auto& trany = m_CellProperties_double.at("TRANY");
 			auto& tranz = m_CellProperties_double.at("TRANZ");
+			ASSERT(tranx.size() == trany.size() && trany.size() == tranz.size(), "Size mismatch");
+			int nx = static_cast<int>(m_SPECGRID[0]), ny = static_cast<int>(m_SPECGRID[1]), nz = static_cast<int>(m_SPECGRID[2]);
 
-			TPFA temp_TPFA;
-			for (auto i = 0; i != ntran; ++i)
-			{
-				auto ijk = m_Index2IJK.at(i);
+			ASSERT(m_Polyhedron2IJK.size() == static_cast<std::size_t>(nb_polyhedron), "Polyhedra and valid hexas mismatch");
 
-				//X
-				if (tranx[i]>0)
+			//Transmissibilities are given per active cell, including the hexas dropped while building the mesh,
+			//unless every cell is active, in which case they have been restricted to the polyhedra with the other properties
+			bool perPolyhedron = (tranx.size() != m_Active2IJK.size()) && (tranx.size() == static_cast<std::size_t>(nb_polyhedron));
+			auto& tran2IJK = perPolyhedron ? m_Polyhedron2IJK : m_Active2IJK;
+			if (tranx.size() != tran2IJK.size())
+			{
+				LOGWARNING(std::to_string(tranx.size()) + " transmissibilities for " + std::to_string(m_Active2IJK.size()) + " active cells");
+			}
+			auto ntran = static_cast<int>(std::min(tranx.size(), tran2IJK.size()));
+
+			//Neighbour polyhedron in the +I, +J and +K directions of each polyhedron, -1 if there is no connection
+			const std::vector<double>* trans[3] = { &tranx, &trany, &tranz };
+			const int stride[3] = { 1, nx, nx * ny };
+			const int dim[3] = { nx, ny, nz };
+			std::vector<index_type> neighbour[3];
+			std::vector<double> neighbourTrans[3];
+			for (int d = 0; d != 3; ++d)
+			{
+				neighbour[d].assign(nb_polyhedron, -1);
+				neighbourTrans[d].assign(nb_polyhedron, 0.);
+			}
+			for (int i = 0; i != ntran; ++i)
+			{
+				int ijk = tran2IJK[i];
+				auto polyhedron = m_IJK2Polyhedron[ijk];
+				if (polyhedron < 0)
 				{
-					ijk.I = ijk.I + 1;
-					if (m_IJK2Index.find(ijk) != m_IJK2Index.end())
-					{
-						temp_TPFA.downstream_index = i;
-						temp_TPFA.upstream_index = m_IJK2Index.at(ijk);
-						temp_TPFA.transmissibility = tranx[i];
-						m_EclipseGeneratedTrans.push_back(temp_TPFA);
-					}
-					ijk.I = ijk.I - 1;
+					continue;
 				}
-				
-				//Y
-				if (tranx[i] > 0)
+				for (int d = 0; d != 3; ++d)
 				{
-					ijk.J = ijk.J + 1;
-					if (m_IJK2Index.find(ijk) != m_IJK2Index.end())
+					auto tran = (*trans[d])[i];
+					bool inside = (ijk / stride[d]) % dim[d] != dim[d] - 1;
+					if (inside && tran > 0)
 					{
-						temp_TPFA.downstream_index = i;
-						temp_TPFA.upstream_index = m_IJK2Index.at(ijk);
-						temp_TPFA.transmissibility = trany[i];
-						m_EclipseGeneratedTrans.push_back(temp_TPFA);
+						neighbour[d][polyhedron] = m_IJK2Polyhedron[ijk + stride[d]];
+						neighbourTrans[d][polyhedron] = tran;
 					}
-					ijk.J = ijk.J - 1;
 				}
+			}
 
-				//Z
-				if (tranx[i] > 0)
+			//Row sizes, then connections emitted in place. Polyhedra are numbered along I+nx*(J+ny*K), so rows are sorted.
+			auto& rowPtr = csr_mat->rowPtr;
+			rowPtr[0] = 0;
+			for (index_type i = 0; i != nb_polyhedron; ++i)
+			{
+				rowPtr[i + 1] = rowPtr[i] + (neighbour[0][i] >= 0) + (neighbour[1][i] >= 0) + (neighbour[2][i] >= 0);
+			}
+
+			auto nnz = rowPtr[nb_polyhedron];
+			csr_mat->columnIndex.resize(nnz);
+			csr_mat->values.assign(nnz, 1);
+			auto& weights = new_adj->get_Weights();
+			weights.resize(nnz);
+			for (index_type i = 0; i != nb_polyhedron; ++i)
+			{
+				offset_type j = rowPtr[i];
+				for (int d = 0; d != 3; ++d)
 				{
-					ijk.K = ijk.K + 1;
-					if (m_IJK2Index.find(ijk) != m_IJK2Index.end())
+					if (neighbour[d][i] >= 0)
 					{
-						temp_TPFA.downstream_index = i;
-						temp_TPFA.upstream_index = m_IJK2Index.at(ijk);
-						temp_TPFA.transmissibility = tranz[i];
-						m_EclipseGeneratedTrans.push_back(temp_TPFA);
+						csr_mat->columnIndex[j] = neighbour[d][i];
+						weights[j++] = neighbourTrans[d][i];
 					}
-					ijk.K = ijk.K - 1;
 				}
 			}
-
+			csr_mat->nnz = nnz;
+			csr_mat->checkMatrix();
 		}
+		mesh->getAdjacencySet()->Add_NonTopologicalAdjacency("PreProc", new_adj);
 
-		
 	}
 
         void Eclipse_mesh::ProcessWells(const std::string& suffix)
@@ -1214,7 +1271,7 @@ namespace PAMELA
             }
             label = label + "_" + std::to_string(iw);
 
-            auto icell = m_IJK2Index.at(IJK(sub_iwel[0]-1, sub_iwel[1]-1, sub_iwel[2]-1));
+            auto icell = get_PolyhedronIndex(sub_iwel[0]-1, sub_iwel[1]-1, sub_iwel[2]-1);
             auto nb_comp = sub_iwel[4];
             auto well = m_Wells[label] = new WELL(icell,nb_comp);
             std::vector<double> sub_scon(&scon[0 + iw * ncwmax * nsconz], &scon[(iw + 1)*(ncwmax * nsconz - 1)]);
@@ -1225,7 +1282,7 @@ namespace PAMELA
               std::vector<int> sub_sub_icon(&sub_icon[0 + ic * niconz], &sub_icon[(ic + 1)*(niconz - 1)]);
               auto cf = sub_sub_scon[0];
               auto kh = sub_sub_scon[3];
-              auto icell_comp = m_IJK2Index.at(IJK(sub_sub_icon[1] - 1, sub_sub_icon[2] - 1, sub_sub_icon[3] - 1));
+              auto icell_comp = get_PolyhedronIndex(sub_sub_icon[1] - 1, sub_sub_icon[2] - 1, sub_sub_icon[3] - 1);
               well->completions.push_back(COMPLETION(icell_comp, cf, kh));
             }
 
@@ -1249,22 +1306,18 @@ namespace PAMELA
           }
 
           //Create line and point groups
-          auto polyhedron_collection = mesh->get_PolyhedronCollection();
+          const auto& cellGeometry = mesh->get_PolyhedronGeometry();
           for (auto itw=m_Wells.begin(); itw != m_Wells.end();++itw)
           {
             std::vector<Point*> vecpoint;
             auto well = itw->second;
             auto hcindex = well->head_cell_index;
-            auto itpol = polyhedron_collection->begin_owned() + hcindex;
-            auto xyz = (*itpol)->get_centroidCoordinates();
-            vecpoint.push_back(ElementFactory::makePoint(ELEMENTS::TYPE::VTK_VERTEX, -1, xyz[0], xyz[1], 0));
+            vecpoint.push_back(ElementFactory::makePoint(mesh->get_ElementArena(), ELEMENTS::TYPE::VTK_VERTEX, -1, cellGeometry.centroidX[hcindex], cellGeometry.centroidY[hcindex], 0));
             auto comps = well->completions;
             for (unsigned int ic = 0; ic != well->nb_completions; ++ic)
             {
               auto cell_index = comps[ic].hosting_cell_index;
-              auto itpol2 = polyhedron_collection->begin_owned() + cell_index;
-              auto xyz2 = (*itpol2)->get_centroidCoordinates();
-              vecpoint.push_back(ElementFactory::makePoint(ELEMENTS::TYPE::VTK_VERTEX, -1, xyz2[0], xyz2[1], xyz2[2]));
+              vecpoint.push_back(ElementFactory::makePoint(mesh->get_ElementArena(), ELEMENTS::TYPE::VTK_VERTEX, -1, cellGeometry.centroidX[cell_index], cellGeometry.centroidY[cell_index], cellGeometry.centroidZ[cell_index]));
             }
             mesh->AddImplicitLine(ELEMENTS::TYPE::VTK_LINE, itw->first, vecpoint);
             mesh->get_ImplicitLineCollection()->MakeActiveGroup(itw->first);
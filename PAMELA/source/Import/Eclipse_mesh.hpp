@@ -33,6 +33,9 @@ namespace PAMELA
       Mesh* CreateMeshFromGRDECL(File file);
       Mesh* CreateMeshFromEclipseBinaryFiles(File file);
 
+      //Paths of the files included (INCLUDE keyword) by a GRDECL deck of the given content
+      static std::vector<std::string> IncludedFiles(const File& file, const std::string& file_content);
+
     private:
       int CountUniqueVertices(std::vector<double>, std::vector<double>, std::vector<double>);
       void ParseStringFromGRDECL(std::string& str);
@@ -47,25 +50,6 @@ namespace PAMELA
       std::string m_label {""};
 
       ///Eclipse file data
-      struct IJK
-      {
-        IJK() { I = -1; J = -1; K = -1; }
-        IJK(int i, int j, int k) { I = i; J = j; K = k; }
-        bool operator==(IJK const& other) const { return ((*this).I == other.I)&((*this).J == other.J)&((*this).K == other.K); }
-        int I;
-        int J;
-        int K;
-
-      };
-
-      struct IJKHash
-      {
-        std::size_t operator()(const IJK& ele) const
-        {
-          return ele.I+ ele.J*100000+ ele.K*1000000;
-        }
-      };
-
       struct TPFA
       {
         bool operator<(TPFA const& other) const
@@ -122,10 +106,9 @@ namespace PAMELA
       std::vector<int>  m_ACTNUM {};
 
       std::vector<TPFA>  m_NNCs {};
-      std::vector<TPFA>  m_EclipseGeneratedTrans {};
-      std::unordered_map<IJK,unsigned int, IJKHash> m_IJK2Index {};
-      std::unordered_map<unsigned int,IJK> m_Index2IJK {};
-      std::unordered_map<unsigned int, unsigned int> m_IndexTotal2Active {};
+      std::vector<int> m_Active2IJK {};
+      std::vector<int> m_IJK2Polyhedron {}; //Polyhedron of each I+nx*(J+ny*K) cell, -1 if the hexa was not added to the mesh
+      std::vector<int> m_Polyhedron2IJK {};
 
       unsigned int m_nCOORD {0};
       unsigned int m_nZCORN {0};
@@ -177,7 +160,8 @@ namespace PAMELA
         }
 
       void CreateAdjacencyFromTPFAdata(std::string label, std::vector<TPFA>& data, Mesh* mesh);
-      void CreateEclipseGeneratedTrans();
+      void CreateEclipseGeneratedTrans(Mesh* mesh);
+      int get_PolyhedronIndex(int i, int j, int k) const;
 
       void CreateWellAndCompletion(Mesh* mesh);
   };
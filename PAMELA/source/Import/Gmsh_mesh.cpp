@@ -18,11 +18,13 @@
 #include "Elements/Element.hpp"
 #include <map>
 #include "Parallel/Communicator.hpp"
+#include "Utils/Statistics.hpp"
 
 namespace PAMELA
 {
 	Mesh* Gmsh_mesh::CreateMesh(std::string file_path)
 	{
+		PAMELA_REGION("Gmsh_mesh::CreateMesh");
 
 		//MPI
 		auto irank = Communicator::worldRank();
@@ -18,6 +18,7 @@
 #include "Elements/Element.hpp"
 #include <map>
 #include "Parallel/Communicator.hpp"
+#include "Utils/Statistics.hpp"
 
 namespace PAMELA
 {
@@ -33,6 +34,7 @@ namespace PAMELA
 
   Mesh* INRIA_mesh::CreateMesh(std::string file_path)
   {
+    PAMELA_REGION("INRIA_mesh::CreateMesh");
 
     //MPI
     auto irank = Communicator::worldRank();
@@ -357,6 +357,8 @@ namespace PAMELA
 			}
 		}
 
+		InvalidateGeometry();
+
 		LOGINFO("*** Done...");
 	}
 
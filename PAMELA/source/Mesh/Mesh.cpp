@@ -21,10 +21,43 @@
 #include <metis.h>
 #endif
 #include <algorithm>  
+#include <limits>
 #include "Utils/VectorUtils.hpp"
+#include "Utils/ThreadUtils.hpp"
+#include "Mesh/Transmissibility.hpp"
+#include "Mesh/MeshCheckpoint.hpp"
+#include "Utils/Statistics.hpp"
 
 namespace PAMELA
 {
+#ifdef WITH_METIS
+  namespace
+  {
+    // Hand a CSR array to METIS. Copies only if the CSR types differ from METIS's idx_t,
+    // failing if a value does not fit in idx_t rather than letting it wrap.
+    template<typename T>
+    ::idx_t* MetisArray(std::vector<T>& array, std::vector<::idx_t>& buffer)
+    {
+      if (!array.empty())
+      {
+        auto range = std::minmax_element(array.begin(), array.end());
+        if (static_cast<long double>(*range.first) < static_cast<long double>(std::numeric_limits<::idx_t>::min())
+          || static_cast<long double>(*range.second) > static_cast<long double>(std::numeric_limits<::idx_t>::max()))
+        {
+          LOGERROR("CSR values out of the range of METIS idx_t, build METIS with IDXTYPEWIDTH=64");
+        }
+      }
+      buffer.assign(array.begin(), array.end());
+      return buffer.data();
+    }
+
+    ::idx_t* MetisArray(std::vector<::idx_t>& array, std::vector<::idx_t>& /*buffer*/)
+    {
+      return array.data();
+    }
+  }
+#endif
+
   Mesh::~Mesh()
   {
     delete m_PolyhedronProperty_double;
@@ -46,6 +79,7 @@ namespace PAMELA
 
   void Mesh::CreateFacesFromCells()
   {
+    PAMELA_REGION("Mesh::CreateFacesFromCells");
 
     LOGINFO("*** Creating Polygons from Polyhedra...");
 
@@ -67,11 +101,15 @@ namespace PAMELA
     {
       Polyhedron* polyhedron = *it;
       PolyhedronIndex = polyhedron->get_localIndex();
-      auto faces = polyhedron->CreateFaces();
+      auto faces = polyhedron->CreateFaces(m_ElementArena);
       nbFace = static_cast<int>(faces.size());
       for (int j = 0; j < nbFace; j++)
       {
         auto returned_polygon = target->push_back_unique(faces[j]);
+        if (!returned_polygon.second)
+        {
+          m_ElementArena.Release(faces[j]);
+        }
         FaceIndex = returned_polygon.first->get_localIndex();
         adj->m_adjacencySparseMatrix->columnIndex.push_back(FaceIndex);
         adj->m_adjacencySparseMatrix->values.push_back(PolyhedronIndex);
@@ -86,7 +124,7 @@ namespace PAMELA
     adj->m_adjacencySparseMatrix->checkMatrix();
 
     //Add to map
-    m_AdjacencySet->TopologicalAdjacencyMap[std::make_tuple(source->get_family(), target->get_family(), base->get_family())] = adj;
+    m_AdjacencySet->Add_TopologicalAdjacency(adj);
 
     //
     LOGINFO(std::to_string(target->size_all() - InitPolyhedronCollectionSize) + " polygons have been created");
@@ -94,13 +132,200 @@ namespace PAMELA
   }
 
 
+  void Mesh::CreateEdgesFromCells()
+  {
+    PAMELA_REGION("Mesh::CreateEdgesFromCells");
+
+    LOGINFO("*** Creating Lines from Polyhedra and Polygons...");
+
+    using offset_type = CSRMatrix::offset_type;
+    using index_type = CSRMatrix::index_type;
+
+    PolyhedronCollection* polyhedra = &m_PolyhedronCollection;
+    PolygonCollection* polygons = &m_PolygonCollection;
+    LineCollection* lines = &m_LineCollection;
+    auto nPolyhedra = static_cast<index_type>(polyhedra->size_all());
+    auto nPolygons = static_cast<index_type>(polygons->size_all());
+    auto nPoints = static_cast<index_type>(m_PointCollection.size_all());
+    auto nElements = nPolyhedra + nPolygons;
+    auto InitLineCollectionSize = lines->size_all();
+
+    //Element to edge end points matrix: one row per polyhedron then per polygon, one entry per local edge
+    //with the lowest vertex as column and the highest as value
+    CSRMatrix elementEdges(nElements, nPoints);
+    auto& rowPtr = elementEdges.rowPtr;
+    for (index_type i = 0; i < nPolyhedra; ++i)
+    {
+      rowPtr[i + 1] = rowPtr[i] + static_cast<offset_type>((*polyhedra)[i]->get_LocalEdges().size());
+    }
+    for (index_type i = 0; i < nPolygons; ++i)
+    {
+      rowPtr[nPolyhedra + i + 1] = rowPtr[nPolyhedra + i] + static_cast<offset_type>((*polygons)[i]->get_vertexList().size());
+    }
+    elementEdges.nnz = rowPtr[nElements];
+    int nThreads = elementEdges.nnz >= (1 << 20) ? threadUtils::NumberOfThreads() : 1;
+    elementEdges.columnIndex.resize(elementEdges.nnz);
+    elementEdges.values.resize(elementEdges.nnz);
+
+    threadUtils::ParallelChunks(nElements, nThreads, [&](int, index_type begin, index_type end)
+    {
+      auto addEdge = [&](offset_type slot, Point* a, Point* b)
+      {
+        index_type ia = a->get_localIndex();
+        index_type ib = b->get_localIndex();
+        elementEdges.columnIndex[slot] = std::min(ia, ib);
+        elementEdges.values[slot] = std::max(ia, ib);
+      };
+      for (index_type i = begin; i < end; ++i)
+      {
+        offset_type slot = rowPtr[i];
+        if (i < nPolyhedra)
+        {
+          auto& vertexList = (*polyhedra)[i]->get_vertexList();
+          for (auto& edge : (*polyhedra)[i]->get_LocalEdges())
+          {
+            addEdge(slot++, vertexList[edge.first], vertexList[edge.second]);
+          }
+        }
+        else
+        {
+          auto& vertexList = (*polygons)[i - nPolyhedra]->get_vertexList();
+          auto nbVertex = vertexList.size();
+          for (size_t j = 0; j != nbVertex; ++j)
+          {
+            addEdge(slot++, vertexList[j], vertexList[(j + 1) % nbVertex]);
+          }
+        }
+      }
+    });
+    elementEdges.sortRowIndexAndMoveValues();
+
+    //Bucket the edges by lowest vertex, then keep the distinct highest vertices of each bucket.
+    //Edges are numbered by (lowest, highest) vertex.
+    std::vector<offset_type> vertexEdgeStart(nPoints + 1, 0);
+    std::vector<index_type> edgeHigh;
+    {
+      CSRMatrix* vertexEdges = CSRMatrix::transpose(&elementEdges);
+      auto& bucketStart = vertexEdges->rowPtr;
+      auto& high = vertexEdges->values;
+      threadUtils::ParallelChunks(nPoints, nThreads, [&](int, index_type begin, index_type end)
+      {
+        for (index_type v = begin; v < end; ++v)
+        {
+          auto first = high.begin() + bucketStart[v];
+          auto last = high.begin() + bucketStart[v + 1];
+          std::sort(first, last);
+          vertexEdgeStart[v + 1] = std::unique(first, last) - first;
+        }
+      });
+      for (index_type v = 0; v < nPoints; ++v)
+      {
+        vertexEdgeStart[v + 1] += vertexEdgeStart[v];
+      }
+      edgeHigh.resize(vertexEdgeStart[nPoints]);
+      threadUtils::ParallelChunks(nPoints, nThreads, [&](int, index_type begin, index_type end)
+      {
+        for (index_type v = begin; v < end; ++v)
+        {
+          std::copy(high.begin() + bucketStart[v], high.begin() + bucketStart[v] + (vertexEdgeStart[v + 1] - vertexEdgeStart[v]), edgeHigh.begin() + vertexEdgeStart[v]);
+        }
+      });
+      delete vertexEdges;
+    }
+
+    //Create the lines. Lines already in the collection (e.g. from the importer) are reused.
+    std::vector<index_type> edgeToLine(edgeHigh.size(), -1);
+    for (index_type v = 0; v < nPoints; ++v)
+    {
+      for (offset_type edge = vertexEdgeStart[v]; edge < vertexEdgeStart[v + 1]; ++edge)
+      {
+        if (edgeHigh[edge] == v)
+        {
+          continue; //collapsed edge of a degenerated element
+        }
+        Line* line = ElementFactory::makeLine(m_ElementArena, ELEMENTS::TYPE::VTK_LINE, -1, { m_PointCollection[v], m_PointCollection[edgeHigh[edge]] });
+        auto returned_line = lines->push_back_unique(line);
+        if (!returned_line.second)
+        {
+          m_ElementArena.Release(line);
+        }
+        edgeToLine[edge] = returned_line.first->get_localIndex();
+      }
+    }
+
+    //Element to line adjacencies
+    auto nLines = static_cast<index_type>(lines->size_all());
+    auto buildAdjacency = [&](ELEMENTS::FAMILY family, ParallelEnsembleBase* source, index_type firstRow, index_type nRows)
+    {
+      Adjacency* adj = new Adjacency(family, ELEMENTS::FAMILY::LINE, family, source, lines, source);
+      auto csr_mat = adj->get_adjacencySparseMatrix();
+      std::vector<offset_type> rowSize(nRows + 1, 0);
+      std::vector<index_type> lineIndex(rowPtr[firstRow + nRows] - rowPtr[firstRow]);
+
+      //Map to lines, dropping collapsed and repeated edges
+      threadUtils::ParallelChunks(nRows, nThreads, [&](int, index_type begin, index_type end)
+      {
+        for (index_type i = begin; i < end; ++i)
+        {
+          auto first = lineIndex.begin() + (rowPtr[firstRow + i] - rowPtr[firstRow]);
+          auto last = first;
+          for (offset_type slot = rowPtr[firstRow + i]; slot < rowPtr[firstRow + i + 1]; ++slot)
+          {
+            index_type low = elementEdges.columnIndex[slot];
+            auto bucketFirst = edgeHigh.begin() + vertexEdgeStart[low];
+            auto bucketLast = edgeHigh.begin() + vertexEdgeStart[low + 1];
+            auto edge = std::lower_bound(bucketFirst, bucketLast, elementEdges.values[slot]) - edgeHigh.begin();
+            if (edgeToLine[edge] != -1)
+            {
+              *last++ = edgeToLine[edge];
+            }
+          }
+          std::sort(first, last);
+          rowSize[i + 1] = std::unique(first, last) - first;
+        }
+      });
+
+      for (index_type i = 0; i < nRows; ++i)
+      {
+        rowSize[i + 1] += rowSize[i];
+      }
+      csr_mat->nnz = rowSize[nRows];
+      csr_mat->dimColumn = csr_mat->dimColumn_owned = nLines;
+      csr_mat->columnIndex.resize(csr_mat->nnz);
+      csr_mat->values.resize(csr_mat->nnz);
+      threadUtils::ParallelChunks(nRows, nThreads, [&](int, index_type begin, index_type end)
+      {
+        for (index_type i = begin; i < end; ++i)
+        {
+          auto first = lineIndex.begin() + (rowPtr[firstRow + i] - rowPtr[firstRow]);
+          std::copy(first, first + (rowSize[i + 1] - rowSize[i]), csr_mat->columnIndex.begin() + rowSize[i]);
+          std::fill(csr_mat->values.begin() + rowSize[i], csr_mat->values.begin() + rowSize[i + 1], i);
+          csr_mat->rowPtr[i + 1] = rowSize[i + 1];
+        }
+      });
+      csr_mat->checkMatrix();
+      return adj;
+    };
+
+    m_AdjacencySet->Add_TopologicalAdjacency(buildAdjacency(ELEMENTS::FAMILY::POLYHEDRON, polyhedra, 0, nPolyhedra));
+    m_AdjacencySet->Add_TopologicalAdjacency(buildAdjacency(ELEMENTS::FAMILY::POLYGON, polygons, nPolyhedra, nPolygons));
+
+    //
+    LOGINFO(std::to_string(lines->size_all() - InitLineCollectionSize) + " lines have been created");
+    LOGINFO("*** Done");
+  }
+
+
   std::pair< Point*, bool > Mesh::addPoint(ELEMENTS::TYPE elementType, int index, std::string groupLabel, double x, double y, double z)
   {
-    Point* element = ElementFactory::makePoint(elementType, index, x, y, z);
+    Point* element = ElementFactory::makePoint(m_ElementArena, elementType, index, x, y, z);
     auto returnedElement = m_PointCollection.AddElement(groupLabel, element);
+    m_AdjacencySet->InvalidateTopologicalAdjacencies(ELEMENTS::FAMILY::POINT);
+    m_Geometry.Invalidate();
     if (!returnedElement.second)
     {
       //LOGWARNING("Try to add an existing element");
+      m_ElementArena.Release(element);
     }
     return returnedElement;
   }
@@ -108,6 +333,8 @@ namespace PAMELA
   std::pair<Point*, bool > Mesh::addPoint(std::string groupLabel, Point* point)
   {
     auto returnedElement = m_PointCollection.AddElement(groupLabel, point);
+    m_AdjacencySet->InvalidateTopologicalAdjacencies(ELEMENTS::FAMILY::POINT);
+    m_Geometry.Invalidate();
     if (returnedElement.second)
     {
       //LOGWARNING("Try to add an existing element");
@@ -117,33 +344,41 @@ namespace PAMELA
 
   std::pair< Line*, bool> Mesh::addLine(ELEMENTS::TYPE elementType, int elementIndex, std::string groupLabel, const std::vector<Point*>& vertexList)
   {
-    Line* element = ElementFactory::makeLine(elementType, elementIndex, vertexList);
+    Line* element = ElementFactory::makeLine(m_ElementArena, elementType, elementIndex, vertexList);
     auto returnedElement = m_LineCollection.AddElement(groupLabel, element);
+    m_AdjacencySet->InvalidateTopologicalAdjacencies(ELEMENTS::FAMILY::LINE);
     if (!returnedElement.second)
     {
       //LOGWARNING("Try to add an existing element");
+      m_ElementArena.Release(element);
     }
     return returnedElement;
   }
 
   std::pair< Polygon*, bool > Mesh::addPolygon(ELEMENTS::TYPE elementType, int elementIndex, std::string groupLabel, const std::vector<Point*>& vertexList)
   {
-    Polygon* element = ElementFactory::makePolygon(elementType, elementIndex, vertexList);
+    Polygon* element = ElementFactory::makePolygon(m_ElementArena, elementType, elementIndex, vertexList);
     auto returnedElement = m_PolygonCollection.AddElement(groupLabel, element);
+    m_AdjacencySet->InvalidateTopologicalAdjacencies(ELEMENTS::FAMILY::POLYGON);
+    m_Geometry.Invalidate();
     if ( !returnedElement.second )
     {
       //LOGWARNING("Try to add an existing element");
+      m_ElementArena.Release(element);
     }
     return returnedElement;
   }
 
   std::pair< Polyhedron*, bool> Mesh::addPolyhedron(ELEMENTS::TYPE elementType, int elementIndex, std::string groupLabel, const std::vector<Point*>& vertexList)
   {
-    Polyhedron* element = ElementFactory::makePolyhedron(elementType, elementIndex, vertexList);
+    Polyhedron* element = ElementFactory::makePolyhedron(m_ElementArena, elementType, elementIndex, vertexList);
     auto returnedElement = m_PolyhedronCollection.AddElement(groupLabel, element);
+    m_AdjacencySet->InvalidateTopologicalAdjacencies(ELEMENTS::FAMILY::POLYHEDRON);
+    m_Geometry.Invalidate();
     if ( !returnedElement.second)
     {
       //LOGWARNING("Try to add an existing polyhedron");
+      m_ElementArena.Release(element);
     }
     return returnedElement;
 
@@ -157,14 +392,18 @@ namespace PAMELA
     for (size_t i=1;i!= pointList.size();++i)
     {
       m_ImplicitPointCollection.AddElement(groupLabel, pointList[i]);
-      Line* element = ElementFactory::makeLine(ELEMENTS::TYPE::VTK_LINE, -1, { pointList[i-1],pointList[i] });
-      m_ImplicitLineCollection.AddElement(groupLabel, element);
+      Line* element = ElementFactory::makeLine(m_ElementArena, ELEMENTS::TYPE::VTK_LINE, -1, { pointList[i-1],pointList[i] });
+      if (!m_ImplicitLineCollection.AddElement(groupLabel, element).second)
+      {
+        m_ElementArena.Release(element);
+      }
     }
   }
 
 
   void Mesh::PerformPolyhedronPartitioning(ELEMENTS::FAMILY edgeElement, ELEMENTS::FAMILY ghostBaseElement)
   {
+    PAMELA_REGION("Mesh::PerformPolyhedronPartitioning");
     //MPI data
     auto CommRankSize = Communicator::worldSize();
     bool MPIRUN = Communicator::isMPIrun();
@@ -174,6 +413,7 @@ namespace PAMELA
     //{
 
     LOGINFO("*** Perform partitioning...");
+    LogMemoryFootprint("before partitioning");
 
     //This is a cell partitioning
     ELEMENTS::FAMILY nodeElement = ELEMENTS::FAMILY::POLYHEDRON;
@@ -222,6 +462,7 @@ namespace PAMELA
       if (PolyhedronAffiliation[i] == ipartition)
       {
         PolyhedronOwned.insert(static_cast<int>(i));
+        m_PolyhedronCollection[i]->set_partionOwner(ipartition);
         ind++;
       }
     }
@@ -235,6 +476,7 @@ namespace PAMELA
         if (PolyhedronAffiliation[*it2] != ipartition)
         {
           PolyhedronGhost.insert(*it2);
+          m_PolyhedronCollection[*it2]->set_partionOwner(PolyhedronAffiliation[*it2]);
           m_neighborList.insert(PolyhedronAffiliation[*it2]);
         }
       }
@@ -257,11 +499,13 @@ namespace PAMELA
         {
           //All points connect to polyhedra of the current partition
           PolygonOwned.insert(adj_Polyhedron2Polygon.first[i]);
+          m_PolygonCollection[adj_Polyhedron2Polygon.first[i]]->set_partionOwner(ipartition);
         }
         else
         {
 
           int ival = CoinToss(PolyToPart[0], PolyToPart[1]);
+          m_PolygonCollection[adj_Polyhedron2Polygon.first[i]]->set_partionOwner(ival);
 
           if (ival == ipartition)
           {
@@ -291,10 +535,12 @@ namespace PAMELA
         {
           //All points connect to polyhedra of the current partition
           PointOwned.insert(adj_Poly2Point.first[i]);
+          m_PointCollection[adj_Poly2Point.first[i]]->set_partionOwner(ipartition);
         }
         else
         {
           int ival = vectorUtils::MostOccuringValue(PolyToPart);
+          m_PointCollection[adj_Poly2Point.first[i]]->set_partionOwner(ival);
 
 
           if (ival == ipartition)
@@ -311,25 +557,177 @@ namespace PAMELA
       }
     }
 
+    //--Remaining vertices of the ghost polyhedra, so that every vertex of a kept element is in the point collection
+    for (auto it = PolyhedronGhost.begin(); it != PolyhedronGhost.end(); ++it)
+    {
+      auto adj_Poly2Point = PolyhedronPointAdj->get_SingleElementAdjacency(*it);
+      for (auto ipoint : adj_Poly2Point.first)
+      {
+        if (PointOwned.count(ipoint) == 0)
+        {
+          PointGhost.insert(ipoint);
+          auto adj_Point2Poly = PointPolyhedronAdj->get_SingleElementAdjacency(ipoint);
+          m_PointCollection[ipoint]->set_partionOwner(vectorUtils::MostOccuringValue(vectorUtils::Vector2VectorMapping(adj_Point2Poly.first, PolyhedronAffiliation)));
+        }
+      }
+    }
+
+    ////OWNED AND GHOST LINES, once the edges are created. The edges of the kept polyhedra are kept, owned as the points
+    bool hasEdges = m_AdjacencySet->adjacencyExist(ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::FAMILY::LINE, ELEMENTS::FAMILY::POLYHEDRON) != nullptr;
+    if (hasEdges)
+    {
+      auto LinePolyhedronAdj = getAdjacencySet()->get_TopologicalAdjacency(ELEMENTS::FAMILY::LINE, ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::FAMILY::POLYHEDRON);
+      auto PolyhedronLineAdj = getAdjacencySet()->get_TopologicalAdjacency(ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::FAMILY::LINE, ELEMENTS::FAMILY::POLYHEDRON);
+      auto addLines = [&](const std::set<int>& polyhedra)
+      {
+        for (auto it = polyhedra.begin(); it != polyhedra.end(); ++it)
+        {
+          auto adj_Poly2Line = PolyhedronLineAdj->get_SingleElementAdjacency(*it);
+          for (auto iline : adj_Poly2Line.first)
+          {
+            if ((LineOwned.count(iline) == 1) || (LineGhost.count(iline) == 1))
+            {
+              continue;
+            }
+            auto adj_Line2Poly = LinePolyhedronAdj->get_SingleElementAdjacency(iline);
+            int ival = vectorUtils::MostOccuringValue(vectorUtils::Vector2VectorMapping(adj_Line2Poly.first, PolyhedronAffiliation));
+            m_LineCollection[iline]->set_partionOwner(ival);
+            if (ival == ipartition)
+            {
+              LineOwned.insert(iline);
+            }
+            else
+            {
+              LineGhost.insert(iline);
+            }
+          }
+        }
+      };
+      addLines(PolyhedronOwned);
+      addLines(PolyhedronGhost);
+
+      //--Lines which are not edges of a polyhedron (e.g. imported ones) are kept with their points
+      for (size_t iline = 0; iline != m_LineCollection.size_all(); ++iline)
+      {
+        if (LinePolyhedronAdj->get_SingleElementAdjacency(static_cast<int>(iline)).first.empty())
+        {
+          auto& vertexList = m_LineCollection[iline]->get_vertexList();
+          bool owned = PointOwned.count(vertexList[0]->get_globalIndex()) == 1;
+          bool kept = std::all_of(vertexList.begin(), vertexList.end(), [&](Point* vertex)
+          {
+            return (PointOwned.count(vertex->get_globalIndex()) == 1) || (PointGhost.count(vertex->get_globalIndex()) == 1);
+          });
+          if (kept)
+          {
+            m_LineCollection[iline]->set_partionOwner(vertexList[0]->get_partitionOwner());
+            (owned ? LineOwned : LineGhost).insert(static_cast<int>(iline));
+          }
+        }
+      }
+    }
 
     //ClearAfterPartitioning
     LOGINFO("Clean mesh...");
     m_PolyhedronCollection.ClearAfterPartitioning(PolyhedronOwned, PolyhedronGhost);
     m_PolygonCollection.ClearAfterPartitioning(PolygonOwned, PolygonGhost);
+    if (hasEdges)
+    {
+      m_LineCollection.ClearAfterPartitioning(LineOwned, LineGhost);
+    }
     m_PointCollection.ClearAfterPartitioning(PointOwned, PointGhost);
     m_PolyhedronProperty_double->ClearAfterPartitioning(PolyhedronOwned, PolyhedronGhost);
     m_PolyhedronProperty_int->ClearAfterPartitioning(PolyhedronOwned, PolyhedronGhost);
     LOGINFO("*** Done...");
     LOGINFO("Clean Adjacency...");
-    m_AdjacencySet->ClearAfterPartitioning(PolyhedronOwned, PolyhedronGhost,PolygonOwned, PolygonGhost);
+    m_AdjacencySet->ClearAfterPartitioning();
+    m_Geometry.Release();
     LOGINFO("*** Done...");
+    ReleaseUnreferencedElements();
+    LogMemoryFootprint("after partitioning");
 
     //}
   }
 
 
+  void Mesh::ReleaseUnreferencedElements()
+  {
+    std::vector<const void*> kept;
+    auto keep = [&kept](ParallelEnsemble<Point*>& points)
+    {
+      kept.insert(kept.end(), points.begin(), points.end());
+    };
+    auto keepWithVertices = [&kept](auto& elements)
+    {
+      for (auto it = elements.begin(); it != elements.end(); ++it)
+      {
+        kept.push_back(*it);
+        auto& vertices = (*it)->get_vertexList();
+        kept.insert(kept.end(), vertices.begin(), vertices.end());
+      }
+    };
+    keep(m_PointCollection);
+    keep(m_ImplicitPointCollection);
+    keepWithVertices(m_LineCollection);
+    keepWithVertices(m_ImplicitLineCollection);
+    keepWithVertices(m_PolygonCollection);
+    keepWithVertices(m_PolyhedronCollection);
+
+    auto nReleased = m_ElementArena.ReleaseAllExcept(std::move(kept));
+
+    //Gather the remaining elements so that partially used blocks are freed as well
+    auto relocations = m_ElementArena.Compact();
+    if (!relocations.empty())
+    {
+      auto relocation = [&relocations](auto element)
+      {
+        auto it = std::lower_bound(relocations.begin(), relocations.end(), element,
+          [](const std::pair<const void*, void*>& relocated, const void* address) { return relocated.first < address; });
+        return (it != relocations.end() && it->first == element) ? static_cast<decltype(element)>(it->second) : element;
+      };
+      m_PointCollection.Relocate(relocation);
+      m_ImplicitPointCollection.Relocate(relocation);
+      m_LineCollection.Relocate(relocation);
+      m_ImplicitLineCollection.Relocate(relocation);
+      m_PolygonCollection.Relocate(relocation);
+      m_PolyhedronCollection.Relocate(relocation);
+      InvalidateGeometry();
+    }
+    LOGINFO(std::to_string(nReleased) + " elements released, " + std::to_string(relocations.size()) + " moved, "
+      + std::to_string(m_ElementArena.get_MemoryFootprint() / 1024) + " KiB of element storage left");
+  }
+
+  void Mesh::Save(const std::string& path)
+  {
+    MeshCheckpoint::Save(this, path);
+  }
+
+  std::size_t Mesh::get_CollectionsMemoryFootprint() const
+  {
+    return m_PointCollection.get_MemoryFootprint() + m_LineCollection.get_MemoryFootprint() + m_PolygonCollection.get_MemoryFootprint()
+      + m_PolyhedronCollection.get_MemoryFootprint() + m_ImplicitPointCollection.get_MemoryFootprint() + m_ImplicitLineCollection.get_MemoryFootprint();
+  }
+
+  std::size_t Mesh::get_MemoryFootprint() const
+  {
+    return m_ElementArena.get_MemoryFootprint() + get_CollectionsMemoryFootprint()
+      + m_PolyhedronProperty_double->get_MemoryFootprint() + m_PolyhedronProperty_int->get_MemoryFootprint()
+      + m_AdjacencySet->get_MemoryFootprint() + m_Geometry.get_MemoryFootprint();
+  }
+
+  void Mesh::LogMemoryFootprint(const std::string& stage) const
+  {
+    auto KiB = [](std::size_t bytes) { return std::to_string(bytes / 1024) + " KiB"; };
+    LOGINFO("Memory " + stage + ": " + KiB(get_MemoryFootprint())
+      + " (elements " + KiB(m_ElementArena.get_MemoryFootprint())
+      + ", collections " + KiB(get_CollectionsMemoryFootprint())
+      + ", properties " + KiB(m_PolyhedronProperty_double->get_MemoryFootprint() + m_PolyhedronProperty_int->get_MemoryFootprint())
+      + ", adjacencies " + KiB(m_AdjacencySet->get_MemoryFootprint())
+      + ", geometry " + KiB(m_Geometry.get_MemoryFootprint()) + ")");
+  }
+
   std::vector<int> Mesh::METISPartitioning(Adjacency* adjacency, unsigned int npartition)
   {
+    PAMELA_REGION("Mesh::METISPartitioning");
 
 #ifdef WITH_METIS
 
@@ -352,10 +750,11 @@ namespace PAMELA
     std::vector<idx_t> partitionVector(nnodes);
 
     idx_t int_partition = static_cast<idx_t>(npartition);
-    //TODO This is a copy to have idx_t. It can be memory consuming.
-    std::vector<idx_t> rowPtrMetis(csrMatrix->rowPtr.begin(), csrMatrix->rowPtr.end());
-    std::vector<idx_t> columnIndexMetis(csrMatrix->columnIndex.begin(), csrMatrix->columnIndex.end());
-    METIS_PartGraphRecursive(&nnodes, &nconst, rowPtrMetis.data(), columnIndexMetis.data(),
+    //No copy when the CSR offsets/indices have the width of idx_t (see PAMELA_CSR_32BIT_OFFSETS and PAMELA_CSR_64BIT_INDICES)
+    std::vector<idx_t> rowPtrBuffer, columnIndexBuffer;
+    idx_t* rowPtrMetis = MetisArray(csrMatrix->rowPtr, rowPtrBuffer);
+    idx_t* columnIndexMetis = MetisArray(csrMatrix->columnIndex, columnIndexBuffer);
+    METIS_PartGraphRecursive(&nnodes, &nconst, rowPtrMetis, columnIndexMetis,
         nullptr, nullptr, nullptr, &int_partition, nullptr, nullptr, options, &objval, partitionVector.data());
 
     return std::vector<int>(partitionVector.begin(), partitionVector.end());
@@ -371,6 +770,7 @@ namespace PAMELA
 
   std::vector<int> Mesh::TRIVIALPartitioning( unsigned int npartition )
   {
+    PAMELA_REGION("Mesh::TRIVIALPartitioning");
     int CommRankSize = Communicator::worldSize();
     if( npartition == 1 )
     {
@@ -428,14 +828,14 @@ namespace PAMELA
       shift = ydiff / npartition;
       dim_i = 1;
     }
+    const auto& cellGeometry = get_PolyhedronGeometry();
+    const auto& center = dim_i == 0 ? cellGeometry.centroidX : cellGeometry.centroidY;
     std::vector< int > partitionVector( m_PolyhedronCollection.size_all(),0 );
-    int count = 0;
-    for( auto cell : m_PolyhedronCollection )
+    for( size_t count = 0; count != partitionVector.size(); ++count )
     {
-      auto center = cell->get_centroidCoordinates();
-      double dist_to_begin = std::fabs(center[dim_i] - min[dim_i]);
+      double dist_to_begin = std::fabs(center[count] - min[dim_i]);
       int part_nb = dist_to_begin / shift;
-      partitionVector[count++] = part_nb;
+      partitionVector[count] = part_nb;
       if (part_nb >= CommRankSize )
       {
         LOGERROR("Wrong partition number attribute");
@@ -446,6 +846,25 @@ namespace PAMELA
 
   }
 
+  Adjacency* Mesh::CreateTPFATransmissibilities(const std::string& label, const std::string& permeabilityLabel)
+  {
+    if (m_PolygonCollection.size_all() == 0)
+    {
+      LOGERROR("No polygons, call CreateFacesFromCells before computing transmissibilities");
+      return nullptr;
+    }
+
+    auto faceToCell = m_AdjacencySet->get_TopologicalAdjacency(ELEMENTS::FAMILY::POLYGON, ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::FAMILY::POLYHEDRON);
+    auto permeability = tpfa::GetPermeability(m_PolyhedronProperty_double, m_PolyhedronCollection.size_all(), permeabilityLabel);
+
+    auto adjacency = new Adjacency(ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::FAMILY::UNKNOWN, &m_PolyhedronCollection, &m_PolyhedronCollection, nullptr);
+    tpfa::ComputeTransmissibilities(get_PolyhedronGeometry(), get_PolygonGeometry(), *faceToCell->get_adjacencySparseMatrix(), permeability,
+                                    *adjacency->get_adjacencySparseMatrix(), adjacency->get_Weights());
+    m_AdjacencySet->Add_NonTopologicalAdjacency(label, adjacency);
+
+    return adjacency;
+  }
+
   void Mesh::CreateLineGroupWithAdjacency(std::string Label, Adjacency* adjacency)
   {
 
@@ -465,16 +884,19 @@ namespace PAMELA
     {
 
       //Compute Node coordinates
+      const auto& cellGeometry = get_PolyhedronGeometry();
       int isource = 0, itarget = 0, ipoint = static_cast<int>(m_PointCollection.size_owned()) , iline = static_cast<int>(m_LineCollection.size_owned());
 
       for (auto irow = 0; irow != dimRow; ++irow)
       {
         if (rowPtr[irow + 1]- rowPtr[irow]>0)
         {
-          auto it = get_PolyhedronCollection()->begin_owned() + irow;
-          auto xyz1 = (*it)->get_centroidCoordinates();
-          auto source_point = ElementFactory::makePoint(ELEMENTS::TYPE::VTK_VERTEX, ipoint, xyz1[0], xyz1[1], xyz1[2]);
+          auto source_point = ElementFactory::makePoint(m_ElementArena, ELEMENTS::TYPE::VTK_VERTEX, ipoint, cellGeometry.centroidX[irow], cellGeometry.centroidY[irow], cellGeometry.centroidZ[irow]);
           auto source_rpoint = point_collection.AddElement(Label, source_point).first;
+          if (source_rpoint != source_point)
+          {
+            m_ElementArena.Release(source_point);
+          }
           ++ipoint; ++nb_points;
           itarget = isource;
           for (auto icol = rowPtr[irow]; icol != rowPtr[irow + 1]; ++icol)
@@ -482,15 +904,21 @@ namespace PAMELA
             if (icol != columIndex[icol])
             {
               itarget = itarget + 1;
-              auto it2 = get_PolyhedronCollection()->begin_owned() + columIndex[icol];
-              auto xyz2 = (*it2)->get_centroidCoordinates();
-              auto target_point = ElementFactory::makePoint(ELEMENTS::TYPE::VTK_VERTEX, ipoint, xyz2[0], xyz2[1], xyz2[2]);
+              auto jcol = columIndex[icol];
+              auto target_point = ElementFactory::makePoint(m_ElementArena, ELEMENTS::TYPE::VTK_VERTEX, ipoint, cellGeometry.centroidX[jcol], cellGeometry.centroidY[jcol], cellGeometry.centroidZ[jcol]);
               auto target_rpoint = point_collection.AddElement(Label, target_point).first;
+              if (target_rpoint != target_point)
+              {
+                m_ElementArena.Release(target_point);
+              }
               ++ipoint;
               auto edgev = { source_rpoint , target_rpoint };
-              auto edge = ElementFactory::makeLine(ELEMENTS::TYPE::VTK_LINE, iline, edgev);
+              auto edge = ElementFactory::makeLine(m_ElementArena, ELEMENTS::TYPE::VTK_LINE, iline, edgev);
               ++iline;
-              line_collection.AddElement(Label, edge);
+              if (!line_collection.AddElement(Label, edge).second)
+              {
+                m_ElementArena.Release(edge);
+              }
             }
 
           }
@@ -503,10 +931,13 @@ namespace PAMELA
     if (nb_lines >0)
     {
       m_LineCollection.MakeActiveGroup(Label);
+      m_AdjacencySet->InvalidateTopologicalAdjacencies(ELEMENTS::FAMILY::LINE);
     }
     if (nb_points > 0)
     {
       m_PointCollection.MakeActiveGroup(Label);
+      m_AdjacencySet->InvalidateTopologicalAdjacencies(ELEMENTS::FAMILY::POINT);
+      m_Geometry.Invalidate();
     }
 
   }
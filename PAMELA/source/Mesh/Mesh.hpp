@@ -18,11 +18,13 @@
 #include "Elements/Line.hpp"
 #include "Elements/Polygon.hpp"
 #include "Elements/Polyhedron.hpp"
+#include "Elements/ElementArena.hpp"
 #include "Collection/Collection.hpp"
 #include "Property/Property.hpp"
 #include "Adjacency/AdjacencySet.hpp"
 #include "Utils/Utils.hpp"
 #include "MeshDataWriters/Part.hpp"
+#include "Mesh/MeshGeometry.hpp"
 
 namespace PAMELA
 {
@@ -31,6 +33,8 @@ namespace PAMELA
 
   class Mesh
   {
+    friend class MeshCheckpoint;
+
     public:
       virtual ~Mesh();
       Mesh();
@@ -43,6 +47,9 @@ namespace PAMELA
 
       LineCollection*  get_ImplicitLineCollection() { return &m_ImplicitLineCollection; }
 
+      // Storage of the elements created by the mesh and its importers, destroyed with the mesh
+      ElementArena& get_ElementArena() { return m_ElementArena; }
+
       Property<PolyhedronCollection, double>* get_PolyhedronProperty_double() const { return m_PolyhedronProperty_double; }
       Property<PolyhedronCollection, int>* get_PolyhedronProperty_int() const { return m_PolyhedronProperty_int; }
 
@@ -52,12 +59,24 @@ namespace PAMELA
         return m_AdjacencySet;
       }
 
+      ///Geometry
+      // Volumes/centroids of the polyhedra and areas/normals/centers of the polygons, indexed by local index.
+      // Computed in batches on first use and cached until InvalidateGeometry is called.
+      const geometry::CellGeometry& get_PolyhedronGeometry() { return m_Geometry.get_CellGeometry(m_PointCollection, m_PolyhedronCollection); }
+      const geometry::FaceGeometry& get_PolygonGeometry() { return m_Geometry.get_FaceGeometry(m_PointCollection, m_PolygonCollection); }
+      const geometry::GeometryCache& get_GeometryCache() const { return m_Geometry; }
+      // To be called after moving points
+      void InvalidateGeometry() { m_Geometry.Invalidate(); }
+
       virtual void Distort(double alpha) {
         utils::pamela_unused(alpha);
       }
 
       ////Updaters
       void CreateFacesFromCells();
+      // Unique edges of the polyhedra and polygons, with Polyhedron to Line and Polygon to Line adjacencies.
+      // Call it after CreateFacesFromCells to get the edges of all the faces.
+      void CreateEdgesFromCells();
 
       ///Functions to add elements or group to the mesh
       //Add Element
@@ -89,10 +108,28 @@ namespace PAMELA
       //Adjacency
       void CreateLineGroupWithAdjacency(std::string Label, Adjacency* adjacency);
 
+      // Two-point flux transmissibilities between polyhedra sharing a polygon, registered as a weighted
+      // Polyhedron to Polyhedron non-topological adjacency under label. See tpfa::GetPermeability for the permeability lookup.
+      // Call it after CreateFacesFromCells.
+      Adjacency* CreateTPFATransmissibilities(const std::string& label = "TPFA", const std::string& permeabilityLabel = "PERM");
+
       std::set<int> const & getNeighborList() const { return m_neighborList; }
 
+      //Checkpoint
+      // Binary copy of the mesh on this rank (points, elements, groups, properties and cached adjacencies),
+      // read back by MeshFactory::makeMesh from a .pmesh file. See MeshCheckpoint for the layout.
+      void Save(const std::string& path);
+
+      //Memory
+      // Bytes held on this rank by the elements, collections, properties, adjacencies and cached geometry
+      std::size_t get_MemoryFootprint() const;
+      void LogMemoryFootprint(const std::string& stage) const;
+
     protected:
 
+      //Element storage, declared first to outlive the collections
+      ElementArena m_ElementArena;
+
       //Explicit Element Collections - First owned then ghosts
       PointCollection m_PointCollection;
       LineCollection m_LineCollection;
@@ -112,9 +149,18 @@ namespace PAMELA
 
       std::set<int> m_neighborList;
 
+      //Geometry
+      geometry::GeometryCache m_Geometry;
+
       std::vector<int> METISPartitioning(Adjacency* adjacency, unsigned int npartition);
       std::vector<int> TRIVIALPartitioning( unsigned int npartition );
 
+      // Destroy the elements no longer referenced by a collection or by the vertex list of a kept element,
+      // then compact the element storage
+      void ReleaseUnreferencedElements();
+
+      std::size_t get_CollectionsMemoryFootprint() const;
+
     private:
       std::string m_partitioning_type { "METIS" };
 
@@ -0,0 +1,669 @@
+/*
+ * ------------------------------------------------------------------------------------------------------------
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ * Copyright (c) 2018-2020 Lawrence Livermore National Security LLC
+ * Copyright (c) 2018-2020 The Board of Trustees of the Leland Stanford Junior University
+ * Copyright (c) 2018-2020 Total, S.A
+ * Copyright (c) 2020-     GEOSX Contributors
+ * All right reserved
+ *
+ * See top level LICENSE, COPYRIGHT, CONTRIBUTORS, NOTICE, and ACKNOWLEDGEMENTS files for details.
+ * ------------------------------------------------------------------------------------------------------------
+ */
+
+#include "Mesh/MeshCheckpoint.hpp"
+#include "Mesh/UnstructuredMesh.hpp"
+#include "Elements/ElementFactory.hpp"
+#include "Adjacency/Adjacency.hpp"
+#include "Utils/Logger.hpp"
+#include "Utils/Statistics.hpp"
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <type_traits>
+
+namespace PAMELA
+{
+
+  namespace
+  {
+    const char MAGIC[8] = { 'P', 'M', 'E', 'S', 'H', '\0', '\0', '\0' };
+    const std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+    struct FileHeader
+    {
+      char Magic[8];
+      std::uint32_t Version;
+      std::uint32_t ByteOrder;
+      std::uint64_t nBlocks;
+      std::uint64_t Size;
+    };
+
+    struct BlockHeader
+    {
+      std::uint64_t Count;
+      std::uint32_t ElementSize;
+      std::uint32_t Reserved;
+    };
+
+    std::size_t Padding(std::size_t bytes)
+    {
+      return (8 - bytes % 8) % 8;
+    }
+
+    class BlockWriter
+    {
+    public:
+
+      explicit BlockWriter(std::ofstream& file) : m_file(file), m_nBlocks(0) {}
+
+      template <typename T>
+      void Write(const T* data, std::size_t count)
+      {
+        static const char padding[8] = {};
+        BlockHeader header = { static_cast<std::uint64_t>(count), static_cast<std::uint32_t>(sizeof(T)), 0 };
+        m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        m_file.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(count * sizeof(T)));
+        m_file.write(padding, static_cast<std::streamsize>(Padding(count * sizeof(T))));
+        ++m_nBlocks;
+      }
+
+      template <typename T>
+      void Write(const std::vector<T>& values) { Write(values.data(), values.size()); }
+      void Write(const std::string& label) { Write(label.data(), label.size()); }
+      void Write(std::initializer_list<std::int64_t> info) { Write(info.begin(), info.size()); }
+
+      std::uint64_t get_nBlocks() const { return m_nBlocks; }
+
+    private:
+
+      std::ofstream& m_file;
+      std::uint64_t m_nBlocks;
+
+    };
+
+    class BlockReader
+    {
+    public:
+
+      BlockReader(const char* data, std::size_t size) : m_data(data), m_size(size), m_position(sizeof(FileHeader)) {}
+
+      template <typename T>
+      void Read(std::vector<T>& values)
+      {
+        std::size_t count, elementSize;
+        auto data = Next(count, elementSize);
+        if (elementSize == sizeof(T))
+        {
+          values.resize(count);
+          if (count != 0)
+          {
+            std::memcpy(values.data(), data, count * sizeof(T));
+          }
+        }
+        else if (std::is_integral<T>::value && elementSize == sizeof(std::int32_t))
+        {
+          //Integers saved with another width, e.g. CSR offsets
+          auto stored = reinterpret_cast<const std::int32_t*>(data);
+          values.assign(stored, stored + count);
+        }
+        else if (std::is_integral<T>::value && elementSize == sizeof(std::int64_t))
+        {
+          auto stored = reinterpret_cast<const std::int64_t*>(data);
+          values.assign(stored, stored + count);
+        }
+        else
+        {
+          LOGERROR("Unexpected array in mesh checkpoint");
+        }
+      }
+
+      std::string ReadString()
+      {
+        std::vector<char> label;
+        Read(label);
+        return std::string(label.begin(), label.end());
+      }
+
+      std::vector<std::int64_t> ReadInfo(std::size_t size)
+      {
+        std::vector<std::int64_t> info;
+        Read(info);
+        if (info.size() != size)
+        {
+          LOGERROR("Unexpected array in mesh checkpoint");
+        }
+        return info;
+      }
+
+    private:
+
+      const char* Next(std::size_t& count, std::size_t& elementSize)
+      {
+        BlockHeader header;
+        if (m_position + sizeof(header) > m_size)
+        {
+          LOGERROR("Truncated mesh checkpoint");
+        }
+        std::memcpy(&header, m_data + m_position, sizeof(header));
+        count = static_cast<std::size_t>(header.Count);
+        elementSize = header.ElementSize;
+        auto data = m_data + m_position + sizeof(header);
+        auto bytes = count * elementSize;
+        m_position += sizeof(header) + bytes + Padding(bytes);
+        if (m_position > m_size)
+        {
+          LOGERROR("Truncated mesh checkpoint");
+        }
+        return data;
+      }
+
+      const char* m_data;
+      std::size_t m_size;
+      std::size_t m_position;
+
+    };
+
+    //Elements of a family in the order they are saved, identified by their position
+    template <class T>
+    struct ElementTable
+    {
+      int Add(T element)
+      {
+        auto insertion = Ids.emplace(element, static_cast<int>(Elements.size()));
+        if (insertion.second)
+        {
+          Elements.push_back(element);
+        }
+        return insertion.first->second;
+      }
+
+      template <class Ensemble>
+      void AddAll(Ensemble& ensemble)
+      {
+        for (auto it = ensemble.begin(); it != ensemble.end(); ++it)
+        {
+          Add(*it);
+        }
+      }
+
+      template <class Collection>
+      void AddCollection(Collection& collection)
+      {
+        AddAll(collection);
+        for (auto& group : collection.get_labelToGroupMap())
+        {
+          AddAll(*group.second);
+        }
+      }
+
+      std::vector<T> Elements;
+      std::unordered_map<T, int> Ids;
+    };
+
+    template <class T>
+    void WriteIndices(BlockWriter& out, const std::vector<T>& elements)
+    {
+      std::vector<std::int32_t> indices;
+      indices.reserve(4 * elements.size());
+      for (auto element : elements)
+      {
+        indices.insert(indices.end(), { element->get_localIndex(), element->get_globalIndex(), element->get_initIndex(), element->get_partitionOwner() });
+      }
+      out.Write(indices);
+    }
+
+    template <class T>
+    void RestoreIndices(const std::vector<T>& elements, const std::vector<std::int32_t>& indices)
+    {
+      for (std::size_t i = 0; i != elements.size(); ++i)
+      {
+        elements[i]->set_localIndex(indices[4 * i]);
+        elements[i]->set_globalIndex(indices[4 * i + 1]);
+        elements[i]->set_initIndex(indices[4 * i + 2]);
+        elements[i]->set_partionOwner(indices[4 * i + 3]);
+      }
+    }
+
+    void WritePoints(BlockWriter& out, const ElementTable<Point*>& points)
+    {
+      std::vector<double> coordinates;
+      coordinates.reserve(3 * points.Elements.size());
+      for (auto point : points.Elements)
+      {
+        const auto& xyz = point->get_coordinates();
+        coordinates.insert(coordinates.end(), { xyz.x, xyz.y, xyz.z });
+      }
+      out.Write(coordinates);
+      WriteIndices(out, points.Elements);
+    }
+
+    std::vector<Point*> ReadPoints(BlockReader& in, ElementArena& arena, std::vector<std::int32_t>& indices)
+    {
+      std::vector<double> coordinates;
+      in.Read(coordinates);
+      in.Read(indices);
+      std::vector<Point*> points(coordinates.size() / 3);
+      for (std::size_t i = 0; i != points.size(); ++i)
+      {
+        points[i] = ElementFactory::makePoint(arena, ELEMENTS::TYPE::VTK_VERTEX, indices[4 * i + 2], coordinates[3 * i], coordinates[3 * i + 1], coordinates[3 * i + 2]);
+      }
+      RestoreIndices(points, indices);
+      return points;
+    }
+
+    //Type, vertex offsets and vertices of the elements of a family
+    template <class T>
+    void WriteElements(BlockWriter& out, const ElementTable<T>& elements, const ElementTable<Point*>& points)
+    {
+      std::vector<std::int32_t> types;
+      std::vector<std::int64_t> offsets(1, 0);
+      std::vector<std::int32_t> vertices;
+      types.reserve(elements.Elements.size());
+      offsets.reserve(elements.Elements.size() + 1);
+      for (auto element : elements.Elements)
+      {
+        types.push_back(static_cast<std::int32_t>(element->get_vtkType()));
+        for (auto vertex : element->get_vertexList())
+        {
+          vertices.push_back(points.Ids.at(vertex));
+        }
+        offsets.push_back(static_cast<std::int64_t>(vertices.size()));
+      }
+      out.Write(types);
+      out.Write(offsets);
+      out.Write(vertices);
+      WriteIndices(out, elements.Elements);
+    }
+
+    template <class T, class Make>
+    std::vector<T> ReadElements(BlockReader& in, const std::vector<Point*>& points, std::vector<std::int32_t>& indices, Make make)
+    {
+      std::vector<std::int32_t> types;
+      std::vector<std::int64_t> offsets;
+      std::vector<std::int32_t> vertices;
+      in.Read(types);
+      in.Read(offsets);
+      in.Read(vertices);
+      in.Read(indices);
+      std::vector<T> elements(types.size());
+      std::vector<Point*> vertexList;
+      for (std::size_t i = 0; i != elements.size(); ++i)
+      {
+        vertexList.clear();
+        for (auto j = offsets[i]; j != offsets[i + 1]; ++j)
+        {
+          vertexList.push_back(points.at(vertices[j]));
+        }
+        elements[i] = make(static_cast<ELEMENTS::TYPE>(types[i]), indices[4 * i + 2], vertexList);
+      }
+      RestoreIndices(elements, indices);
+      return elements;
+    }
+
+    //Elements of an ensemble, owned then ghosts. Active is -1 for collections, the active flag for groups.
+    template <class Ensemble, class T>
+    void WriteEnsemble(BlockWriter& out, Ensemble& ensemble, const ElementTable<T>& table, int active)
+    {
+      std::vector<std::int32_t> ids;
+      ids.reserve(ensemble.size_all());
+      for (auto it = ensemble.begin(); it != ensemble.end(); ++it)
+      {
+        ids.push_back(table.Ids.at(*it));
+      }
+      out.Write({ static_cast<std::int64_t>(ensemble.size_owned()), ensemble.get_GlobalToLocalIndex().empty() ? 0 : 1, active });
+      out.Write(ids);
+    }
+
+    template <class Ensemble, class T>
+    int ReadEnsemble(BlockReader& in, Ensemble& ensemble, const std::vector<T>& elements)
+    {
+      auto info = in.ReadInfo(3);
+      std::vector<std::int32_t> ids;
+      in.Read(ids);
+      std::vector<T> data(ids.size());
+      for (std::size_t i = 0; i != ids.size(); ++i)
+      {
+        data[i] = elements.at(ids[i]);
+      }
+      ensemble.Assign(std::move(data), static_cast<std::size_t>(info[0]), info[1] == 1);
+      return static_cast<int>(info[2]);
+    }
+
+    template <class T>
+    void WriteCollection(BlockWriter& out, ElementCollection<T>& collection, const ElementTable<T>& table)
+    {
+      //Sorted so that saving the same mesh twice gives the same file
+      std::map<std::string, ElementEnsemble<T, ElementHash<T>, ElementEqual<T>>*> groups(collection.get_labelToGroupMap().begin(), collection.get_labelToGroupMap().end());
+      auto& activeGroups = collection.get_ActiveGroupsMap();
+      out.Write({ static_cast<std::int64_t>(groups.size()) });
+      for (auto& group : groups)
+      {
+        auto active = activeGroups.find(group.first);
+        out.Write(group.first);
+        WriteEnsemble(out, *group.second, table, active == activeGroups.end() ? -1 : active->second);
+      }
+      WriteEnsemble(out, collection, table, -1);
+    }
+
+    //Groups first, the numbering of the elements is the one of the collection
+    template <class T>
+    void ReadCollection(BlockReader& in, ElementCollection<T>& collection, const std::vector<T>& elements)
+    {
+      auto nGroups = in.ReadInfo(1)[0];
+      for (std::int64_t i = 0; i != nGroups; ++i)
+      {
+        auto label = in.ReadString();
+        collection.addAndCreateGroup(label);
+        auto active = ReadEnsemble(in, *collection.get_Group(label), elements);
+        if (active >= 0)
+        {
+          collection.get_ActiveGroupsMap()[label] = (active == 1);
+        }
+      }
+      ReadEnsemble(in, collection, elements);
+    }
+
+    template <class T>
+    void WriteProperties(BlockWriter& out, Property<PolyhedronCollection, T>* property)
+    {
+      auto& data = property->get_PropertyMap();
+      std::map<std::string, ParallelEnsemble<T>*> sorted;
+      for (auto& it : data)
+      {
+        sorted[it.first] = &it.second;
+      }
+      out.Write({ static_cast<std::int64_t>(sorted.size()) });
+      for (auto& it : sorted)
+      {
+        out.Write(it.first);
+        out.Write({ static_cast<std::int64_t>(property->GetProperty_dimension(it.first)), static_cast<std::int64_t>(it.second->size_owned()) });
+        out.Write(it.second->data_all());
+      }
+    }
+
+    template <class T>
+    void ReadProperties(BlockReader& in, Property<PolyhedronCollection, T>* property)
+    {
+      auto nProperties = in.ReadInfo(1)[0];
+      for (std::int64_t i = 0; i != nProperties; ++i)
+      {
+        auto label = in.ReadString();
+        auto info = in.ReadInfo(2);
+        std::vector<T> values;
+        in.Read(values);
+        property->ReferenceProperty(label, static_cast<VARIABLE_DIMENSION>(info[0]));
+        auto& ensemble = property->get_PropertyMap()[label];
+        auto ghost = std::vector<T>(values.begin() + info[1], values.end());
+        values.resize(static_cast<std::size_t>(info[1]));
+        ensemble.push_back_owned(values);
+        ensemble.push_back_ghost(ghost);
+      }
+    }
+
+    //Kind of adjacency, in the order of AdjacencySet storage
+    enum class ADJACENCY { REGISTERED = 0, DERIVED = 1, NONTOPOLOGICAL = 2 };
+
+    void WriteAdjacency(BlockWriter& out, ADJACENCY kind, const std::string& label, Adjacency* adjacency)
+    {
+      auto csr = adjacency->get_adjacencySparseMatrix();
+      out.Write(label);
+      out.Write({ static_cast<std::int64_t>(kind), static_cast<std::int64_t>(adjacency->get_sourceFamily()),
+        static_cast<std::int64_t>(adjacency->get_targetFamily()), static_cast<std::int64_t>(adjacency->get_baseFamily()),
+        static_cast<std::int64_t>(csr->nnz), static_cast<std::int64_t>(csr->dimRow), static_cast<std::int64_t>(csr->dimColumn),
+        static_cast<std::int64_t>(csr->dimRow_owned), static_cast<std::int64_t>(csr->dimColumn_owned),
+        static_cast<std::int64_t>(csr->dimRow_ghost), static_cast<std::int64_t>(csr->dimColumn_ghost) });
+      out.Write(csr->rowPtr);
+      out.Write(csr->columnIndex);
+      out.Write(csr->values);
+      out.Write(adjacency->get_Weights());
+    }
+
+    ParallelEnsembleBase* FamilyCollection(Mesh* mesh, ELEMENTS::FAMILY family)
+    {
+      switch (family)
+      {
+      case ELEMENTS::FAMILY::POLYHEDRON: return mesh->get_PolyhedronCollection();
+      case ELEMENTS::FAMILY::POLYGON: return mesh->get_PolygonCollection();
+      case ELEMENTS::FAMILY::LINE: return mesh->get_LineCollection();
+      case ELEMENTS::FAMILY::POINT: return mesh->get_PointCollection();
+      default: return nullptr;
+      }
+    }
+
+    Adjacency* ReadAdjacency(BlockReader& in, Mesh* mesh, ADJACENCY& kind, std::string& label)
+    {
+      typedef CSRMatrix::offset_type offset_type;
+      typedef CSRMatrix::index_type index_type;
+
+      label = in.ReadString();
+      auto info = in.ReadInfo(11);
+      kind = static_cast<ADJACENCY>(info[0]);
+      auto source = static_cast<ELEMENTS::FAMILY>(info[1]);
+      auto target = static_cast<ELEMENTS::FAMILY>(info[2]);
+      auto base = static_cast<ELEMENTS::FAMILY>(info[3]);
+
+      auto csr = new CSRMatrix();
+      csr->nnz = static_cast<offset_type>(info[4]);
+      csr->dimRow = static_cast<index_type>(info[5]);
+      csr->dimColumn = static_cast<index_type>(info[6]);
+      csr->dimRow_owned = static_cast<index_type>(info[7]);
+      csr->dimColumn_owned = static_cast<index_type>(info[8]);
+      csr->dimRow_ghost = static_cast<index_type>(info[9]);
+      csr->dimColumn_ghost = static_cast<index_type>(info[10]);
+      in.Read(csr->rowPtr);
+      in.Read(csr->columnIndex);
+      in.Read(csr->values);
+
+      auto adjacency = new Adjacency(source, target, base, FamilyCollection(mesh, source), FamilyCollection(mesh, target), FamilyCollection(mesh, base), csr);
+      in.Read(adjacency->get_Weights());
+      return adjacency;
+    }
+  }
+
+  void MeshCheckpoint::Save(Mesh* mesh, const std::string& path)
+  {
+    PAMELA_REGION("MeshCheckpoint::Save");
+    LOGINFO("*** Saving mesh checkpoint " + path);
+
+    std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+      LOGERROR("Cannot open " + path);
+    }
+
+    //Every element is saved once, collections refer to it by its position
+    ElementTable<Line*> lines;
+    ElementTable<Polygon*> polygons;
+    ElementTable<Polyhedron*> polyhedra;
+    ElementTable<Point*> points;
+    lines.AddCollection(*mesh->get_LineCollection());
+    lines.AddCollection(*mesh->get_ImplicitLineCollection());
+    polygons.AddCollection(*mesh->get_PolygonCollection());
+    polyhedra.AddCollection(*mesh->get_PolyhedronCollection());
+    points.AddCollection(*mesh->get_PointCollection());
+    points.AddCollection(mesh->m_ImplicitPointCollection);
+    auto addVertices = [&points](auto& elements)
+    {
+      for (auto element : elements)
+      {
+        for (auto vertex : element->get_vertexList())
+        {
+          points.Add(vertex);
+        }
+      }
+    };
+    addVertices(lines.Elements);
+    addVertices(polygons.Elements);
+    addVertices(polyhedra.Elements);
+
+    FileHeader header;
+    std::memcpy(header.Magic, MAGIC, sizeof(MAGIC));
+    header.Version = VERSION;
+    header.ByteOrder = BYTE_ORDER_MARK;
+    header.nBlocks = 0;
+    header.Size = 0;
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    BlockWriter out(file);
+
+    //Elements
+    WritePoints(out, points);
+    WriteElements(out, lines, points);
+    WriteElements(out, polygons, points);
+    WriteElements(out, polyhedra, points);
+
+    //Collections
+    WriteCollection(out, *mesh->get_PointCollection(), points);
+    WriteCollection(out, mesh->m_ImplicitPointCollection, points);
+    WriteCollection(out, *mesh->get_LineCollection(), lines);
+    WriteCollection(out, *mesh->get_ImplicitLineCollection(), lines);
+    WriteCollection(out, *mesh->get_PolygonCollection(), polygons);
+    WriteCollection(out, *mesh->get_PolyhedronCollection(), polyhedra);
+
+    //Properties
+    WriteProperties(out, mesh->get_PolyhedronProperty_double());
+    WriteProperties(out, mesh->get_PolyhedronProperty_int());
+
+    //Adjacencies
+    auto adjacencySet = mesh->getAdjacencySet();
+    out.Write({ static_cast<std::int64_t>(adjacencySet->TopologicalAdjacencyMap.size() + adjacencySet->NonTopologicalAdjacencyMap.size()) });
+    for (auto& adjacency : adjacencySet->TopologicalAdjacencyMap)
+    {
+      auto kind = adjacencySet->m_derivedAdjacencies.count(adjacency.first) == 1 ? ADJACENCY::DERIVED : ADJACENCY::REGISTERED;
+      WriteAdjacency(out, kind, "", adjacency.second);
+    }
+    for (auto& adjacency : adjacencySet->NonTopologicalAdjacencyMap)
+    {
+      WriteAdjacency(out, ADJACENCY::NONTOPOLOGICAL, adjacency.first, adjacency.second);
+    }
+
+    //Partitioning
+    out.Write(std::vector<std::int32_t>(mesh->m_neighborList.begin(), mesh->m_neighborList.end()));
+
+    header.nBlocks = out.get_nBlocks();
+    header.Size = static_cast<std::uint64_t>(file.tellp());
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.close();
+    if (!file)
+    {
+      LOGERROR("Error while writing " + path);
+    }
+
+    LOGINFO(std::to_string(points.Elements.size()) + " points, " + std::to_string(lines.Elements.size()) + " lines, " + std::to_string(polygons.Elements.size())
+      + " polygons and " + std::to_string(polyhedra.Elements.size()) + " polyhedra saved in " + std::to_string(header.Size / 1024) + " KiB");
+    LOGINFO("*** Done");
+  }
+
+  Mesh* MeshCheckpoint::Load(const std::string& path)
+  {
+    PAMELA_REGION("MeshCheckpoint::Load");
+    LOGINFO("*** Reading mesh checkpoint " + path);
+
+    //The whole file in a single read, blocks are then copied to the mesh storage
+    std::ifstream file(path, std::ios::in | std::ios::binary | std::ios::ate);
+    if (!file)
+    {
+      LOGERROR("Cannot open " + path);
+    }
+    auto size = static_cast<std::size_t>(file.tellg());
+    std::vector<std::uint64_t> buffer((size + 7) / 8);
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(size));
+    if (!file || size < sizeof(FileHeader))
+    {
+      LOGERROR("Cannot read " + path);
+    }
+
+    FileHeader header;
+    std::memcpy(&header, buffer.data(), sizeof(header));
+    if (std::memcmp(header.Magic, MAGIC, sizeof(MAGIC)) != 0)
+    {
+      LOGERROR(path + " is not a PAMELA mesh checkpoint");
+    }
+    if (header.ByteOrder != BYTE_ORDER_MARK)
+    {
+      LOGERROR(path + " has been saved on a machine with a different byte order");
+    }
+    if (header.Version != VERSION)
+    {
+      LOGERROR(path + " has version " + std::to_string(header.Version) + ", version " + std::to_string(VERSION) + " expected");
+    }
+    if (header.Size != size)
+    {
+      LOGERROR("Truncated mesh checkpoint");
+    }
+
+    BlockReader in(reinterpret_cast<const char*>(buffer.data()), size);
+    Mesh* mesh = new UnstructuredMesh();
+    auto& arena = mesh->get_ElementArena();
+
+    //Elements
+    std::vector<std::int32_t> pointIndices, lineIndices, polygonIndices, polyhedronIndices;
+    auto points = ReadPoints(in, arena, pointIndices);
+    auto lines = ReadElements<Line*>(in, points, lineIndices, [&arena](ELEMENTS::TYPE type, int index, const std::vector<Point*>& vertexList)
+    {
+      return ElementFactory::makeLine(arena, type, index, vertexList);
+    });
+    auto polygons = ReadElements<Polygon*>(in, points, polygonIndices, [&arena](ELEMENTS::TYPE type, int index, const std::vector<Point*>& vertexList)
+    {
+      return ElementFactory::makePolygon(arena, type, index, vertexList);
+    });
+    auto polyhedra = ReadElements<Polyhedron*>(in, points, polyhedronIndices, [&arena](ELEMENTS::TYPE type, int index, const std::vector<Point*>& vertexList)
+    {
+      return ElementFactory::makePolyhedron(arena, type, index, vertexList);
+    });
+
+    //Collections set the local index of their elements, while elements are hashed on the local index of their vertices
+    ReadCollection(in, *mesh->get_PointCollection(), points);
+    ReadCollection(in, mesh->m_ImplicitPointCollection, points);
+    RestoreIndices(points, pointIndices);
+    ReadCollection(in, *mesh->get_LineCollection(), lines);
+    ReadCollection(in, *mesh->get_ImplicitLineCollection(), lines);
+    ReadCollection(in, *mesh->get_PolygonCollection(), polygons);
+    ReadCollection(in, *mesh->get_PolyhedronCollection(), polyhedra);
+
+    //Elements shared by several collections keep the local index they had
+    RestoreIndices(lines, lineIndices);
+    RestoreIndices(polygons, polygonIndices);
+    RestoreIndices(polyhedra, polyhedronIndices);
+
+    //Properties
+    ReadProperties(in, mesh->get_PolyhedronProperty_double());
+    ReadProperties(in, mesh->get_PolyhedronProperty_int());
+
+    //Adjacencies
+    auto adjacencySet = mesh->getAdjacencySet();
+    auto nAdjacencies = in.ReadInfo(1)[0];
+    for (std::int64_t i = 0; i != nAdjacencies; ++i)
+    {
+      ADJACENCY kind;
+      std::string label;
+      auto adjacency = ReadAdjacency(in, mesh, kind, label);
+      if (kind == ADJACENCY::NONTOPOLOGICAL)
+      {
+        adjacencySet->NonTopologicalAdjacencyMap[label] = adjacency;
+        continue;
+      }
+      auto tri = std::make_tuple(adjacency->get_sourceFamily(), adjacency->get_targetFamily(), adjacency->get_baseFamily());
+      adjacencySet->TopologicalAdjacencyMap[tri] = adjacency;
+      if (kind == ADJACENCY::DERIVED)
+      {
+        adjacencySet->m_derivedAdjacencies.insert(tri);
+      }
+    }
+
+    //Partitioning
+    std::vector<std::int32_t> neighbors;
+    in.Read(neighbors);
+    mesh->m_neighborList.insert(neighbors.begin(), neighbors.end());
+
+    LOGINFO(std::to_string(points.size()) + " points, " + std::to_string(lines.size()) + " lines, " + std::to_string(polygons.size())
+      + " polygons and " + std::to_string(polyhedra.size()) + " polyhedra read");
+    LOGINFO("*** Done");
+    return mesh;
+  }
+
+}
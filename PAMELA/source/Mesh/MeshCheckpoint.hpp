@@ -0,0 +1,47 @@
+/*
+ * ------------------------------------------------------------------------------------------------------------
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ * Copyright (c) 2018-2020 Lawrence Livermore National Security LLC
+ * Copyright (c) 2018-2020 The Board of Trustees of the Leland Stanford Junior University
+ * Copyright (c) 2018-2020 Total, S.A
+ * Copyright (c) 2020-     GEOSX Contributors
+ * All right reserved
+ *
+ * See top level LICENSE, COPYRIGHT, CONTRIBUTORS, NOTICE, and ACKNOWLEDGEMENTS files for details.
+ * ------------------------------------------------------------------------------------------------------------
+ */
+
+#pragma once
+#include <cstdint>
+#include <string>
+
+namespace PAMELA
+{
+
+  class Mesh;
+
+  /**
+   * \brief Binary checkpoint of a mesh (.pmesh).
+   * Points, elements (type, vertex offsets and connectivity), collections with their groups, properties and
+   * cached adjacencies (CSR arrays) are stored as a sequence of blocks, each an 8-byte aligned array preceded
+   * by its length and element size, so that the file can be mapped as is and reading it back is a few large reads.
+   * A partitioned mesh is saved and read back as the partition of the calling rank.
+   */
+  class MeshCheckpoint
+  {
+
+  public:
+
+    //2: owner partition of the elements
+    static const std::uint32_t VERSION = 2;
+
+    static void Save(Mesh* mesh, const std::string& path);
+    static Mesh* Load(const std::string& path);
+
+  private:
+    MeshCheckpoint() = delete;
+
+  };
+
+}
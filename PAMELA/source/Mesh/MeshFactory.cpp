@@ -19,9 +19,87 @@
 #include "Mesh/CartesianMesh.hpp"
 #include "Import/Gmsh_mesh.hpp"
 #include "Utils/File.hpp"
+#include "Mesh/MeshCheckpoint.hpp"
+#include "Parallel/Communicator.hpp"
+#include "Utils/Statistics.hpp"
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
 
 namespace PAMELA
 {
+	namespace
+	{
+		//FNV-1a
+		void Hash(std::uint64_t& hash, const char* data, std::size_t size)
+		{
+			for (std::size_t i = 0; i != size; ++i)
+			{
+				hash ^= static_cast<unsigned char>(data[i]);
+				hash *= 1099511628211ULL;
+			}
+		}
+
+		//Hash of the content of a file, false if it cannot be read
+		bool HashFile(std::uint64_t& hash, const std::string& file_path)
+		{
+			std::ifstream file(file_path, std::ios::in | std::ios::binary);
+			if (!file)
+			{
+				return false;
+			}
+			std::vector<char> buffer(1 << 20);
+			while (file)
+			{
+				file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+				Hash(hash, buffer.data(), static_cast<std::size_t>(file.gcount()));
+			}
+			return true;
+		}
+
+		//Key of the partitions of a mesh, computed on rank 0 which reads the input file. The files included by a GRDECL deck
+		//are part of it, as the grid usually lives in them.
+		std::string PartitionKey(const std::string& file_path, const std::string& settings)
+		{
+			std::uint64_t message[2] = { 14695981039346656037ULL, 0 };
+			std::uint64_t& hash = message[0];
+			std::uint64_t& failed = message[1];
+			if (Communicator::worldRank() == 0)
+			{
+				failed = HashFile(hash, file_path) ? 0 : 1;
+				File file(file_path);
+				if ((failed == 0) && ((file.getExtension() == "grdecl") || (file.getExtension() == "GRDECL")))
+				{
+					std::ifstream deck(file_path);
+					std::string content{ std::istreambuf_iterator<char>(deck), std::istreambuf_iterator<char>() };
+					for (auto& include : Eclipse_mesh::IncludedFiles(file, content))
+					{
+						Hash(hash, include.data(), include.size());
+						if (!HashFile(hash, include))
+						{
+							failed = 1;
+							break;
+						}
+					}
+				}
+				Hash(hash, settings.data(), settings.size());
+			}
+#ifdef WITH_MPI
+			//Every rank fails together if rank 0 cannot read the deck
+			MPI_Bcast(message, 2, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+#endif
+			if (failed != 0)
+			{
+				LOGERROR("Cannot read " + file_path + " or a file it includes");
+			}
+			std::ostringstream key;
+			key << std::hex << std::setw(16) << std::setfill('0') << hash;
+			return key.str();
+		}
+	}
+
 	/**
 	 * \brief
 	 * \param file_path
@@ -29,6 +107,7 @@ namespace PAMELA
 	 */
 	Mesh* MeshFactory::makeMesh(std::string file_path)
 	{
+		PAMELA_REGION("MeshFactory::makeMesh");
 		LOGINFO("**********************************************************************");
 		LOGINFO("                         PAMELA Library Import tool                   ");
 		LOGINFO("**********************************************************************");
@@ -67,6 +146,12 @@ namespace PAMELA
 			return meshBuilder.CreateMeshFromEclipseBinaryFiles(file);
 		}
 
+		if ((file_extension == "pmesh") || (file_extension == "PMESH"))
+		{
+			LOGINFO("PAMELA MESH CHECKPOINT IDENTIFIED");
+			return MeshCheckpoint::Load(file_path);
+		}
+
 		LOGERROR("Mesh file format ." + file_extension + " not supported");
 		return nullptr;
 
@@ -84,6 +169,7 @@ namespace PAMELA
 	 */
 	Mesh* MeshFactory::makeMesh(int nx, int ny, int nz, double dx, double dy, double dz)
 	{
+		PAMELA_REGION("MeshFactory::makeMesh");
 
 		std::vector<double> vdx, vdy, vdz;
 		for (auto i = 0; i < nx; ++i)
@@ -102,4 +188,40 @@ namespace PAMELA
 		return new CartesianMesh(vdx, vdy, vdz);
 
 	}
+
+	std::string MeshFactory::partitionCacheFile(std::string file_path, const std::string& cacheDirectory, ELEMENTS::FAMILY edgeElement, ELEMENTS::FAMILY ghostBaseElement,
+		const std::string& partitioningType)
+	{
+		auto nPartition = Communicator::worldSize();
+		auto ipartition = Communicator::worldRank();
+		std::string settings = partitioningType + " " + std::to_string(static_cast<int>(edgeElement)) + " " + std::to_string(static_cast<int>(ghostBaseElement))
+			+ " " + std::to_string(nPartition) + " " + std::to_string(MeshCheckpoint::VERSION);
+		return cacheDirectory + "/" + File(file_path).getNameWithoutExtension() + "_" + PartitionKey(file_path, settings)
+			+ "_" + std::to_string(nPartition) + "_" + std::to_string(ipartition) + ".pmesh";
+	}
+
+	Mesh* MeshFactory::makePartitionedMesh(std::string file_path, const std::string& cacheDirectory, ELEMENTS::FAMILY edgeElement, ELEMENTS::FAMILY ghostBaseElement,
+		const std::string& partitioningType)
+	{
+		PAMELA_REGION("MeshFactory::makePartitionedMesh");
+		std::string partitionFile = partitionCacheFile(file_path, cacheDirectory, edgeElement, ghostBaseElement, partitioningType);
+
+		//Import is collective, the cache is only used if every partition is there
+		int cached = File(partitionFile).exists() ? 1 : 0;
+#ifdef WITH_MPI
+		MPI_Allreduce(MPI_IN_PLACE, &cached, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+#endif
+		if (cached == 1)
+		{
+			LOGINFO("Partition read from " + partitionFile);
+			return MeshCheckpoint::Load(partitionFile);
+		}
+
+		Mesh* mesh = makeMesh(file_path);
+		mesh->SetPartitioning(partitioningType);
+		mesh->CreateFacesFromCells();
+		mesh->PerformPolyhedronPartitioning(edgeElement, ghostBaseElement);
+		mesh->Save(partitionFile);
+		return mesh;
+	}
 }
@@ -30,6 +30,18 @@ namespace PAMELA
 		static Mesh* makeMesh(std::string file_path);
 		static Mesh* makeMesh(int nx, int ny, int nz, double dx, double dy, double dz);
 
+		//Mesh of the calling rank once faces are created and polyhedra are partitioned. Each partition is saved in cacheDirectory
+		//under a key made of the content of the input file and of the files it includes, the partitioner settings and the number
+		//of ranks, so that later runs with the same rank count read it back instead of importing and partitioning the mesh.
+		static Mesh* makePartitionedMesh(std::string file_path, const std::string& cacheDirectory,
+			ELEMENTS::FAMILY edgeElement = ELEMENTS::FAMILY::POLYGON, ELEMENTS::FAMILY ghostBaseElement = ELEMENTS::FAMILY::POLYGON,
+			const std::string& partitioningType = "METIS");
+
+		//Checkpoint of the partition of the calling rank used by makePartitionedMesh. Collective.
+		static std::string partitionCacheFile(std::string file_path, const std::string& cacheDirectory,
+			ELEMENTS::FAMILY edgeElement = ELEMENTS::FAMILY::POLYGON, ELEMENTS::FAMILY ghostBaseElement = ELEMENTS::FAMILY::POLYGON,
+			const std::string& partitioningType = "METIS");
+
 	private:
 		MeshFactory() = delete;
 
@@ -0,0 +1,396 @@
+/*
+ * ------------------------------------------------------------------------------------------------------------
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ * Copyright (c) 2018-2020 Lawrence Livermore National Security LLC
+ * Copyright (c) 2018-2020 The Board of Trustees of the Leland Stanford Junior University
+ * Copyright (c) 2018-2020 Total, S.A
+ * Copyright (c) 2020-     GEOSX Contributors
+ * All right reserved
+ *
+ * See top level LICENSE, COPYRIGHT, CONTRIBUTORS, NOTICE, and ACKNOWLEDGEMENTS files for details.
+ * ------------------------------------------------------------------------------------------------------------
+ */
+
+#include "Mesh/MeshGeometry.hpp"
+#include <cmath>
+#include "Utils/Logger.hpp"
+#include "Utils/ThreadUtils.hpp"
+#include "Elements/ShapeFunctions.hpp"
+
+namespace PAMELA
+{
+
+  namespace geometry
+  {
+
+    namespace
+    {
+      // Elements of a given type are processed BATCH_SIZE at a time with the lane loop innermost,
+      // so that the compiler can vectorize the kernels over elements.
+      constexpr int BATCH_SIZE = 8;
+
+      // Below this number of elements of a type the batches are processed on the calling thread only.
+      constexpr std::size_t PARALLEL_THRESHOLD = 1 << 16;
+
+      template <int NV>
+      struct Batch
+      {
+        double x[NV][BATCH_SIZE];
+        double y[NV][BATCH_SIZE];
+        double z[NV][BATCH_SIZE];
+      };
+
+      template <ELEMENTS::TYPE elementType>
+      using ElementBatch = Batch<shape::ShapeFunctions<elementType>::nVertex>;
+
+      /**
+       * \brief Per-batch results of the cell kernels
+       */
+      struct CellBatchResult
+      {
+        double volume[BATCH_SIZE];
+        double centroid[3][BATCH_SIZE];
+      };
+
+      /**
+       * \brief Per-batch results of the face kernels
+       */
+      struct FaceBatchResult
+      {
+        double area[BATCH_SIZE];
+        double center[3][BATCH_SIZE];
+        double normal[3][BATCH_SIZE];
+      };
+
+      // Jacobian matrix J[coordinate][reference direction][lane] for basis function derivatives dN[vertex][direction]
+      template <int NV, int DIM, typename Derivatives>
+      void Jacobian(const Batch<NV>& batch, const Derivatives& dN, double (&J)[3][DIM][BATCH_SIZE])
+      {
+        for (int c = 0; c != 3; ++c)
+        {
+          for (int d = 0; d != DIM; ++d)
+          {
+            for (int l = 0; l != BATCH_SIZE; ++l)
+            {
+              J[c][d][l] = 0;
+            }
+          }
+        }
+        for (int v = 0; v != NV; ++v)
+        {
+          for (int d = 0; d != DIM; ++d)
+          {
+            const double dNvd = dN[v][d];
+            for (int l = 0; l != BATCH_SIZE; ++l)
+            {
+              J[0][d][l] += batch.x[v][l] * dNvd;
+              J[1][d][l] += batch.y[v][l] * dNvd;
+              J[2][d][l] += batch.z[v][l] * dNvd;
+            }
+          }
+        }
+      }
+
+      // Image of the reference center, given the basis function values N at the center
+      template <int NV, typename Values>
+      void MapCenter(const Batch<NV>& batch, const Values& N, double (&center)[3][BATCH_SIZE])
+      {
+        for (int l = 0; l != BATCH_SIZE; ++l)
+        {
+          center[0][l] = 0; center[1][l] = 0; center[2][l] = 0;
+        }
+        for (int v = 0; v != NV; ++v)
+        {
+          for (int l = 0; l != BATCH_SIZE; ++l)
+          {
+            center[0][l] += batch.x[v][l] * N[v];
+            center[1][l] += batch.y[v][l] * N[v];
+            center[2][l] += batch.z[v][l] * N[v];
+          }
+        }
+      }
+
+      // Volume by Gauss integration of the Jacobian determinant, centroid as the image of the reference center
+      template <ELEMENTS::TYPE elementType>
+      void ComputeBatch(const ElementBatch<elementType>& batch, CellBatchResult& result)
+      {
+        typedef shape::ShapeFunctions<elementType> Shape;
+        static constexpr auto table = shape::MakeGaussTable<elementType>();
+
+        for (int l = 0; l != BATCH_SIZE; ++l)
+        {
+          result.volume[l] = 0;
+        }
+        for (int g = 0; g != Shape::nGauss; ++g)
+        {
+          double J[3][3][BATCH_SIZE];
+          Jacobian(batch, table.dN[g], J);
+          const double weight = table.weight[g];
+          for (int l = 0; l != BATCH_SIZE; ++l)
+          {
+            result.volume[l] += weight * (J[0][0][l] * (J[1][1][l] * J[2][2][l] - J[2][1][l] * J[1][2][l])
+              - J[0][1][l] * (J[1][0][l] * J[2][2][l] - J[2][0][l] * J[1][2][l])
+              + J[0][2][l] * (J[1][0][l] * J[2][1][l] - J[2][0][l] * J[1][1][l]));
+          }
+        }
+        for (int l = 0; l != BATCH_SIZE; ++l)
+        {
+          result.volume[l] = std::fabs(result.volume[l]);
+        }
+        MapCenter(batch, table.centerN, result.centroid);
+      }
+
+      // Area by Gauss integration of the norm of the Jacobian cross product, unit normal and center at the reference center
+      template <ELEMENTS::TYPE elementType>
+      void ComputeBatch(const ElementBatch<elementType>& batch, FaceBatchResult& result)
+      {
+        typedef shape::ShapeFunctions<elementType> Shape;
+        static constexpr auto table = shape::MakeGaussTable<elementType>();
+
+        double J[3][2][BATCH_SIZE];
+        for (int l = 0; l != BATCH_SIZE; ++l)
+        {
+          result.area[l] = 0;
+        }
+        for (int g = 0; g != Shape::nGauss; ++g)
+        {
+          Jacobian(batch, table.dN[g], J);
+          const double weight = table.weight[g];
+          for (int l = 0; l != BATCH_SIZE; ++l)
+          {
+            double cx = J[1][0][l] * J[2][1][l] - J[2][0][l] * J[1][1][l];
+            double cy = J[2][0][l] * J[0][1][l] - J[0][0][l] * J[2][1][l];
+            double cz = J[0][0][l] * J[1][1][l] - J[1][0][l] * J[0][1][l];
+            result.area[l] += weight * std::sqrt(cx * cx + cy * cy + cz * cz);
+          }
+        }
+
+        Jacobian(batch, table.centerDN, J);
+        for (int l = 0; l != BATCH_SIZE; ++l)
+        {
+          double cx = J[1][0][l] * J[2][1][l] - J[2][0][l] * J[1][1][l];
+          double cy = J[2][0][l] * J[0][1][l] - J[0][0][l] * J[2][1][l];
+          double cz = J[0][0][l] * J[1][1][l] - J[1][0][l] * J[0][1][l];
+          double norm = std::sqrt(cx * cx + cy * cy + cz * cz);
+          double inv = norm > 0 ? 1. / norm : 0.;
+          result.normal[0][l] = cx * inv;
+          result.normal[1][l] = cy * inv;
+          result.normal[2][l] = cz * inv;
+        }
+        MapCenter(batch, table.centerN, result.center);
+      }
+
+      /**
+       * \brief Run the kernel of elementType over the elements listed in ids, BATCH_SIZE at a time.
+       * The last batch is padded with copies of its last element, store(index, result, lane) is called for the valid lanes only.
+       */
+      template <ELEMENTS::TYPE elementType, typename Result, typename ElementCollectionType, typename Store>
+      void RunBatches(const PointCoordinates& coordinates, ElementCollectionType& collection, const std::vector<int>& ids, Store store)
+      {
+        const int NV = shape::ShapeFunctions<elementType>::nVertex;
+        if (ids.empty())
+        {
+          return;
+        }
+        std::size_t nBatch = (ids.size() + BATCH_SIZE - 1) / BATCH_SIZE;
+        int nThreads = ids.size() >= PARALLEL_THRESHOLD ? threadUtils::NumberOfThreads() : 1;
+
+        threadUtils::ParallelChunks(nBatch, nThreads, [&](int, std::size_t begin, std::size_t end)
+        {
+          ElementBatch<elementType> batch;
+          Result result;
+          for (std::size_t b = begin; b != end; ++b)
+          {
+            std::size_t first = b * BATCH_SIZE;
+            int n = static_cast<int>(std::min<std::size_t>(BATCH_SIZE, ids.size() - first));
+            for (int l = 0; l != BATCH_SIZE; ++l)
+            {
+              const auto& vertexList = collection[ids[first + std::min(l, n - 1)]]->get_vertexList();
+              for (int v = 0; v != NV; ++v)
+              {
+                auto p = vertexList[v]->get_localIndex();
+                batch.x[v][l] = coordinates.x[p];
+                batch.y[v][l] = coordinates.y[p];
+                batch.z[v][l] = coordinates.z[p];
+              }
+            }
+            ComputeBatch<elementType>(batch, result);
+            for (int l = 0; l != n; ++l)
+            {
+              store(ids[first + l], result, l);
+            }
+          }
+        });
+      }
+    }
+
+    void CellGeometry::clear()
+    {
+      volume.clear();
+      centroidX.clear(); centroidY.clear(); centroidZ.clear();
+    }
+
+    void FaceGeometry::clear()
+    {
+      area.clear();
+      centerX.clear(); centerY.clear(); centerZ.clear();
+      normalX.clear(); normalY.clear(); normalZ.clear();
+    }
+
+    PointCoordinates GatherPointCoordinates(PointCollection& points)
+    {
+      PointCoordinates coordinates;
+      auto n = points.size_all();
+      coordinates.x.resize(n);
+      coordinates.y.resize(n);
+      coordinates.z.resize(n);
+      for (std::size_t i = 0; i != n; ++i)
+      {
+        const auto& xyz = points[i]->get_coordinates();
+        coordinates.x[i] = xyz.x;
+        coordinates.y[i] = xyz.y;
+        coordinates.z[i] = xyz.z;
+      }
+      return coordinates;
+    }
+
+    void ComputePolyhedronGeometry(const PointCoordinates& coordinates, PolyhedronCollection& polyhedra, CellGeometry& geometry)
+    {
+      auto n = polyhedra.size_all();
+      geometry.volume.assign(n, 0.);
+      geometry.centroidX.assign(n, 0.);
+      geometry.centroidY.assign(n, 0.);
+      geometry.centroidZ.assign(n, 0.);
+
+      //Sort by type
+      std::vector<int> tetra, hexa, wedge, pyramid;
+      for (std::size_t i = 0; i != n; ++i)
+      {
+        switch (polyhedra[i]->get_vtkType())
+        {
+        case ELEMENTS::TYPE::VTK_TETRA: tetra.push_back(static_cast<int>(i)); break;
+        case ELEMENTS::TYPE::VTK_HEXAHEDRON: hexa.push_back(static_cast<int>(i)); break;
+        case ELEMENTS::TYPE::VTK_WEDGE: wedge.push_back(static_cast<int>(i)); break;
+        case ELEMENTS::TYPE::VTK_PYRAMID: pyramid.push_back(static_cast<int>(i)); break;
+        default: LOGERROR("Unsupported polyhedron type for geometry computation");
+        }
+      }
+
+      auto store = [&geometry](int i, const CellBatchResult& result, int l)
+      {
+        geometry.volume[i] = result.volume[l];
+        geometry.centroidX[i] = result.centroid[0][l];
+        geometry.centroidY[i] = result.centroid[1][l];
+        geometry.centroidZ[i] = result.centroid[2][l];
+      };
+      RunBatches<ELEMENTS::TYPE::VTK_TETRA, CellBatchResult>(coordinates, polyhedra, tetra, store);
+      RunBatches<ELEMENTS::TYPE::VTK_HEXAHEDRON, CellBatchResult>(coordinates, polyhedra, hexa, store);
+      RunBatches<ELEMENTS::TYPE::VTK_WEDGE, CellBatchResult>(coordinates, polyhedra, wedge, store);
+      RunBatches<ELEMENTS::TYPE::VTK_PYRAMID, CellBatchResult>(coordinates, polyhedra, pyramid, store);
+    }
+
+    void ComputePolygonGeometry(const PointCoordinates& coordinates, PolygonCollection& polygons, FaceGeometry& geometry)
+    {
+      auto n = polygons.size_all();
+      geometry.area.assign(n, 0.);
+      geometry.centerX.assign(n, 0.);
+      geometry.centerY.assign(n, 0.);
+      geometry.centerZ.assign(n, 0.);
+      geometry.normalX.assign(n, 0.);
+      geometry.normalY.assign(n, 0.);
+      geometry.normalZ.assign(n, 0.);
+
+      //Sort by type
+      std::vector<int> triangle, quad;
+      for (std::size_t i = 0; i != n; ++i)
+      {
+        switch (polygons[i]->get_vtkType())
+        {
+        case ELEMENTS::TYPE::VTK_TRIANGLE: triangle.push_back(static_cast<int>(i)); break;
+        case ELEMENTS::TYPE::VTK_QUAD: quad.push_back(static_cast<int>(i)); break;
+        default: LOGERROR("Unsupported polygon type for geometry computation");
+        }
+      }
+
+      auto store = [&geometry](int i, const FaceBatchResult& result, int l)
+      {
+        geometry.area[i] = result.area[l];
+        geometry.centerX[i] = result.center[0][l];
+        geometry.centerY[i] = result.center[1][l];
+        geometry.centerZ[i] = result.center[2][l];
+        geometry.normalX[i] = result.normal[0][l];
+        geometry.normalY[i] = result.normal[1][l];
+        geometry.normalZ[i] = result.normal[2][l];
+      };
+      RunBatches<ELEMENTS::TYPE::VTK_TRIANGLE, FaceBatchResult>(coordinates, polygons, triangle, store);
+      RunBatches<ELEMENTS::TYPE::VTK_QUAD, FaceBatchResult>(coordinates, polygons, quad, store);
+    }
+
+    const PointCoordinates& GeometryCache::get_PointCoordinates(PointCollection& points)
+    {
+      if (!m_pointCoordinatesValid || m_pointCoordinates.size() != points.size_all())
+      {
+        m_pointCoordinates = GatherPointCoordinates(points);
+        m_pointCoordinatesValid = true;
+      }
+      return m_pointCoordinates;
+    }
+
+    const CellGeometry& GeometryCache::get_CellGeometry(PointCollection& points, PolyhedronCollection& polyhedra)
+    {
+      if (m_cellGeometryValid && m_cellGeometry.size() == polyhedra.size_all())
+      {
+        ++m_hits;
+        return m_cellGeometry;
+      }
+      ++m_misses;
+      ComputePolyhedronGeometry(get_PointCoordinates(points), polyhedra, m_cellGeometry);
+      m_cellGeometryValid = true;
+      return m_cellGeometry;
+    }
+
+    const FaceGeometry& GeometryCache::get_FaceGeometry(PointCollection& points, PolygonCollection& polygons)
+    {
+      if (m_faceGeometryValid && m_faceGeometry.size() == polygons.size_all())
+      {
+        ++m_hits;
+        return m_faceGeometry;
+      }
+      ++m_misses;
+      ComputePolygonGeometry(get_PointCoordinates(points), polygons, m_faceGeometry);
+      m_faceGeometryValid = true;
+      return m_faceGeometry;
+    }
+
+    void GeometryCache::Invalidate()
+    {
+      m_pointCoordinatesValid = false;
+      m_cellGeometryValid = false;
+      m_faceGeometryValid = false;
+    }
+
+    void GeometryCache::Release()
+    {
+      Invalidate();
+      m_pointCoordinates = PointCoordinates();
+      m_cellGeometry = CellGeometry();
+      m_faceGeometry = FaceGeometry();
+    }
+
+    std::size_t GeometryCache::get_MemoryFootprint() const
+    {
+      std::size_t nvalues = 0;
+      for (auto v : { &m_pointCoordinates.x, &m_pointCoordinates.y, &m_pointCoordinates.z,
+        &m_cellGeometry.volume, &m_cellGeometry.centroidX, &m_cellGeometry.centroidY, &m_cellGeometry.centroidZ,
+        &m_faceGeometry.area, &m_faceGeometry.centerX, &m_faceGeometry.centerY, &m_faceGeometry.centerZ,
+        &m_faceGeometry.normalX, &m_faceGeometry.normalY, &m_faceGeometry.normalZ })
+      {
+        nvalues += v->capacity();
+      }
+      return sizeof(GeometryCache) + nvalues * sizeof(double);
+    }
+
+  }
+
+}
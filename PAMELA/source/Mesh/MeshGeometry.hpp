@@ -0,0 +1,109 @@
+/*
+ * ------------------------------------------------------------------------------------------------------------
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ * Copyright (c) 2018-2020 Lawrence Livermore National Security LLC
+ * Copyright (c) 2018-2020 The Board of Trustees of the Leland Stanford Junior University
+ * Copyright (c) 2018-2020 Total, S.A
+ * Copyright (c) 2020-     GEOSX Contributors
+ * All right reserved
+ *
+ * See top level LICENSE, COPYRIGHT, CONTRIBUTORS, NOTICE, and ACKNOWLEDGEMENTS files for details.
+ * ------------------------------------------------------------------------------------------------------------
+ */
+
+#pragma once
+#include <vector>
+#include "Collection/Collection.hpp"
+
+namespace PAMELA
+{
+
+  namespace geometry
+  {
+
+    /**
+     * \brief Point coordinates in structure-of-arrays layout, indexed by point local index.
+     */
+    struct PointCoordinates
+    {
+      std::vector<double> x, y, z;
+      std::size_t size() const { return x.size(); }
+    };
+
+    /**
+     * \brief Volumes and centroids of the polyhedra, indexed by polyhedron local index.
+     */
+    struct CellGeometry
+    {
+      std::vector<double> volume;
+      std::vector<double> centroidX, centroidY, centroidZ;
+      std::size_t size() const { return volume.size(); }
+      void clear();
+    };
+
+    /**
+     * \brief Areas, unit normals and centers of the polygons, indexed by polygon local index.
+     */
+    struct FaceGeometry
+    {
+      std::vector<double> area;
+      std::vector<double> centerX, centerY, centerZ;
+      std::vector<double> normalX, normalY, normalZ;
+      std::size_t size() const { return area.size(); }
+      void clear();
+    };
+
+    PointCoordinates GatherPointCoordinates(PointCollection& points);
+
+    /**
+     * \brief Compute the geometry of all the polyhedra (owned and ghosts).
+     * Cells are sorted by type and processed in fixed-size batches with no allocation inside the kernels.
+     */
+    void ComputePolyhedronGeometry(const PointCoordinates& coordinates, PolyhedronCollection& polyhedra, CellGeometry& geometry);
+
+    /**
+     * \brief Compute the geometry of all the polygons (owned and ghosts).
+     */
+    void ComputePolygonGeometry(const PointCoordinates& coordinates, PolygonCollection& polygons, FaceGeometry& geometry);
+
+    /**
+     * \brief Geometry of a mesh, filled lazily and kept until invalidated.
+     * Invalidate whenever point coordinates or element collections change. As a safeguard an entry whose size no
+     * longer matches its collection is recomputed.
+     */
+    class GeometryCache
+    {
+    public:
+
+      const CellGeometry& get_CellGeometry(PointCollection& points, PolyhedronCollection& polyhedra);
+      const FaceGeometry& get_FaceGeometry(PointCollection& points, PolygonCollection& polygons);
+
+      void Invalidate();
+      // Invalidate and free the storage, e.g. once the collections are shrunk by the partitioning
+      void Release();
+
+      std::size_t get_MemoryFootprint() const;
+
+      //Statistics
+      std::size_t get_Hits() const { return m_hits; }
+      std::size_t get_Misses() const { return m_misses; }
+
+    private:
+
+      const PointCoordinates& get_PointCoordinates(PointCollection& points);
+
+      PointCoordinates m_pointCoordinates;
+      CellGeometry m_cellGeometry;
+      FaceGeometry m_faceGeometry;
+      bool m_pointCoordinatesValid = false;
+      bool m_cellGeometryValid = false;
+      bool m_faceGeometryValid = false;
+
+      std::size_t m_hits = 0;
+      std::size_t m_misses = 0;
+    };
+
+  }
+
+}
@@ -0,0 +1,154 @@
+/*
+ * ------------------------------------------------------------------------------------------------------------
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ * Copyright (c) 2018-2020 Lawrence Livermore National Security LLC
+ * Copyright (c) 2018-2020 The Board of Trustees of the Leland Stanford Junior University
+ * Copyright (c) 2018-2020 Total, S.A
+ * Copyright (c) 2020-     GEOSX Contributors
+ * All right reserved
+ *
+ * See top level LICENSE, COPYRIGHT, CONTRIBUTORS, NOTICE, and ACKNOWLEDGEMENTS files for details.
+ * ------------------------------------------------------------------------------------------------------------
+ */
+
+#include "Mesh/MeshView.hpp"
+#include "Adjacency/Adjacency.hpp"
+#include "Utils/Logger.hpp"
+
+namespace PAMELA
+{
+
+  namespace
+  {
+    int GhostRank(const ElementBase* element)
+    {
+      return element->get_IsGhost() ? element->get_partitionOwner() : -1;
+    }
+
+    //One block per element type, in order of first appearance in the collection
+    template <class ElementCollectionType>
+    std::vector<MeshView::ElementBlock> PackElements(ElementCollectionType& collection)
+    {
+      std::vector<MeshView::ElementBlock> blocks;
+      std::vector<std::size_t> blockIndex(collection.size_all());
+      std::vector<std::size_t> blockSize;
+      for (std::size_t i = 0; i != collection.size_all(); ++i)
+      {
+        auto type = collection[i]->get_vtkType();
+        std::size_t b = 0;
+        while ((b != blocks.size()) && (blocks[b].Type != type))
+        {
+          ++b;
+        }
+        if (b == blocks.size())
+        {
+          blocks.emplace_back();
+          blocks[b].Type = type;
+          blocks[b].nVertex = static_cast<int>(collection[i]->get_vertexList().size());
+          blockSize.push_back(0);
+        }
+        blockIndex[i] = b;
+        ++blockSize[b];
+      }
+
+      for (std::size_t b = 0; b != blocks.size(); ++b)
+      {
+        blocks[b].Connectivity.reserve(blockSize[b] * blocks[b].nVertex);
+        blocks[b].LocalIndex.reserve(blockSize[b]);
+        blocks[b].GlobalIndex.reserve(blockSize[b]);
+        blocks[b].OwnerRank.reserve(blockSize[b]);
+        blocks[b].GhostRank.reserve(blockSize[b]);
+      }
+
+      for (std::size_t i = 0; i != collection.size_all(); ++i)
+      {
+        auto element = collection[i];
+        auto& block = blocks[blockIndex[i]];
+        for (auto vertex : element->get_vertexList())
+        {
+          block.Connectivity.push_back(vertex->get_localIndex());
+        }
+        block.LocalIndex.push_back(static_cast<int>(i));
+        block.GlobalIndex.push_back(element->get_globalIndex());
+        block.OwnerRank.push_back(element->get_partitionOwner());
+        block.GhostRank.push_back(GhostRank(element));
+      }
+      return blocks;
+    }
+
+    MeshView::CSRArrays MakeCSRArrays(Adjacency* adjacency)
+    {
+      auto csr = adjacency->get_adjacencySparseMatrix();
+      MeshView::CSRArrays arrays;
+      arrays.nRow = static_cast<std::size_t>(csr->dimRow);
+      arrays.nColumn = static_cast<std::size_t>(csr->dimColumn);
+      arrays.RowPtr = csr->rowPtr;
+      arrays.ColumnIndex = csr->columnIndex;
+      if (csr->values.size() == csr->columnIndex.size())
+      {
+        arrays.Values = csr->values;
+      }
+      arrays.Weights = adjacency->get_Weights();
+      return arrays;
+    }
+
+    template <typename T>
+    Span<const T> PropertyValues(Property<PolyhedronCollection, T>* property, const std::string& label)
+    {
+      auto& map = property->get_PropertyMap();
+      auto it = map.find(label);
+      if (it == map.end())
+      {
+        LOGERROR("Property " + label + " does not exist");
+        return Span<const T>();
+      }
+      return it->second.data_all();
+    }
+  }
+
+  MeshView::MeshView(Mesh* mesh) : m_mesh(mesh)
+  {
+    auto points = mesh->get_PointCollection();
+    auto nPoint = points->size_all();
+    m_points.Coordinates.resize(3 * nPoint);
+    m_points.GlobalIndex.resize(nPoint);
+    m_points.OwnerRank.resize(nPoint);
+    m_points.GhostRank.resize(nPoint);
+    for (std::size_t i = 0; i != nPoint; ++i)
+    {
+      auto point = (*points)[i];
+      const auto& xyz = point->get_coordinates();
+      m_points.Coordinates[3 * i] = xyz.x;
+      m_points.Coordinates[3 * i + 1] = xyz.y;
+      m_points.Coordinates[3 * i + 2] = xyz.z;
+      m_points.GlobalIndex[i] = point->get_globalIndex();
+      m_points.OwnerRank[i] = point->get_partitionOwner();
+      m_points.GhostRank[i] = GhostRank(point);
+    }
+
+    m_polygonBlocks = PackElements(*mesh->get_PolygonCollection());
+    m_polyhedronBlocks = PackElements(*mesh->get_PolyhedronCollection());
+  }
+
+  Span<const double> MeshView::get_PolyhedronProperty_double(const std::string& label) const
+  {
+    return PropertyValues(m_mesh->get_PolyhedronProperty_double(), label);
+  }
+
+  Span<const int> MeshView::get_PolyhedronProperty_int(const std::string& label) const
+  {
+    return PropertyValues(m_mesh->get_PolyhedronProperty_int(), label);
+  }
+
+  MeshView::CSRArrays MeshView::get_TopologicalAdjacency(ELEMENTS::FAMILY source, ELEMENTS::FAMILY target, ELEMENTS::FAMILY base) const
+  {
+    return MakeCSRArrays(m_mesh->getAdjacencySet()->get_TopologicalAdjacency(source, target, base));
+  }
+
+  MeshView::CSRArrays MeshView::get_NonTopologicalAdjacency(const std::string& label) const
+  {
+    return MakeCSRArrays(m_mesh->getAdjacencySet()->get_NonTopologicalAdjacency(label));
+  }
+
+}
@@ -0,0 +1,98 @@
+/*
+ * ------------------------------------------------------------------------------------------------------------
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ * Copyright (c) 2018-2020 Lawrence Livermore National Security LLC
+ * Copyright (c) 2018-2020 The Board of Trustees of the Leland Stanford Junior University
+ * Copyright (c) 2018-2020 Total, S.A
+ * Copyright (c) 2020-     GEOSX Contributors
+ * All right reserved
+ *
+ * See top level LICENSE, COPYRIGHT, CONTRIBUTORS, NOTICE, and ACKNOWLEDGEMENTS files for details.
+ * ------------------------------------------------------------------------------------------------------------
+ */
+
+#pragma once
+#include <string>
+#include <vector>
+#include "Mesh/Mesh.hpp"
+#include "Utils/Span.hpp"
+
+namespace PAMELA
+{
+
+  /**
+   * \brief Contiguous arrays of a mesh for the codes embedding PAMELA.
+   * Points, polygons and polyhedra are packed once at construction in their local numbering (owned first, then ghosts).
+   * These arrays belong to the view: they can be copied from data() or moved out with the Release functions.
+   * Properties and adjacencies are spans over the storage of the mesh, valid until the property or the adjacency is
+   * modified (e.g. SetProperty, CreateFacesFromCells) or the mesh is destroyed.
+   */
+  class MeshView
+  {
+    public:
+
+      //Points of the point collection
+      struct PointArrays
+      {
+        std::vector<double> Coordinates;  //x, y, z per point
+        std::vector<int> GlobalIndex;
+        std::vector<int> OwnerRank;       //Partition owning the point
+        std::vector<int> GhostRank;       //-1 for owned points, owner partition of ghost ones
+      };
+
+      //Elements of a family with the same type, in the order of their collection
+      struct ElementBlock
+      {
+        ELEMENTS::TYPE Type;
+        int nVertex;
+        std::vector<int> Connectivity;    //nVertex point local indices per element
+        std::vector<int> LocalIndex;      //Position of the element in its collection
+        std::vector<int> GlobalIndex;
+        std::vector<int> OwnerRank;
+        std::vector<int> GhostRank;
+
+        std::size_t size() const { return LocalIndex.size(); }
+      };
+
+      //Arrays of an adjacency, one row per source element in its local numbering
+      struct CSRArrays
+      {
+        std::size_t nRow;
+        std::size_t nColumn;
+        Span<const Types::csr_offset_t> RowPtr;
+        Span<const Types::csr_index_t> ColumnIndex;
+        Span<const Types::csr_index_t> Values;   //Base element of each nonzero, empty if the adjacency has none
+        Span<const double> Weights;              //Empty if the adjacency is not weighted
+      };
+
+      explicit MeshView(Mesh* mesh);
+
+      const PointArrays& get_Points() const { return m_points; }
+      const std::vector<ElementBlock>& get_PolygonBlocks() const { return m_polygonBlocks; }
+      const std::vector<ElementBlock>& get_PolyhedronBlocks() const { return m_polyhedronBlocks; }
+
+      //Hand the packed arrays over to the caller, the view is left empty
+      PointArrays ReleasePoints() { return std::move(m_points); }
+      std::vector<ElementBlock> ReleasePolygonBlocks() { return std::move(m_polygonBlocks); }
+      std::vector<ElementBlock> ReleasePolyhedronBlocks() { return std::move(m_polyhedronBlocks); }
+
+      //Values per polyhedron local index, several per polyhedron for vector properties
+      Span<const double> get_PolyhedronProperty_double(const std::string& label) const;
+      Span<const int> get_PolyhedronProperty_int(const std::string& label) const;
+
+      //Built by the mesh on first request if needed
+      CSRArrays get_TopologicalAdjacency(ELEMENTS::FAMILY source, ELEMENTS::FAMILY target, ELEMENTS::FAMILY base) const;
+      CSRArrays get_NonTopologicalAdjacency(const std::string& label) const;
+
+    private:
+
+      Mesh* m_mesh;
+
+      PointArrays m_points;
+      std::vector<ElementBlock> m_polygonBlocks;
+      std::vector<ElementBlock> m_polyhedronBlocks;
+
+  };
+
+}
@@ -0,0 +1,239 @@
+/*
+ * ------------------------------------------------------------------------------------------------------------
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ * Copyright (c) 2018-2020 Lawrence Livermore National Security LLC
+ * Copyright (c) 2018-2020 The Board of Trustees of the Leland Stanford Junior University
+ * Copyright (c) 2018-2020 Total, S.A
+ * Copyright (c) 2020-     GEOSX Contributors
+ * All right reserved
+ *
+ * See top level LICENSE, COPYRIGHT, CONTRIBUTORS, NOTICE, and ACKNOWLEDGEMENTS files for details.
+ * ------------------------------------------------------------------------------------------------------------
+ */
+
+#include "Mesh/Transmissibility.hpp"
+#include <cmath>
+#include "Utils/Logger.hpp"
+#include "Utils/ThreadUtils.hpp"
+
+namespace PAMELA
+{
+
+  namespace tpfa
+  {
+
+    namespace
+    {
+      // Below this number of faces the transmissibilities are computed on the calling thread only.
+      constexpr std::size_t PARALLEL_THRESHOLD = 1 << 16;
+
+      // Conversion factor from mD to m2
+      constexpr double MILLIDARCY = 9.869233e-16;
+
+      double HalfTransmissibility(const geometry::CellGeometry& cells, const geometry::FaceGeometry& faces, const Permeability& K, int c, int f)
+      {
+        double dx = faces.centerX[f] - cells.centroidX[c];
+        double dy = faces.centerY[f] - cells.centroidY[c];
+        double dz = faces.centerZ[f] - cells.centroidZ[c];
+        double d2 = dx * dx + dy * dy + dz * dz;
+        if (d2 == 0)
+        {
+          return 0;
+        }
+        double Kdx = K.xx[c] * dx + K.xy[c] * dy + K.xz[c] * dz;
+        double Kdy = K.xy[c] * dx + K.yy[c] * dy + K.yz[c] * dz;
+        double Kdz = K.xz[c] * dx + K.yz[c] * dy + K.zz[c] * dz;
+        return faces.area[f] * std::fabs(faces.normalX[f] * Kdx + faces.normalY[f] * Kdy + faces.normalZ[f] * Kdz) / d2;
+      }
+    }
+
+    void Permeability::resize(std::size_t n)
+    {
+      xx.assign(n, 0.); yy.assign(n, 0.); zz.assign(n, 0.);
+      xy.assign(n, 0.); yz.assign(n, 0.); xz.assign(n, 0.);
+    }
+
+    Permeability GetPermeability(Property<PolyhedronCollection, double>* properties, std::size_t nPolyhedra, const std::string& label)
+    {
+      Permeability permeability;
+      permeability.resize(nPolyhedra);
+      auto& propertyMap = properties->get_PropertyMap();
+
+      if (propertyMap.count(label) == 1)
+      {
+        auto& data = propertyMap.at(label).data_all();
+        auto dimension = properties->GetProperty_dimension(label);
+        if (dimension == VARIABLE_DIMENSION::VECTOR && data.size() == 3 * nPolyhedra)
+        {
+          for (std::size_t i = 0; i != nPolyhedra; ++i)
+          {
+            permeability.xx[i] = data[3 * i];
+            permeability.yy[i] = data[3 * i + 1];
+            permeability.zz[i] = data[3 * i + 2];
+          }
+        }
+        else if (dimension == VARIABLE_DIMENSION::TENSOR_SYMM && data.size() == 6 * nPolyhedra)
+        {
+          for (std::size_t i = 0; i != nPolyhedra; ++i)
+          {
+            permeability.xx[i] = data[6 * i];
+            permeability.yy[i] = data[6 * i + 1];
+            permeability.zz[i] = data[6 * i + 2];
+            permeability.xy[i] = data[6 * i + 3];
+            permeability.yz[i] = data[6 * i + 4];
+            permeability.xz[i] = data[6 * i + 5];
+          }
+        }
+        else
+        {
+          LOGERROR("Permeability property " + label + " should be a vector or a symmetric tensor defined on every polyhedron");
+        }
+      }
+      else if (propertyMap.count("PERMX") == 1 && propertyMap.count("PERMY") == 1 && propertyMap.count("PERMZ") == 1)
+      {
+        auto& permx = propertyMap.at("PERMX").data_all();
+        auto& permy = propertyMap.at("PERMY").data_all();
+        auto& permz = propertyMap.at("PERMZ").data_all();
+        ASSERT(permx.size() == nPolyhedra && permy.size() == nPolyhedra && permz.size() == nPolyhedra, "PERMX/Y/Z should be defined on every polyhedron");
+        for (std::size_t i = 0; i != nPolyhedra; ++i)
+        {
+          permeability.xx[i] = permx[i] * MILLIDARCY;
+          permeability.yy[i] = permy[i] * MILLIDARCY;
+          permeability.zz[i] = permz[i] * MILLIDARCY;
+        }
+      }
+      else
+      {
+        LOGERROR("No permeability found, expected " + label + " or PERMX, PERMY and PERMZ");
+      }
+
+      return permeability;
+    }
+
+    void ComputeTransmissibilities(const geometry::CellGeometry& cells, const geometry::FaceGeometry& faces, const CSRMatrix& faceToCell,
+                                   const Permeability& permeability, CSRMatrix& connections, std::vector<double>& transmissibilities)
+    {
+      typedef CSRMatrix::offset_type offset_type;
+      typedef CSRMatrix::index_type index_type;
+
+      ASSERT(static_cast<std::size_t>(faceToCell.dimRow) == faces.size(), "Face geometry does not match the face to cell adjacency");
+      ASSERT(permeability.size() == cells.size(), "Permeability does not match the cell geometry");
+
+      const auto nFaces = static_cast<std::size_t>(faceToCell.dimRow);
+      const auto nCells = static_cast<index_type>(cells.size());
+      const auto& faceRowPtr = faceToCell.rowPtr;
+      const auto& faceColumns = faceToCell.columnIndex;
+
+      //Transmissibility of each interior face
+      std::vector<double> faceTransmissibility(nFaces, 0.);
+      int nThreads = nFaces >= PARALLEL_THRESHOLD ? threadUtils::NumberOfThreads() : 1;
+      threadUtils::ParallelChunks(nFaces, nThreads, [&](int, std::size_t begin, std::size_t end)
+      {
+        for (std::size_t f = begin; f != end; ++f)
+        {
+          if (faceRowPtr[f + 1] - faceRowPtr[f] != 2)
+          {
+            continue;
+          }
+          auto c1 = faceColumns[faceRowPtr[f]];
+          auto c2 = faceColumns[faceRowPtr[f] + 1];
+          double t1 = HalfTransmissibility(cells, faces, permeability, c1, static_cast<int>(f));
+          double t2 = HalfTransmissibility(cells, faces, permeability, c2, static_cast<int>(f));
+          faceTransmissibility[f] = t1 + t2 > 0 ? t1 * t2 / (t1 + t2) : 0.;
+        }
+      });
+
+      //Symmetric cell to cell matrix, both directions of each interior face
+      connections = CSRMatrix(nCells, nCells);
+      auto& rowPtr = connections.rowPtr;
+      for (std::size_t f = 0; f != nFaces; ++f)
+      {
+        if (faceRowPtr[f + 1] - faceRowPtr[f] == 2)
+        {
+          ++rowPtr[faceColumns[faceRowPtr[f]] + 1];
+          ++rowPtr[faceColumns[faceRowPtr[f] + 1] + 1];
+        }
+      }
+      for (index_type i = 0; i != nCells; ++i)
+      {
+        rowPtr[i + 1] += rowPtr[i];
+      }
+
+      auto nnz = rowPtr[nCells];
+      connections.columnIndex.resize(nnz);
+      transmissibilities.resize(nnz);
+      std::vector<offset_type> cursor(rowPtr.begin(), rowPtr.end() - 1);
+      for (std::size_t f = 0; f != nFaces; ++f)
+      {
+        if (faceRowPtr[f + 1] - faceRowPtr[f] == 2)
+        {
+          auto c1 = faceColumns[faceRowPtr[f]];
+          auto c2 = faceColumns[faceRowPtr[f] + 1];
+          connections.columnIndex[cursor[c1]] = c2;
+          transmissibilities[cursor[c1]++] = faceTransmissibility[f];
+          connections.columnIndex[cursor[c2]] = c1;
+          transmissibilities[cursor[c2]++] = faceTransmissibility[f];
+        }
+      }
+
+      //Sort the (short) rows and sum the connections through several faces
+      std::vector<index_type> rowLength(nCells);
+      nThreads = static_cast<std::size_t>(nnz) >= PARALLEL_THRESHOLD ? threadUtils::NumberOfThreads() : 1;
+      threadUtils::ParallelChunks(nCells, nThreads, [&](int, index_type begin, index_type end)
+      {
+        auto& columns = connections.columnIndex;
+        for (index_type i = begin; i != end; ++i)
+        {
+          auto first = rowPtr[i];
+          auto last = rowPtr[i + 1];
+          for (auto j = first + 1; j < last; ++j)
+          {
+            auto column = columns[j];
+            auto weight = transmissibilities[j];
+            auto k = j;
+            for (; k > first && columns[k - 1] > column; --k)
+            {
+              columns[k] = columns[k - 1];
+              transmissibilities[k] = transmissibilities[k - 1];
+            }
+            columns[k] = column;
+            transmissibilities[k] = weight;
+          }
+          auto out = first;
+          for (auto j = first; j < last; ++j)
+          {
+            if (out != first && columns[out - 1] == columns[j])
+            {
+              transmissibilities[out - 1] += transmissibilities[j];
+              continue;
+            }
+            columns[out] = columns[j];
+            transmissibilities[out++] = transmissibilities[j];
+          }
+          rowLength[i] = static_cast<index_type>(out - first);
+        }
+      });
+
+      //Compact rows that had duplicates
+      offset_type out = 0;
+      for (index_type i = 0; i != nCells; ++i)
+      {
+        auto first = rowPtr[i];
+        rowPtr[i] = out;
+        for (offset_type j = first; j != first + rowLength[i]; ++j, ++out)
+        {
+          connections.columnIndex[out] = connections.columnIndex[j];
+          transmissibilities[out] = transmissibilities[j];
+        }
+      }
+      rowPtr[nCells] = out;
+      connections.columnIndex.resize(out);
+      transmissibilities.resize(out);
+      connections.values.assign(out, 1);
+      connections.nnz = out;
+    }
+
+  }
+
+}
@@ -0,0 +1,58 @@
+/*
+ * ------------------------------------------------------------------------------------------------------------
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ * Copyright (c) 2018-2020 Lawrence Livermore National Security LLC
+ * Copyright (c) 2018-2020 The Board of Trustees of the Leland Stanford Junior University
+ * Copyright (c) 2018-2020 Total, S.A
+ * Copyright (c) 2020-     GEOSX Contributors
+ * All right reserved
+ *
+ * See top level LICENSE, COPYRIGHT, CONTRIBUTORS, NOTICE, and ACKNOWLEDGEMENTS files for details.
+ * ------------------------------------------------------------------------------------------------------------
+ */
+
+#pragma once
+#include <string>
+#include <vector>
+#include "Adjacency/CSRMatrix.hpp"
+#include "Collection/Collection.hpp"
+#include "Mesh/MeshGeometry.hpp"
+#include "Property/Property.hpp"
+
+namespace PAMELA
+{
+
+  namespace tpfa
+  {
+
+    /**
+     * \brief Symmetric permeability tensor per polyhedron, SI units (m2)
+     */
+    struct Permeability
+    {
+      std::vector<double> xx, yy, zz, xy, yz, xz;
+      std::size_t size() const { return xx.size(); }
+      void resize(std::size_t n);
+    };
+
+    /**
+     * \brief Permeability of the polyhedra, read from the property label if it exists, either as a diagonal
+     * (VECTOR: xx, yy, zz) or a symmetric tensor (TENSOR_SYMM: xx, yy, zz, xy, yz, xz) in m2,
+     * else from the scalar properties PERMX, PERMY and PERMZ in mD.
+     */
+    Permeability GetPermeability(Property<PolyhedronCollection, double>* properties, std::size_t nPolyhedra, const std::string& label);
+
+    /**
+     * \brief Two-point flux approximation transmissibilities through the polygons shared by two polyhedra.
+     * Half transmissibilities A |n.K.d| / |d|^2, d going from the cell centroid to the face center, are combined harmonically.
+     * \param faceToCell polygon to polyhedron adjacency matrix
+     * \param connections symmetric polyhedron to polyhedron matrix, rows sorted, connections through several faces summed
+     * \param transmissibilities one value per nonzero of connections
+     */
+    void ComputeTransmissibilities(const geometry::CellGeometry& cells, const geometry::FaceGeometry& faces, const CSRMatrix& faceToCell,
+                                   const Permeability& permeability, CSRMatrix& connections, std::vector<double>& transmissibilities);
+
+  }
+
+}
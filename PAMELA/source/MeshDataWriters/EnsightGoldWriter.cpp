@@ -14,6 +14,7 @@
 
 #include "MeshDataWriters/EnsightGoldWriter.hpp"
 #include "Utils/Logger.hpp"
+#include "Utils/Statistics.hpp"
 #include <iomanip>
 namespace PAMELA
 {
@@ -41,96 +42,16 @@ namespace PAMELA
 		m_caseFile << "model: " << m_name + "_" + PartitionNumberForExtension() + ".geo" << std::endl;
 		m_caseFile << std::endl;
 
-		std::string stars(m_nDigitsExtensionTime, '*');
-
-
 		m_caseFile << "VARIABLE" << std::endl;
 
 		//--Variables
+		std::vector<std::vector<int>> timeSets;
 		if (m_Variable.size() != 0)
 		{
-
-			//Point variables
-			for (auto it = m_PointParts.begin(); it != m_PointParts.end(); ++it)
-			{
-				auto part = it->second;
-
-				//Per Element Variable
-				for (auto it2 = part->PerElementVariable.begin(); it2 != part->PerElementVariable.end(); ++it2)
-				{
-					m_caseFile << "scalar per element:" << "     " << 1 << std::setw(5);
-					m_caseFile << "     " << (*it2)->Label << " " << m_name << "_" << part->Label << "_" + (*it2)->Label << "_" << stars << std::endl;
-				}
-
-				//Per Node Variable
-				for (auto it2 = part->PerNodeVariable.begin(); it2 != part->PerNodeVariable.end(); ++it2)
-				{
-					m_caseFile << "scalar per node:" << "     " << 1 << std::setw(5);
-					m_caseFile << "     " << (*it2)->Label << " " << m_name << "_" << part->Label << "_" + (*it2)->Label << "_" << stars << std::endl;
-				}
-			}
-
-			//Line variables
-			for (auto it = m_LineParts.begin(); it != m_LineParts.end(); ++it)
-			{
-				auto part = it->second;
-
-				//Per Element Variable
-				for (auto it2 = part->PerElementVariable.begin(); it2 != part->PerElementVariable.end(); ++it2)
-				{
-					m_caseFile << "scalar per element:" << "     " << 1 << std::setw(5);
-					m_caseFile << "     " << (*it2)->Label << " " << m_name << "_" << part->Label << "_" + (*it2)->Label << "_" << stars << std::endl;
-				}
-
-				//Per Node Variable
-				for (auto it2 = part->PerNodeVariable.begin(); it2 != part->PerNodeVariable.end(); ++it2)
-				{
-					m_caseFile << "scalar per node:" << "     " << 1 << std::setw(5);
-					m_caseFile << "     " << (*it2)->Label << " " << m_name << "_" << part->Label << "_" + (*it2)->Label << "_" << stars << std::endl;
-				}
-			}
-
-
-			//Polygon variables
-			for (auto it = m_PolygonParts.begin(); it != m_PolygonParts.end(); ++it)
-			{
-				auto part = it->second;
-
-				//Per Element Variable
-				for (auto it2 = part->PerElementVariable.begin(); it2 != part->PerElementVariable.end(); ++it2)
-				{
-					m_caseFile << "scalar per element:" << "     " << 1 << std::setw(5);
-					m_caseFile << "     " << (*it2)->Label << " " << m_name << "_" << part->Label << "_" + (*it2)->Label << "_" << stars << std::endl;
-				}
-
-				//Per Node Variable
-				for (auto it2 = part->PerNodeVariable.begin(); it2 != part->PerNodeVariable.end(); ++it2)
-				{
-					m_caseFile << "scalar per node:" << "     " << 1 << std::setw(5);
-					m_caseFile << "     " << (*it2)->Label << " " << m_name << "_" << part->Label << "_" + (*it2)->Label << "_" << stars << std::endl;
-				}
-			}
-
-
-			//Polyhedron variables
-			for (auto it = m_PolyhedronParts.begin(); it != m_PolyhedronParts.end(); ++it)
-			{
-				auto part = it->second;
-
-				//Per Element Variable
-				for (auto it2 = part->PerElementVariable.begin(); it2 != part->PerElementVariable.end(); ++it2)
-				{
-					m_caseFile << "scalar per element:" << "     " << 1 << std::setw(5);
-					m_caseFile << "     " << (*it2)->Label << " " << m_name << "_" << part->Label << "_" + (*it2)->Label << "_" << stars << std::endl;
-				}
-
-				//Per Node Variable
-				for (auto it2 = part->PerNodeVariable.begin(); it2 != part->PerNodeVariable.end(); ++it2)
-				{
-					m_caseFile << "scalar per node:" << "     " << 1 << std::setw(5);
-					m_caseFile << "     " << (*it2)->Label << " " << m_name << "_" << part->Label << "_" + (*it2)->Label << "_" << stars << std::endl;
-				}
-			}
+			MakeCaseFile_AddVariables(&m_PointParts, timeSets);
+			MakeCaseFile_AddVariables(&m_LineParts, timeSets);
+			MakeCaseFile_AddVariables(&m_PolygonParts, timeSets);
+			MakeCaseFile_AddVariables(&m_PolyhedronParts, timeSets);
 		}
 		else
 		{
@@ -139,14 +60,39 @@ namespace PAMELA
 
 
 		//--Time
+		const std::vector<double> timeValues = m_timeValues.empty() ? std::vector<double>(1, 0.0) : m_timeValues;
+		m_caseFile << std::setprecision(12);
 		m_caseFile << std::endl;
 		m_caseFile << "TIME" << std::endl;
 		m_caseFile << "time set: 1" << std::endl;
-		m_caseFile << "number of steps: 1" << std::endl;
+		m_caseFile << "number of steps: " << timeValues.size() << std::endl;
 		m_caseFile << "filename start number: 0" << std::endl;
 		m_caseFile << "filename increment: 1" << std::endl;
 		m_caseFile << "time values:" << std::endl;
-		m_caseFile << 0 << std::endl;
+		for (auto time : timeValues)
+		{
+			m_caseFile << time << std::endl;
+		}
+
+		//--Variables not written at every step
+		for (std::size_t i = 0; i != timeSets.size(); ++i)
+		{
+			m_caseFile << std::endl;
+			m_caseFile << "time set: " << i + 2 << std::endl;
+			m_caseFile << "number of steps: " << timeValues.size() << std::endl;
+			m_caseFile << "filename numbers:" << std::endl;
+			for (auto number : timeSets[i])
+			{
+				m_caseFile << number << std::endl;
+			}
+			m_caseFile << "time values:" << std::endl;
+			for (auto time : timeValues)
+			{
+				m_caseFile << time << std::endl;
+			}
+		}
+
+		m_caseFile.close();
 
 		LOGINFO("*** Done");
 	}
@@ -158,6 +104,19 @@ namespace PAMELA
 	{
 		LOGINFO("*** Init Ensight Gold .geo file");
 
+		if (m_encoding == ENCODING::BINARY)
+		{
+			OpenBinaryFile(m_geoFile, m_name + "_" + PartitionNumberForExtension() + ".geo");
+			MakeGeoFile_HeaderBinary();
+			MakeGeoFile_AddPartsBinary(&m_PointParts);
+			MakeGeoFile_AddPartsBinary(&m_LineParts);
+			MakeGeoFile_AddPartsBinary(&m_PolygonParts);
+			MakeGeoFile_AddPartsBinary(&m_PolyhedronParts);
+			m_geoFile.close();
+			LOGINFO("*** Done");
+			return;
+		}
+
 		//Create file
 		m_geoFile.open( m_name + "_" + PartitionNumberForExtension() + ".geo", std::fstream::in | std::fstream::out | std::fstream::trunc);
 
@@ -197,8 +156,124 @@ namespace PAMELA
 	}
 
 
+	void EnsightGoldWriter::MakeGeoFile_HeaderBinary()
+	{
+		WriteBinary(m_geoFile, std::string("C Binary"));
+		WriteBinary(m_geoFile, std::string("EnSight Model Geometry File"));
+		WriteBinary(m_geoFile, std::string("EnSight 7.1.0"));
+		WriteBinary(m_geoFile, std::string("node id given"));
+		WriteBinary(m_geoFile, std::string("element id given"));
+	}
+
+	void EnsightGoldWriter::OpenBinaryFile(std::ofstream& file, const std::string& filename)
+	{
+		//Files are written one at a time, they share the same buffer
+		m_fileBuffer.resize(1 << 20);
+		file.rdbuf()->pubsetbuf(m_fileBuffer.data(), m_fileBuffer.size());
+		file.open(filename, std::fstream::out | std::fstream::binary | std::fstream::trunc);
+		if (!file)
+		{
+			LOGERROR("Unable to open " + filename);
+		}
+	}
+
+	void EnsightGoldWriter::WriteBinary(std::ofstream& file, const std::string& value)
+	{
+		char record[80] = {};
+		value.copy(record, sizeof(record) - 1);
+		file.write(record, sizeof(record));
+	}
+
+	void EnsightGoldWriter::WriteBinary(std::ofstream& file, int value)
+	{
+		file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+	}
+
+	std::string EnsightGoldWriter::VariableFileName(const std::string& partLabel, const std::string& variableLabel)
+	{
+		return m_name + "_" + partLabel + "_" + variableLabel;
+	}
+
+	int EnsightGoldWriter::VariableTimeSet(const std::string& fileName, std::vector<std::vector<int>>& timeSets)
+	{
+		auto it = m_fileNumbers.find(fileName);
+		if (it == m_fileNumbers.end())
+		{
+			return 1;
+		}
+
+		const auto& numbers = it->second;
+		bool everyStep = (numbers.size() == m_timeValues.size());
+		for (std::size_t i = 0; everyStep && (i != numbers.size()); ++i)
+		{
+			everyStep = (numbers[i] == static_cast<int>(i));
+		}
+		if (everyStep)
+		{
+			return 1;
+		}
+
+		timeSets.push_back(numbers);
+		timeSets.back().resize(m_timeValues.size(), numbers.back());
+		return static_cast<int>(timeSets.size()) + 1;
+	}
+
+	bool EnsightGoldWriter::RecordVariableStep(const std::string& fileName, bool modified)
+	{
+		if (m_timeValues.empty())
+		{
+			return true;
+		}
+
+		auto& numbers = m_fileNumbers[fileName];
+		const bool write = modified || numbers.empty();
+		const int number = write ? m_currentTimeStep : numbers.back();
+
+		//Steps before the variable was declared point to its first file
+		numbers.resize(m_currentTimeStep, number);
+		numbers.push_back(number);
+
+		return write;
+	}
+
+	void EnsightGoldWriter::WriteVariableFile(const VariableFile& variableFile)
+	{
+		std::ofstream file;
+
+		if (m_encoding == ENCODING::BINARY)
+		{
+			OpenBinaryFile(file, variableFile.FileName);
+			WriteBinary(file, variableFile.Label);
+			WriteBinary(file, std::string("part"));
+			WriteBinary(file, variableFile.PartIndex);
+			for (auto const& block : variableFile.Blocks)
+			{
+				WriteBinary(file, block.first);
+				WriteBinary(file, std::vector<float>(block.second.begin(), block.second.end()));
+			}
+			return;
+		}
+
+		file.open(variableFile.FileName, std::fstream::in | std::fstream::out | std::fstream::trunc);
+		file << variableFile.Label << std::endl;
+		file << "part" << std::endl;
+		file << std::setw(10);
+		file << variableFile.PartIndex << std::endl;
+		for (auto const& block : variableFile.Blocks)
+		{
+			file << block.first << std::endl;
+			for (auto value : block.second)
+			{
+				file << std::setw(12) << value << '\n';
+			}
+		}
+	}
+
 	void EnsightGoldWriter::Init()
 	{
+		PAMELA_REGION("EnsightGoldWriter::Init");
+		Wait();
+
 		//To be launched after variables declaration
 		MakeCaseFile();
 		MakeGeoFile();
@@ -209,18 +284,28 @@ namespace PAMELA
 	*/
 	void EnsightGoldWriter::Dump()
 	{
+		PAMELA_REGION("EnsightGoldWriter::Dump");
 
-		//Point
-		DumpVariables_Parts(&m_PointParts);
-
-		//Line
-		DumpVariables_Parts(&m_LineParts);
+		auto files = std::make_shared<std::vector<VariableFile>>();
+		DumpVariables_Parts(&m_PointParts, *files);
+		DumpVariables_Parts(&m_LineParts, *files);
+		DumpVariables_Parts(&m_PolygonParts, *files);
+		DumpVariables_Parts(&m_PolyhedronParts, *files);
 
-		//Polygon
-		DumpVariables_Parts(&m_PolygonParts);
+		Submit([this, files]()
+		{
+			PAMELA_REGION("EnsightGoldWriter::WriteFiles");
+			for (auto const& file : *files)
+			{
+				WriteVariableFile(file);
+			}
+		});
 
-		//Polyhedron
-		DumpVariables_Parts(&m_PolyhedronParts);
+		//Time set of the case file grows with the steps
+		if (!m_timeValues.empty())
+		{
+			MakeCaseFile();
+		}
 
 	}
 }
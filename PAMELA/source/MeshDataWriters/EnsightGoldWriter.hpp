@@ -37,7 +37,8 @@ namespace PAMELA
 
 	public:
 
-		EnsightGoldWriter(Mesh * mesh, std::string name) : MeshDataWriter(mesh, name) {}
+		EnsightGoldWriter(Mesh * mesh, std::string name, ENCODING encoding = ENCODING::ASCII) : MeshDataWriter(mesh, name), m_encoding(encoding) {}
+		~EnsightGoldWriter() { WaitNoThrow(); }
 
 		virtual void Init() final;
 		virtual void Dump() final;
@@ -47,14 +48,51 @@ namespace PAMELA
 		void MakeCaseFile();
 		void MakeGeoFile();
 
+		template<typename T>
+		void MakeCaseFile_AddVariables(const PartMap<T>* parts, std::vector<std::vector<int>>& timeSets);
+
+		int VariableTimeSet(const std::string& fileName, std::vector<std::vector<int>>& timeSets);
+
+		//Returns false if the variable is unchanged since it was last written at a previous step
+		bool RecordVariableStep(const std::string& fileName, bool modified);
+
 		//Geo
 		void MakeGeoFile_Header();
 
 		template<typename T>
 		void MakeGeoFile_AddParts(const PartMap<T>* parts);
 
+		//Variable file of one part at one step, owned so that it can be written in the background
+		struct VariableFile
+		{
+			std::string FileName;
+			std::string Label;
+			int PartIndex;
+			std::vector<std::pair<std::string, std::vector<double>>> Blocks;	//Element type or "coordinates", and values
+		};
+
 		template<typename T>
-		void DumpVariables_Parts(const PartMap<T>* parts);
+		void DumpVariables_Parts(const PartMap<T>* parts, std::vector<VariableFile>& files);
+
+		void WriteVariableFile(const VariableFile& variableFile);
+
+		//C Binary
+		void MakeGeoFile_HeaderBinary();
+
+		template<typename T>
+		void MakeGeoFile_AddPartsBinary(const PartMap<T>* parts);
+
+		void OpenBinaryFile(std::ofstream& file, const std::string& filename);
+
+		//Strings are stored in 80 characters records
+		static void WriteBinary(std::ofstream& file, const std::string& value);
+
+		static void WriteBinary(std::ofstream& file, int value);
+
+		template<typename T>
+		static void WriteBinary(std::ofstream& file, const std::vector<T>& values);
+
+		std::string VariableFileName(const std::string& partLabel, const std::string& variableLabel);
 
 		const std::unordered_map<int, std::string> ElementToLabel
 			=
@@ -88,6 +126,14 @@ namespace PAMELA
 		std::ofstream m_caseFile;
 		std::ofstream m_geoFile;
 
+		ENCODING m_encoding;
+
+		//Large buffer for binary files
+		std::vector<char> m_fileBuffer;
+
+		//Number of the file holding each variable at each step
+		std::unordered_map<std::string, std::vector<int>> m_fileNumbers;
+
 
 	};
 
@@ -184,125 +230,149 @@ namespace PAMELA
 	}
 
 	template <typename T>
-	void EnsightGoldWriter::DumpVariables_Parts(const PartMap<T>* parts)
+	void EnsightGoldWriter::DumpVariables_Parts(const PartMap<T>* parts, std::vector<VariableFile>& files)
 	{
-
-		//Polyhedron
 		for (auto it = parts->begin(); it != parts->end(); ++it)			//Loop over Parts that are defined from the mesh input
 		{
 			auto partptr = it->second;
 
-
 			//PerElementVariables
-			for (auto it2 = partptr->PerElementVariable.begin(); it2 != partptr->PerElementVariable.end(); ++it2)
+			for (auto variableptr : partptr->PerElementVariable)
 			{
+				const std::string fileName = VariableFileName(partptr->Label, variableptr->Label);
+				if (!RecordVariableStep(fileName, variableptr->Modified))
+				{
+					continue;
+				}
 
-				auto variableptr = (*it2);
-
-				//Create file
-				std::ofstream variableFile;
-				variableFile.open(m_name + "_" + partptr->Label + "_" + variableptr->Label + "_" + TimeStepNumberForExtension(), std::fstream::in | std::fstream::out | std::fstream::trunc);
-
-				//write
-				variableFile << variableptr->Label << std::endl;
-				variableFile << "part" << std::endl;
-				variableFile << std::setw(10);
-				variableFile << partptr->Index << std::endl;
-
+				files.push_back({ fileName + "_" + TimeStepNumberForExtension(), variableptr->Label, partptr->Index, {} });
 
-				for (auto it3 = partptr->SubParts.begin(); it3 != partptr->SubParts.end(); ++it3)
+				const auto& data = variableptr->get_data();
+				const auto offset = variableptr->offset;
+				for (auto it2 = partptr->SubParts.begin(); it2 != partptr->SubParts.end(); ++it2)
 				{
-					if (it3->second->SubCollection.size_owned() > 0)
+					auto subpart = it2->second;
+					if (subpart->SubCollection.size_owned() > 0)
 					{
-						auto subpart = it3->second;
-						auto elementType = subpart->ElementType;
-						std::string ENSTypeLabel = ElementToLabel.at(static_cast<int>(elementType));
-						variableFile << ENSTypeLabel << std::endl;
-						variableFile << std::setw(10);
-						for (auto it4 = subpart->SubCollection.begin_owned(); it4 != subpart->SubCollection.end_owned(); ++it4)
+						std::vector<double> values;
+						values.reserve(subpart->SubCollection.size_owned()*offset);
+						for (std::size_t i = 0; i != subpart->SubCollection.size_owned(); ++i)
 						{
-							auto collectionIndex = it4 - subpart->SubCollection.begin_owned();
-							auto variableIndex = subpart->IndexMapping[collectionIndex];
-							auto variableData = variableptr->get_data(variableIndex);
-							for (auto it5 = variableData.begin(); it5 != variableData.end(); ++it5)
-							{
-								variableFile << std::setw(12) << (*it5) << std::endl;
-							}
+							const auto variableIndex = subpart->IndexMapping[i];
+							values.insert(values.end(), data.begin() + variableIndex*offset, data.begin() + (variableIndex + 1)*offset);
 						}
-
+						files.back().Blocks.emplace_back(ElementToLabel.at(static_cast<int>(subpart->ElementType)), std::move(values));
 					}
 				}
-
 			}
 
 			//PerNodeVariables
-			for (auto it2 = partptr->PerNodeVariable.begin(); it2 != partptr->PerNodeVariable.end(); ++it2)
+			for (auto variableptr : partptr->PerNodeVariable)
 			{
+				const std::string fileName = VariableFileName(partptr->Label, variableptr->Label);
+				if (!RecordVariableStep(fileName, variableptr->Modified))
+				{
+					continue;
+				}
 
-				auto variableptr = (*it2);
+				files.push_back({ fileName + "_" + TimeStepNumberForExtension(), variableptr->Label, partptr->Index, {} });
+				files.back().Blocks.emplace_back("coordinates", variableptr->get_data());
+			}
+		}
+	}
 
-				//Create file
-				std::ofstream variableFile;
-				variableFile.open("./" + partptr->Label + "_" + variableptr->Label + "_" + TimeStepNumberForExtension(), std::fstream::in | std::fstream::out | std::fstream::trunc);
+	template <typename T>
+	void EnsightGoldWriter::MakeCaseFile_AddVariables(const PartMap<T>* parts, std::vector<std::vector<int>>& timeSets)
+	{
+		std::string stars(m_nDigitsExtensionTime, '*');
 
-				//write
-				variableFile << variableptr->Label << std::endl;
-				variableFile << "part" << std::endl;
-				variableFile << std::setw(10);
-				variableFile << partptr->Index << std::endl;
-				variableFile << "coordinates" << std::endl;
-				for (auto it3 = partptr->Points.begin(); it3 != partptr->Points.end(); ++it3)
-				{
+		for (auto it = parts->begin(); it != parts->end(); ++it)
+		{
+			auto part = it->second;
 
-					//TODO does not work
-					auto collectionIndex = std::distance(partptr->Points.begin(), it3);
-					auto variableData = variableptr->get_data(static_cast<int>(collectionIndex));
-					for (auto it5 = variableData.begin(); it5 != variableData.end(); ++it5)
-					{
-						variableFile << std::setw(12) << (*it5) << std::endl;
-					}
-					////y
-					//for (auto it5 = variableData.begin(); it5 != variableData.end(); ++it5)
-					//{
-					//	variableFile << std::setw(12) << (*it5) << std::endl;
-					//}
-					////z
-					//	for (auto it5 = variableData.begin(); it5 != variableData.end(); ++it5)
-					//{
-					//	variableFile << std::setw(12) << (*it5) << std::endl;
-					//}
-				}
+			//Per Element Variable
+			for (auto it2 = part->PerElementVariable.begin(); it2 != part->PerElementVariable.end(); ++it2)
+			{
+				const std::string fileName = VariableFileName(part->Label, (*it2)->Label);
+				m_caseFile << "scalar per element:" << "     " << VariableTimeSet(fileName, timeSets) << std::setw(5);
+				m_caseFile << "     " << (*it2)->Label << " " << fileName << "_" << stars << std::endl;
+			}
 
+			//Per Node Variable
+			for (auto it2 = part->PerNodeVariable.begin(); it2 != part->PerNodeVariable.end(); ++it2)
+			{
+				const std::string fileName = VariableFileName(part->Label, (*it2)->Label);
+				m_caseFile << "scalar per node:" << "     " << VariableTimeSet(fileName, timeSets) << std::setw(5);
+				m_caseFile << "     " << (*it2)->Label << " " << fileName << "_" << stars << std::endl;
+			}
+		}
+	}
+
+	template <typename T>
+	void EnsightGoldWriter::WriteBinary(std::ofstream& file, const std::vector<T>& values)
+	{
+		file.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+	}
+
+	template <typename T>
+	void EnsightGoldWriter::MakeGeoFile_AddPartsBinary(const PartMap<T>* parts)
+	{
+		for (auto it = parts->begin(); it != parts->end(); ++it)
+		{
+			auto partptr = it->second;
+			const auto nPoints = partptr->Points.size();
 
-				/*for (auto it3 = partptr->SubParts.begin(); it3 != partptr->SubParts.end(); ++it3)
+			WriteBinary(m_geoFile, std::string("part"));
+			WriteBinary(m_geoFile, partptr->Index);
+			WriteBinary(m_geoFile, partptr->Label);
+
+			//Coordinates
+			WriteBinary(m_geoFile, std::string("coordinates"));
+			WriteBinary(m_geoFile, static_cast<int>(nPoints));
+
+			std::vector<int> ids(nPoints);
+			std::vector<float> x(nPoints), y(nPoints), z(nPoints);
+			for (std::size_t i = 0; i != nPoints; ++i)
+			{
+				const auto& xyz = partptr->Points[i]->get_coordinates();
+				ids[i] = partptr->Points[i]->get_globalIndex();
+				x[i] = static_cast<float>(xyz.x);
+				y[i] = static_cast<float>(xyz.y);
+				z[i] = static_cast<float>(xyz.z);
+			}
+			WriteBinary(m_geoFile, ids);
+			WriteBinary(m_geoFile, x);
+			WriteBinary(m_geoFile, y);
+			WriteBinary(m_geoFile, z);
+
+			//Elements
+			for (auto it2 = partptr->SubParts.begin(); it2 != partptr->SubParts.end(); ++it2)
+			{
+				auto subpart = it2->second;
+				const auto nElements = subpart->SubCollection.size_owned();
+				if (nElements > 0)
 				{
-					if (it3->second->SubCollection.size_owned() > 0)
+					WriteBinary(m_geoFile, ElementToLabel.at(static_cast<int>(subpart->ElementType)));
+					WriteBinary(m_geoFile, static_cast<int>(nElements));
+
+					std::vector<int> elementIds;
+					std::vector<int> connectivity;
+					elementIds.reserve(nElements);
+					for (auto it3 = subpart->SubCollection.begin_owned(); it3 != subpart->SubCollection.end_owned(); ++it3)
 					{
-						auto subpart = it3->second;
-						auto elementType = subpart->ElementType;
-						std::string ENSTypeLabel = EnsightGold::ElementToLabel.at(elementType);
-						variableFile << ENSTypeLabel << std::endl;
-						variableFile << std::setw(10);
-						for (auto it4 = subpart->SubCollection.begin_owned(); it4 != subpart->SubCollection.end_owned(); ++it4)
+						elementIds.push_back((*it3)->get_globalIndex());
+						for (auto vertex : (*it3)->get_vertexList())
 						{
-							auto collectionIndex = it4 - subpart->SubCollection.begin_owned();
-							auto variableIndex = subpart->IndexMapping[collectionIndex];
-							auto variableData = variableptr->get_data(static_cast<int>(collectionIndex));
-							for (auto it5 = variableData.begin(); it5 != variableData.end(); ++it5)
-							{
-								variableFile << std::setw(12) << (*it5) << std::endl;
-							}
-
+							connectivity.push_back(partptr->GlobalToLocalPointMapping.at(vertex->get_globalIndex()) + 1);
 						}
-
 					}
-				}*/
-
+					WriteBinary(m_geoFile, elementIds);
+					WriteBinary(m_geoFile, connectivity);
+				}
 			}
-
 		}
-
 	}
+
 }
 
 
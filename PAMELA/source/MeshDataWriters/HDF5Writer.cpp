@@ -0,0 +1,441 @@
+/*
+ * ------------------------------------------------------------------------------------------------------------
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ * Copyright (c) 2018-2020 Lawrence Livermore National Security LLC
+ * Copyright (c) 2018-2020 The Board of Trustees of the Leland Stanford Junior University
+ * Copyright (c) 2018-2020 Total, S.A
+ * Copyright (c) 2020-     GEOSX Contributors
+ * All right reserved
+ *
+ * See top level LICENSE, COPYRIGHT, CONTRIBUTORS, NOTICE, and ACKNOWLEDGEMENTS files for details.
+ * ------------------------------------------------------------------------------------------------------------
+ */
+
+#ifdef WITH_HDF5
+#include "MeshDataWriters/HDF5Writer.hpp"
+#include "Utils/Logger.hpp"
+#include "Utils/Statistics.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <iterator>
+#include <limits>
+#include <sstream>
+
+#include <hdf5.h>
+
+#if defined(WITH_MPI) && defined(H5_HAVE_PARALLEL)
+#define PAMELA_HDF5_COLLECTIVE
+#endif
+
+namespace PAMELA
+{
+
+	namespace
+	{
+		std::string FileBaseName(const std::string& path)
+		{
+			return path.substr(path.find_last_of("/\\") + 1);
+		}
+	}
+
+	HDF5Writer::HDF5Writer(Mesh * mesh, std::string name) : MeshDataWriter(mesh, name), m_compression(0)
+	{
+#ifdef PAMELA_HDF5_COLLECTIVE
+		m_collective = true;
+#else
+		m_collective = false;
+#endif
+	}
+
+	void HDF5Writer::set_Compression(int level)
+	{
+		if ((level > 0) && (H5Zfilter_avail(H5Z_FILTER_DEFLATE) <= 0))
+		{
+			LOGWARNING("HDF5 is built without deflate, datasets are written uncompressed");
+			level = 0;
+		}
+		m_compression = std::min(std::max(level, 0), 9);
+	}
+
+	/**
+	 * \brief Write the points and the connectivity of the owned elements of all parts
+	 */
+	void HDF5Writer::Init()
+	{
+		PAMELA_REGION("HDF5Writer::Init");
+		LOGINFO("*** Init HDF5 Writer");
+
+		m_shapes.clear();
+		m_variableSteps.clear();
+
+		std::map<std::string, Dataset> datasets;
+		AddGeometry("Point", &m_PointParts, datasets);
+		AddGeometry("Line", &m_LineParts, datasets);
+		AddGeometry("Polygon", &m_PolygonParts, datasets);
+		AddGeometry("Polyhedron", &m_PolyhedronParts, datasets);
+
+		WriteDatasets(datasets, true);
+
+		LOGINFO("*** Done");
+	}
+
+	void HDF5Writer::Dump()
+	{
+		PAMELA_REGION("HDF5Writer::Dump");
+		LOGINFO("*** Dump HDF5 file");
+
+		std::map<std::string, Dataset> datasets;
+		AddVariables("Point", &m_PointParts, datasets);
+		AddVariables("Line", &m_LineParts, datasets);
+		AddVariables("Polygon", &m_PolygonParts, datasets);
+		AddVariables("Polyhedron", &m_PolyhedronParts, datasets);
+
+		WriteDatasets(datasets, false);
+
+		//Variables not written at this step keep their previous data
+		for (auto& variable : m_variableSteps)
+		{
+			variable.second.resize(m_currentTimeStep + 1, variable.second.back());
+		}
+		const std::string stepGroup = StepGroup(m_currentTimeStep) + "/";
+		for (auto const& shape : m_shapes)
+		{
+			if (shape.first.compare(0, stepGroup.size(), stepGroup) == 0)
+			{
+				auto& steps = m_variableSteps[shape.first.substr(stepGroup.size())];
+				steps.resize(m_currentTimeStep + 1, -1);
+				steps.back() = m_currentTimeStep;
+			}
+		}
+
+		if (!m_collective || (m_partition == 0))
+		{
+			MakeXdmfFile();
+		}
+
+		LOGINFO("*** Done");
+	}
+
+	std::string HDF5Writer::FileName()
+	{
+		return m_name + (m_collective ? "" : "_" + PartitionNumberForExtension()) + ".h5";
+	}
+
+	std::string HDF5Writer::StepGroup(int timeStep)
+	{
+		std::string number = std::to_string(timeStep);
+		number.insert(0, std::max(0, m_nDigitsExtensionTime - static_cast<int>(number.size())), '0');
+		return "Steps/" + number;
+	}
+
+	std::string HDF5Writer::GroupName(const std::string& label)
+	{
+		std::string name(label);
+		std::replace(name.begin(), name.end(), '/', '_');
+		return name;
+	}
+
+	/**
+	 * \brief Write the datasets, one hyperslab of rows per partition in collective mode.
+	 * Datasets are chunked, and compressed if a deflate level is set.
+	 */
+	void HDF5Writer::WriteDatasets(std::map<std::string, Dataset>& datasets, bool newFile)
+	{
+		std::vector<std::uint64_t> rows;
+		std::vector<std::uint64_t> rowsBefore;
+		std::vector<std::uint64_t> totalRows;
+
+#ifdef PAMELA_HDF5_COLLECTIVE
+		//Datasets are created collectively, every partition needs the same list
+		std::ostringstream localNames;
+		for (auto const& dataset : datasets)
+		{
+			localNames << dataset.first << '\t' << dataset.second.Integer << '\t' << dataset.second.Columns << '\n';
+		}
+		const std::string names = localNames.str();
+
+		int length = static_cast<int>(names.size());
+		std::vector<int> lengths(m_nPartition);
+		MPI_Allgather(&length, 1, MPI_INT, lengths.data(), 1, MPI_INT, MPI_COMM_WORLD);
+		std::vector<int> displacements(m_nPartition, 0);
+		for (std::size_t i = 1; i < lengths.size(); ++i)
+		{
+			displacements[i] = displacements[i - 1] + lengths[i - 1];
+		}
+		std::string allNames(displacements.back() + lengths.back(), ' ');
+		MPI_Allgatherv(const_cast<char*>(names.data()), length, MPI_CHAR, &allNames[0], lengths.data(), displacements.data(), MPI_CHAR, MPI_COMM_WORLD);
+
+		std::istringstream allNamesStream(allNames);
+		std::string path;
+		bool integer;
+		std::size_t nColumns;
+		while (std::getline(allNamesStream, path, '\t') && (allNamesStream >> integer >> nColumns))
+		{
+			allNamesStream.ignore();
+			datasets.emplace(path, Dataset(integer, nColumns));
+		}
+#endif
+
+		for (auto const& dataset : datasets)
+		{
+			rows.push_back(dataset.second.Rows());
+		}
+		rowsBefore.assign(rows.size(), 0);
+		totalRows = rows;
+
+#ifdef PAMELA_HDF5_COLLECTIVE
+		MPI_Exscan(rows.data(), rowsBefore.data(), static_cast<int>(rows.size()), MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD);
+		MPI_Allreduce(rows.data(), totalRows.data(), static_cast<int>(rows.size()), MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD);
+		if (m_partition == 0)
+		{
+			std::fill(rowsBefore.begin(), rowsBefore.end(), 0);
+		}
+
+		//Element blocks Mesh/<part>/<type>/Connectivity refer to the points of the partition in Mesh/<part>/Coordinates,
+		//which start after the points of the previous partitions
+		const std::string connectivity = "/Connectivity";
+		for (auto& dataset : datasets)
+		{
+			const std::string& path = dataset.first;
+			if ((path.compare(0, 5, "Mesh/") != 0) || (path.size() <= connectivity.size()) || (path.compare(path.size() - connectivity.size(), connectivity.size(), connectivity) != 0))
+			{
+				continue;
+			}
+			const std::string blockPath = path.substr(0, path.size() - connectivity.size());
+			const std::string partPath = blockPath.substr(0, blockPath.find_last_of('/'));
+			const auto pointOffset = static_cast<std::int64_t>(rowsBefore[std::distance(datasets.begin(), datasets.find(partPath + "/Coordinates"))]);
+			for (auto& index : dataset.second.Indices)
+			{
+				index += pointOffset;
+			}
+		}
+#endif
+
+		//Open
+		hid_t fileAccess = H5Pcreate(H5P_FILE_ACCESS);
+		hid_t transfer = H5Pcreate(H5P_DATASET_XFER);
+#ifdef PAMELA_HDF5_COLLECTIVE
+		H5Pset_fapl_mpio(fileAccess, MPI_COMM_WORLD, MPI_INFO_NULL);
+		H5Pset_dxpl_mpio(transfer, H5FD_MPIO_COLLECTIVE);
+#endif
+
+		const std::string filename = FileName();
+		hid_t file = newFile ? H5Fcreate(filename.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, fileAccess) : H5Fopen(filename.c_str(), H5F_ACC_RDWR, fileAccess);
+		if (file < 0)
+		{
+			LOGERROR("Unable to open " + filename);
+		}
+
+		//A step written again replaces the previous data
+		const std::string stepGroup = StepGroup(m_currentTimeStep);
+		if (!newFile && (H5Lexists(file, "Steps", H5P_DEFAULT) > 0) && (H5Lexists(file, stepGroup.c_str(), H5P_DEFAULT) > 0))
+		{
+			H5Ldelete(file, stepGroup.c_str(), H5P_DEFAULT);
+		}
+
+		//Parent groups are created with the datasets
+		hid_t linkCreation = H5Pcreate(H5P_LINK_CREATE);
+		H5Pset_create_intermediate_group(linkCreation, 1);
+
+		//Write
+		std::size_t i = 0;
+		for (auto const& dataset : datasets)
+		{
+			const std::string& path = dataset.first;
+			const Dataset& data = dataset.second;
+			const int nDims = (data.Columns == 1) ? 1 : 2;
+			const hsize_t dims[2] = { totalRows[i], data.Columns };
+			const hsize_t start[2] = { rowsBefore[i], 0 };
+			const hsize_t count[2] = { rows[i], data.Columns };
+
+			hid_t creation = H5Pcreate(H5P_DATASET_CREATE);
+			if (totalRows[i] > 0)
+			{
+				//Chunks of about 1 MiB
+				const hsize_t chunk[2] = { std::min<hsize_t>(totalRows[i], std::max<hsize_t>(1, (1 << 17) / data.Columns)), data.Columns };
+				H5Pset_chunk(creation, nDims, chunk);
+				if (m_compression > 0)
+				{
+					H5Pset_shuffle(creation);
+					H5Pset_deflate(creation, m_compression);
+				}
+			}
+
+			const hid_t type = data.Integer ? H5T_NATIVE_INT64 : H5T_NATIVE_DOUBLE;
+			hid_t fileSpace = H5Screate_simple(nDims, dims, nullptr);
+			hid_t memorySpace = H5Screate_simple(nDims, count, nullptr);
+			hid_t set = H5Dcreate2(file, path.c_str(), type, fileSpace, linkCreation, creation, H5P_DEFAULT);
+			if (set < 0)
+			{
+				LOGERROR("Unable to create dataset " + path + " in " + filename);
+			}
+
+			if (rows[i] > 0)
+			{
+				H5Sselect_hyperslab(fileSpace, H5S_SELECT_SET, start, nullptr, count, nullptr);
+			}
+			else
+			{
+				H5Sselect_none(fileSpace);
+				H5Sselect_none(memorySpace);
+			}
+
+			//Partitions without rows still take part in the collective write
+			const double empty = 0;
+			const void* buffer = data.Integer ? static_cast<const void*>(data.Indices.data()) : static_cast<const void*>(data.Values.data());
+			if (H5Dwrite(set, type, memorySpace, fileSpace, transfer, (rows[i] > 0) ? buffer : &empty) < 0)
+			{
+				LOGERROR("Unable to write dataset " + path + " in " + filename);
+			}
+
+			H5Dclose(set);
+			H5Sclose(memorySpace);
+			H5Sclose(fileSpace);
+			H5Pclose(creation);
+
+			m_shapes[path] = { totalRows[i], data.Columns, data.Integer };
+			++i;
+		}
+
+		H5Pclose(linkCreation);
+		H5Fclose(file);
+		H5Pclose(transfer);
+		H5Pclose(fileAccess);
+	}
+
+	/**
+	 * \brief Temporal collection of the steps, each step is a spatial collection with one grid per element block of each part
+	 */
+	void HDF5Writer::MakeXdmfFile()
+	{
+		const std::string filename = m_name + (m_collective ? "" : "_" + PartitionNumberForExtension()) + ".xmf";
+		std::ofstream file(filename, std::ios::out | std::ios::trunc);
+		if (!file)
+		{
+			LOGERROR("Unable to open " + filename);
+		}
+
+		file << std::setprecision(std::numeric_limits<double>::max_digits10);
+		file << "<?xml version=\"1.0\" ?>\n";
+		file << "<Xdmf Version=\"3.0\">\n";
+		file << "  <Domain>\n";
+		file << "    <Grid Name=\"" << FileBaseName(m_name) << "\" GridType=\"Collection\" CollectionType=\"Temporal\">\n";
+
+		const std::string connectivity = "/Connectivity";
+		for (int step = 0; step <= m_currentTimeStep; ++step)
+		{
+			const double time = m_timeValues.empty() ? m_currentTime : m_timeValues[step];
+			file << "      <Grid Name=\"Step_" << step << "\" GridType=\"Collection\" CollectionType=\"Spatial\">\n";
+			file << "        <Time Value=\"" << time << "\"/>\n";
+
+			for (auto const& shape : m_shapes)
+			{
+				//Element blocks are Mesh/<part>/<type>/Connectivity
+				const std::string& path = shape.first;
+				if ((path.compare(0, 5, "Mesh/") != 0) || (path.size() <= connectivity.size()) || (path.compare(path.size() - connectivity.size(), connectivity.size(), connectivity) != 0))
+				{
+					continue;
+				}
+				const std::string blockPath = path.substr(0, path.size() - connectivity.size());
+				const std::string partPath = blockPath.substr(0, blockPath.find_last_of('/'));
+				const std::string part = partPath.substr(5);
+				const std::string block = blockPath.substr(partPath.size() + 1);
+
+				auto topology = std::find_if(TypeToTopology.begin(), TypeToTopology.end(), [&block](const std::pair<const int, ElementTopology>& type) { return type.second.Label == block; });
+				ASSERT(topology != TypeToTopology.end(), "Unknown element block " + block);
+
+				file << "        <Grid Name=\"" << part << "_" << block << "\" GridType=\"Uniform\">\n";
+				file << "          <Topology TopologyType=\"" << topology->second.Topology << "\" NumberOfElements=\"" << shape.second.Rows << "\"";
+				if (topology->second.nVertex < 3)
+				{
+					file << " NodesPerElement=\"" << topology->second.nVertex << "\"";
+				}
+				file << ">\n";
+				WriteXdmfDataItem(file, path);
+				file << "          </Topology>\n";
+				file << "          <Geometry GeometryType=\"XYZ\">\n";
+				WriteXdmfDataItem(file, partPath + "/Coordinates");
+				file << "          </Geometry>\n";
+
+				WriteXdmfAttribute(file, "GlobalIndex", "Cell", blockPath + "/GlobalIndex");
+				WriteXdmfAttribute(file, "PartitionIndex", "Cell", blockPath + "/PartitionIndex");
+				WriteXdmfAttribute(file, "PointGlobalIndex", "Node", partPath + "/GlobalIndex");
+
+				//Variables are <part>/<type>/<label> per element and <part>/<label> per node
+				for (auto const& variable : m_variableSteps)
+				{
+					const std::string& key = variable.first;
+					const int dataStep = variable.second[step];
+					if (dataStep < 0)
+					{
+						continue;
+					}
+
+					std::string center;
+					std::string label;
+					if (key.compare(0, part.size() + block.size() + 2, part + "/" + block + "/") == 0)
+					{
+						center = "Cell";
+						label = key.substr(part.size() + block.size() + 2);
+					}
+					else if ((key.compare(0, part.size() + 1, part + "/") == 0) && (key.find('/', part.size() + 1) == std::string::npos))
+					{
+						center = "Node";
+						label = key.substr(part.size() + 1);
+					}
+					else
+					{
+						continue;
+					}
+					WriteXdmfAttribute(file, label, center, StepGroup(dataStep) + "/" + key);
+				}
+
+				file << "        </Grid>\n";
+			}
+
+			file << "      </Grid>\n";
+		}
+
+		file << "    </Grid>\n";
+		file << "  </Domain>\n";
+		file << "</Xdmf>\n";
+	}
+
+	void HDF5Writer::WriteXdmfAttribute(std::ostream& file, const std::string& name, const std::string& center, const std::string& path)
+	{
+		const auto& shape = m_shapes.at(path);
+		std::string type = "Matrix";
+		switch (shape.Columns)
+		{
+		case 1:
+			type = "Scalar";
+			break;
+		case 3:
+			type = "Vector";
+			break;
+		case 6:
+			type = "Tensor6";
+			break;
+		default:;
+		}
+
+		file << "          <Attribute Name=\"" << name << "\" AttributeType=\"" << type << "\" Center=\"" << center << "\">\n";
+		WriteXdmfDataItem(file, path);
+		file << "          </Attribute>\n";
+	}
+
+	void HDF5Writer::WriteXdmfDataItem(std::ostream& file, const std::string& path)
+	{
+		const auto& shape = m_shapes.at(path);
+		file << "            <DataItem Dimensions=\"" << shape.Rows;
+		if (shape.Columns != 1)
+		{
+			file << " " << shape.Columns;
+		}
+		file << "\" NumberType=\"" << (shape.Integer ? "Int" : "Float") << "\" Precision=\"8\" Format=\"HDF\">";
+		file << FileBaseName(FileName()) << ":/" << path << "</DataItem>\n";
+	}
+
+}
+#endif
@@ -0,0 +1,220 @@
+/*
+ * ------------------------------------------------------------------------------------------------------------
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ * Copyright (c) 2018-2020 Lawrence Livermore National Security LLC
+ * Copyright (c) 2018-2020 The Board of Trustees of the Leland Stanford Junior University
+ * Copyright (c) 2018-2020 Total, S.A
+ * Copyright (c) 2020-     GEOSX Contributors
+ * All right reserved
+ *
+ * See top level LICENSE, COPYRIGHT, CONTRIBUTORS, NOTICE, and ACKNOWLEDGEMENTS files for details.
+ * ------------------------------------------------------------------------------------------------------------
+ */
+#pragma once
+// Library includes
+#include "MeshDataWriters/MeshDataWriter.hpp"
+
+#ifdef WITH_HDF5
+#include "Mesh/Mesh.hpp"
+#include <cstdint>
+#include <map>
+
+namespace PAMELA
+{
+
+	//HDF5 writer with an XDMF description of the datasets for visualization.
+	//Each part stores its points under /Mesh/<part>, and its owned elements grouped by type under /Mesh/<part>/<type>.
+	//Variables of step n are stored under /Steps/<n>, a variable is only written at the steps where it was modified.
+	//With a parallel HDF5 library all partitions write collectively in <name>.h5, otherwise each partition writes <name>_<partition>.h5.
+	class HDF5Writer : public MeshDataWriter
+	{
+
+	public:
+
+		HDF5Writer(Mesh * mesh, std::string name);
+
+		virtual void Init() final;
+		virtual void Dump() final;
+
+		//Deflate level of the datasets, from 0 (no compression) to 9
+		void set_Compression(int level);
+
+	private:
+
+		//Owned values of a dataset, one row per point or element
+		struct Dataset
+		{
+			Dataset(bool integer = false, std::size_t nColumns = 1) : Integer(integer), Columns(nColumns) {}
+			std::uint64_t Rows() const { return (Integer ? Indices.size() : Values.size()) / Columns; }
+			bool Integer;
+			std::size_t Columns;
+			std::vector<double> Values;
+			std::vector<std::int64_t> Indices;
+		};
+
+		//Global shape of a written dataset
+		struct Shape
+		{
+			std::uint64_t Rows;
+			std::size_t Columns;
+			bool Integer;
+		};
+
+		void WriteDatasets(std::map<std::string, Dataset>& datasets, bool newFile);
+
+		void MakeXdmfFile();
+
+		void WriteXdmfDataItem(std::ostream& file, const std::string& path);
+
+		void WriteXdmfAttribute(std::ostream& file, const std::string& name, const std::string& center, const std::string& path);
+
+		template<typename T>
+		void AddGeometry(const std::string& family, const PartMap<T>* parts, std::map<std::string, Dataset>& datasets);
+
+		template<typename T>
+		void AddVariables(const std::string& family, const PartMap<T>* parts, std::map<std::string, Dataset>& datasets);
+
+		std::string FileName();
+		std::string StepGroup(int timeStep);
+		static std::string GroupName(const std::string& label);
+
+		//Named after the family and the mesh group of the part, which are the same on all partitions
+		//(part labels and indices are not: labels are prefixed with the partition number, indices follow the hash map order)
+		static std::string PartGroup(const std::string& family, const std::string& group) { return family + "_" + GroupName(group); }
+
+		//Element type label, XDMF topology and number of vertices
+		struct ElementTopology
+		{
+			std::string Label;
+			std::string Topology;
+			int nVertex;
+		};
+
+		const std::unordered_map<int, ElementTopology> TypeToTopology
+			=
+		{
+			{ static_cast<int>(ELEMENTS::TYPE::VTK_VERTEX), { "point", "Polyvertex", 1 } },
+			{ static_cast<int>(ELEMENTS::TYPE::VTK_LINE), { "bar2", "Polyline", 2 } },
+			{ static_cast<int>(ELEMENTS::TYPE::VTK_TRIANGLE), { "tria3", "Triangle", 3 } },
+			{ static_cast<int>(ELEMENTS::TYPE::VTK_QUAD), { "quad4", "Quadrilateral", 4 } },
+			{ static_cast<int>(ELEMENTS::TYPE::VTK_TETRA), { "tetra4", "Tetrahedron", 4 } },
+			{ static_cast<int>(ELEMENTS::TYPE::VTK_HEXAHEDRON), { "hexa8", "Hexahedron", 8 } },
+			{ static_cast<int>(ELEMENTS::TYPE::VTK_WEDGE), { "penta6", "Wedge", 6 } },
+			{ static_cast<int>(ELEMENTS::TYPE::VTK_PYRAMID), { "pyramid5", "Pyramid", 5 } }
+		};
+
+		bool m_collective;
+		int m_compression;
+
+		//Shapes of the datasets written in the file, by path
+		std::map<std::string, Shape> m_shapes;
+
+		//Step holding the data of each variable at each step, -1 before the variable is first written
+		std::map<std::string, std::vector<int>> m_variableSteps;
+
+	};
+
+	template <typename T>
+	void HDF5Writer::AddGeometry(const std::string& family, const PartMap<T>* parts, std::map<std::string, Dataset>& datasets)
+	{
+		for (auto it = parts->begin(); it != parts->end(); ++it)
+		{
+			auto partptr = it->second;
+			const std::string partPath = "Mesh/" + PartGroup(family, it->first);
+
+			//Points of the part, connectivities refer to their index in the part (shifted to the whole dataset by WriteDatasets)
+			auto& coordinates = datasets.emplace(partPath + "/Coordinates", Dataset(false, 3)).first->second;
+			auto& pointIndex = datasets.emplace(partPath + "/GlobalIndex", Dataset(true)).first->second;
+			coordinates.Values.reserve(3 * partptr->Points.size());
+			pointIndex.Indices.reserve(partptr->Points.size());
+			for (auto point : partptr->Points)
+			{
+				const auto& xyz = point->get_coordinates();
+				coordinates.Values.insert(coordinates.Values.end(), { xyz.x, xyz.y, xyz.z });
+				pointIndex.Indices.push_back(point->get_globalIndex());
+			}
+
+			for (auto it2 = partptr->SubParts.begin(); it2 != partptr->SubParts.end(); ++it2)
+			{
+				auto subpart = it2->second;
+				if (subpart->SubCollection.size_owned() == 0)
+				{
+					continue;
+				}
+
+				const auto& topology = TypeToTopology.at(static_cast<int>(subpart->ElementType));
+				const std::string blockPath = partPath + "/" + topology.Label;
+				auto& connectivity = datasets.emplace(blockPath + "/Connectivity", Dataset(true, topology.nVertex)).first->second;
+				auto& elementIndex = datasets.emplace(blockPath + "/GlobalIndex", Dataset(true)).first->second;
+				auto& partition = datasets.emplace(blockPath + "/PartitionIndex", Dataset(true)).first->second;
+				for (auto it3 = subpart->SubCollection.begin_owned(); it3 != subpart->SubCollection.end_owned(); ++it3)
+				{
+					for (auto vertex : (*it3)->get_vertexList())
+					{
+						connectivity.Indices.push_back(partptr->GlobalToLocalPointMapping.at(vertex->get_globalIndex()));
+					}
+					elementIndex.Indices.push_back((*it3)->get_globalIndex());
+				}
+				partition.Indices.assign(elementIndex.Indices.size(), m_partition);
+			}
+		}
+	}
+
+	template <typename T>
+	void HDF5Writer::AddVariables(const std::string& family, const PartMap<T>* parts, std::map<std::string, Dataset>& datasets)
+	{
+		const std::string stepGroup = StepGroup(m_currentTimeStep);
+
+		for (auto it = parts->begin(); it != parts->end(); ++it)
+		{
+			auto partptr = it->second;
+			const std::string partPath = PartGroup(family, it->first);
+
+			//Per element variables are split in the element blocks of the part
+			for (auto variableptr : partptr->PerElementVariable)
+			{
+				if (!variableptr->Modified)
+				{
+					continue;
+				}
+
+				const auto& data = variableptr->get_data();
+				const auto offset = variableptr->offset;
+				for (auto it2 = partptr->SubParts.begin(); it2 != partptr->SubParts.end(); ++it2)
+				{
+					auto subpart = it2->second;
+					if (subpart->SubCollection.size_owned() == 0)
+					{
+						continue;
+					}
+
+					const std::string key = partPath + "/" + TypeToTopology.at(static_cast<int>(subpart->ElementType)).Label + "/" + GroupName(variableptr->Label);
+					auto& values = datasets.emplace(stepGroup + "/" + key, Dataset(false, offset)).first->second.Values;
+					values.reserve(subpart->SubCollection.size_owned()*offset);
+					for (std::size_t i = 0; i != subpart->SubCollection.size_owned(); ++i)
+					{
+						const auto variableIndex = subpart->IndexMapping[i];
+						values.insert(values.end(), data.begin() + variableIndex*offset, data.begin() + (variableIndex + 1)*offset);
+					}
+				}
+			}
+
+			//Per node variables are defined on the points of the part
+			for (auto variableptr : partptr->PerNodeVariable)
+			{
+				if (!variableptr->Modified)
+				{
+					continue;
+				}
+
+				const std::string key = partPath + "/" + GroupName(variableptr->Label);
+				auto& values = datasets.emplace(stepGroup + "/" + key, Dataset(false, variableptr->offset)).first->second.Values;
+				const auto& data = variableptr->get_data();
+				values.assign(data.begin(), data.begin() + partptr->Points.size()*variableptr->offset);
+			}
+		}
+	}
+
+}
+#endif
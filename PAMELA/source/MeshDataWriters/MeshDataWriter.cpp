@@ -16,6 +16,7 @@
 #include "Mesh/Mesh.hpp"
 #include "MeshDataWriters/MeshParts.hpp"
 #include "Elements/ElementFactory.hpp"
+#include <exception>
 
 namespace PAMELA
 {
@@ -31,6 +32,7 @@ namespace PAMELA
 		//Time
 		m_currentTime = 0.0;
 		m_currentTimeStep = 0;
+		m_inStep = false;
 
 		//////Initialize Parts
 
@@ -110,6 +112,76 @@ namespace PAMELA
 	* \brief
 	* \return
 	*/
+	void MeshDataWriter::BeginStep(double time)
+	{
+		ASSERT(!m_inStep, "BeginStep called before the end of the previous step");
+
+		if (!m_timeValues.empty())
+		{
+			ASSERT(time >= m_timeValues.back(), "Time values must be increasing");
+			++m_currentTimeStep;
+		}
+		m_currentTime = time;
+		m_timeValues.push_back(time);
+		m_inStep = true;
+	}
+
+	void MeshDataWriter::EndStep()
+	{
+		ASSERT(m_inStep, "EndStep called without BeginStep");
+
+		Dump();
+
+		ClearModifiedVariables(&m_PointParts);
+		ClearModifiedVariables(&m_LineParts);
+		ClearModifiedVariables(&m_PolygonParts);
+		ClearModifiedVariables(&m_PolyhedronParts);
+
+		m_inStep = false;
+	}
+
+	void MeshDataWriter::set_Asynchronous(bool asynchronous, std::size_t maxPendingDumps)
+	{
+		Wait();
+		m_writeQueue.reset(asynchronous ? new threadUtils::TaskQueue(maxPendingDumps) : nullptr);
+	}
+
+	void MeshDataWriter::Wait()
+	{
+		if (m_writeQueue)
+		{
+			m_writeQueue->Wait();
+		}
+	}
+
+	void MeshDataWriter::WaitNoThrow()
+	{
+		try
+		{
+			Wait();
+		}
+		catch (const std::exception& e)
+		{
+			LOGWARNING("Writing " + m_name + " failed: " + e.what());
+		}
+		catch (...)
+		{
+			LOGWARNING("Writing " + m_name + " failed");
+		}
+	}
+
+	void MeshDataWriter::Submit(std::function<void()> task)
+	{
+		if (m_writeQueue)
+		{
+			m_writeQueue->Push(std::move(task));
+		}
+		else
+		{
+			task();
+		}
+	}
+
 	std::string MeshDataWriter::TimeStepNumberForExtension()
 	{
 		std::string Ext = std::to_string(m_currentTimeStep);
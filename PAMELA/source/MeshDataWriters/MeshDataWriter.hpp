@@ -19,6 +19,9 @@
 #include "Parallel/Communicator.hpp"
 #include "Adjacency/Adjacency.hpp"
 #include "Adjacency/CSRGraph.hpp"
+#include "Utils/ThreadUtils.hpp"
+#include <functional>
+#include <memory>
 #if defined( _WIN32)
 #include <direct.h>
 #else
@@ -31,6 +34,9 @@ namespace PAMELA
 
 	enum class FAMILY { POLYHEDRON = 3, POLYGON = 2, LINE = 1, POINT = 0, UNKNOWN = -1 };
 
+	//Encoding of the output files, for the formats supporting both
+	enum class ENCODING { ASCII = 0, BINARY = 1 };
+
 	class Mesh;
 
 
@@ -181,9 +187,36 @@ namespace PAMELA
 
 		virtual void Dump() = 0;
 
+		//Time series: geometry is written once by Init(), each step writes the variables set between BeginStep and EndStep
+		void BeginStep(double time);
+		void EndStep();
+
+		//Asynchronous output: Dump() snapshots the variables and returns, a background thread formats and writes the files.
+		//Dump() blocks while maxPendingDumps snapshots are not written yet.
+		void set_Asynchronous(bool asynchronous, std::size_t maxPendingDumps = 2);
+
+		//Wait for the pending dumps to be written
+		void Wait();
+
 
 	private:
 
+		template<typename T>
+		void ClearModifiedVariables(PartMap<T>* partMap)
+		{
+			for (auto it = partMap->begin(); it != partMap->end(); ++it)
+			{
+				for (auto variable : it->second->PerElementVariable)
+				{
+					variable->Modified = false;
+				}
+				for (auto variable : it->second->PerNodeVariable)
+				{
+					variable->Modified = false;
+				}
+			}
+		}
+
 		template<typename T>
 		void SetElementGlobalIndexOnPart(PartMap<T>* partMap) {
 			for (auto it = partMap->begin(); it != partMap->end(); ++it)
@@ -210,6 +243,12 @@ namespace PAMELA
 		std::string PartitionNumberForExtension();
 		std::string TimeStepNumberForExtension();
 
+		//Run a write task in the background thread if the writer is asynchronous, right away otherwise
+		void Submit(std::function<void()> task);
+
+		//Wait for the pending dumps from a destructor: a failed write is logged instead of rethrown
+		void WaitNoThrow();
+
 		Mesh* m_mesh;
 
 		std::string m_name;
@@ -220,6 +259,10 @@ namespace PAMELA
 		double m_currentTime;
 		int m_currentTimeStep;
 
+		//Time values of the steps, empty if BeginStep was never called
+		std::vector<double> m_timeValues;
+		bool m_inStep;
+
 		int m_nDigitsExtensionPartition;
 		int m_nDigitsExtensionTime;
 
@@ -235,5 +278,8 @@ namespace PAMELA
 		//Adjacency
 		std::vector<AdjacencyData> m_Adjacency;
 
+		//Background writes
+		std::unique_ptr<threadUtils::TaskQueue> m_writeQueue;
+
 	};
 }
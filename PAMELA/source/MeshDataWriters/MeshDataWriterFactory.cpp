@@ -14,7 +14,9 @@
 
 #include "MeshDataWriters/MeshDataWriterFactory.hpp"
 #include "MeshDataWriters/EnsightGoldWriter.hpp"
+#include "MeshDataWriters/HDF5Writer.hpp"
 #include "MeshDataWriters/VTKWriter.hpp"
+#include "MeshDataWriters/VTUWriter.hpp"
 #include "Utils/Logger.hpp"
 
 #include <string>
@@ -23,7 +25,8 @@ namespace PAMELA
 {
 	MeshDataWriter* MeshDataWriterFactory::makeWriter(
                 Mesh * mesh,
-                const std::string& file_path)
+                const std::string& file_path,
+                ENCODING encoding)
 	{
 		LOGINFO("**********************************************************************");
 		LOGINFO("                         PAMELA Library Export tool                   ");
@@ -45,11 +48,27 @@ namespace PAMELA
 		}
 #endif // WITH_VTK
 
+#ifdef WITH_HDF5
+		if ((file_extension == "h5") || (file_extension == "H5") || (file_extension == "xmf") || (file_extension == "XMF"))
+		{
+			LOGINFO("HDF5 OUTPUT MESH FORMAT IDENTIFIED");
+			HDF5Writer* writer = new HDF5Writer(mesh, file_wo_extension);
+			return  writer;
+		}
+#endif // WITH_HDF5
+
+		if ((file_extension == "vtu") || (file_extension == "VTU") || (file_extension == "pvtu") || (file_extension == "PVTU"))
+		{
+			LOGINFO("VTU OUTPUT MESH FORMAT IDENTIFIED");
+			VTUWriter* writer = new VTUWriter(mesh, file_wo_extension);
+			return  writer;
+		}
+
 		if ((file_extension == "case") || (file_extension == "CASE"))
 		{
 			LOGINFO("ENSIGHT GOLD OUTPUT MESH FORMAT IDENTIFIED");
                         EnsightGoldWriter * writer =
-                            new EnsightGoldWriter( mesh,file_wo_extension);
+                            new EnsightGoldWriter( mesh,file_wo_extension, encoding);
 			return  writer;
 		}
 		else
@@ -24,7 +24,8 @@ namespace PAMELA
 	public:
 
 		static MeshDataWriter* makeWriter(Mesh * mesh,
-                        const std::string& file_path);
+                        const std::string& file_path,
+                        ENCODING encoding = ENCODING::ASCII);
 
 	private:
 		MeshDataWriterFactory() = delete;
@@ -84,12 +84,13 @@ namespace PAMELA {
 
 
         //----Map Point Coordinates
-        int i = 0;
+        std::vector<int> pointGlobalIndices; pointGlobalIndices.reserve(partptr->Points.size());
         for (auto it2 = partptr->Points.begin(); it2 != partptr->Points.end(); ++it2)
         {
-          partptr->GlobalToLocalPointMapping[(*it2)->get_globalIndex()] = i;
-          i++;
+          pointGlobalIndices.push_back((*it2)->get_globalIndex());
         }
+        //Points sharing a global index (e.g. -1) map to the last of them
+        partptr->GlobalToLocalPointMapping.Build(pointGlobalIndices, IndexMap::DUPLICATES::KEEP_LAST);
 
       }
 
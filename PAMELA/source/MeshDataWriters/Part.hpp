@@ -17,6 +17,7 @@
 #include "Elements/Element.hpp"
 #include "Collection/Collection.hpp"
 #include "MeshDataWriters/Variable.hpp"
+#include "Utils/IndexMap.hpp"
 
 #if defined( _WIN32)
 #include <direct.h>
@@ -78,7 +79,7 @@ namespace PAMELA
 		std::string Label;
 		ElementEnsemble<T, ElementHash<T>, ElementEqual<T>>* Collection;
 		std::vector<Point*> Points;
-		std::unordered_map<int, int> GlobalToLocalPointMapping;
+		IndexMap GlobalToLocalPointMapping;
 		std::unordered_map<int, SubPart<T>*> SubParts;
 		std::unordered_map<int, int> numberOfElementsPerSubPart
 			=
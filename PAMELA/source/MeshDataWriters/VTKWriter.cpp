@@ -19,6 +19,7 @@
 #include "MeshDataWriters/Variable.hpp"
 #include "Parallel/Communicator.hpp"
 #include "Utils/Logger.hpp"
+#include "Utils/Statistics.hpp"
 #include "Utils/Utils.hpp"
 
 #include <vtkMPIController.h>
@@ -40,6 +41,8 @@ namespace PAMELA
 {
     /// -------------- PUBLIC METHODS
     void VTKWriter::Dump() {
+        PAMELA_REGION("VTKWriter::Dump");
+        m_block_ = vtkSmartPointer<vtkMultiBlockDataSet>::New();
         DeclareAllVariables();
         MakeChildFiles();
         MakeParentFile();
@@ -193,7 +196,7 @@ namespace PAMELA
 			multi_block->SetBlock(0, m_block_);
 
 			//Create master file
-			std::string filename = m_name + ".vtm";
+			std::string filename = m_timeValues.empty() ? m_name + ".vtm" : m_name + "_" + TimeStepNumberForExtension() + ".vtm";
 			vtkSmartPointer< vtkXMLMultiBlockDataWriter> write =
 				vtkXMLMultiBlockDataWriter::New();
 			write->SetInputData(multi_block);
@@ -0,0 +1,613 @@
+/*
+ * ------------------------------------------------------------------------------------------------------------
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ * Copyright (c) 2018-2020 Lawrence Livermore National Security LLC
+ * Copyright (c) 2018-2020 The Board of Trustees of the Leland Stanford Junior University
+ * Copyright (c) 2018-2020 Total, S.A
+ * Copyright (c) 2020-     GEOSX Contributors
+ * All right reserved
+ *
+ * See top level LICENSE, COPYRIGHT, CONTRIBUTORS, NOTICE, and ACKNOWLEDGEMENTS files for details.
+ * ------------------------------------------------------------------------------------------------------------
+ */
+
+#include "MeshDataWriters/VTUWriter.hpp"
+#include "Utils/Logger.hpp"
+#include "Utils/Statistics.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+#ifdef WITH_ZLIB
+#include <zlib.h>
+#endif
+
+namespace PAMELA
+{
+
+	namespace
+	{
+		//Arrays are written in native byte order, which is declared in the file header
+		std::string ByteOrder()
+		{
+			const std::uint16_t one = 1;
+			return (*reinterpret_cast<const char*>(&one) == 1) ? "LittleEndian" : "BigEndian";
+		}
+
+		std::string FileBaseName(const std::string& path)
+		{
+			return path.substr(path.find_last_of("/\\") + 1);
+		}
+
+		std::string PaddedNumber(int value, int nDigits)
+		{
+			std::string number = std::to_string(value);
+			number.insert(0, std::max(0, nDigits - static_cast<int>(number.size())), '0');
+			return number;
+		}
+	}
+
+	void VTUWriter::set_Compression(bool compression)
+	{
+		Wait();
+#ifdef WITH_ZLIB
+		m_compression = compression;
+#else
+		if (compression)
+		{
+			LOGWARNING("PAMELA is built without zlib, VTU arrays are written uncompressed");
+		}
+		m_compression = false;
+#endif
+	}
+
+	void VTUWriter::set_SingleFile(bool singleFile, int nAggregators)
+	{
+		Wait();
+		m_singleFile = singleFile;
+		m_nAggregators = nAggregators;
+		if (m_singleFile && m_compression)
+		{
+			LOGWARNING("VTU arrays are written uncompressed in single-file mode");
+		}
+	}
+
+	/**
+	 * \brief Build the connectivity of the owned elements of all parts
+	 */
+	void VTUWriter::Init()
+	{
+		PAMELA_REGION("VTUWriter::Init");
+		LOGINFO("*** Init VTU Writer");
+
+		Wait();
+
+		m_extraPoints.clear();
+		m_extraPointIndex.clear();
+		m_connectivity.clear();
+		m_offsets.clear();
+		m_types.clear();
+		m_partIndex.clear();
+		m_encodedStaticArrays.clear();
+
+		AddCells(&m_PointParts);
+		AddCells(&m_LineParts);
+		AddCells(&m_PolygonParts);
+		AddCells(&m_PolyhedronParts);
+
+		LOGINFO("*** Done");
+	}
+
+	void VTUWriter::Dump()
+	{
+		PAMELA_REGION("VTUWriter::Dump");
+		LOGINFO("*** Dump VTU files");
+
+		m_cellVariables.clear();
+		m_pointVariables.clear();
+
+		AddVariableNames(&m_PointParts);
+		AddVariableNames(&m_LineParts);
+		AddVariableNames(&m_PolygonParts);
+		AddVariableNames(&m_PolyhedronParts);
+
+		auto snapshot = TakeSnapshot();
+
+		//Collective writes are not issued from the background thread, MPI may not be initialized for it
+		if (m_singleFile)
+		{
+			Wait();
+			MakeSharedFile(*snapshot);
+			if ((m_partition == 0) && !snapshot->Steps.empty())
+			{
+				MakeCollectionFile(*snapshot);
+			}
+			LOGINFO("*** Done");
+			return;
+		}
+
+		Submit([this, snapshot]()
+		{
+			PAMELA_REGION("VTUWriter::WriteFiles");
+			MakePieceFile(*snapshot);
+			if (m_partition == 0)
+			{
+				MakeParentFile(*snapshot);
+				if (!snapshot->Steps.empty())
+				{
+					MakeCollectionFile(*snapshot);
+				}
+			}
+		});
+
+		LOGINFO("*** Done");
+	}
+
+	std::int32_t VTUWriter::AddPoint(Point* vertex)
+	{
+		auto index = get_PointIndex(vertex);
+		if (index < 0)
+		{
+			index = static_cast<std::int32_t>(m_mesh->get_PointCollection()->size_all() + m_extraPoints.size());
+			m_extraPointIndex[vertex] = index;
+			m_extraPoints.push_back(vertex);
+		}
+		return index;
+	}
+
+	std::int32_t VTUWriter::get_PointIndex(const Point* vertex) const
+	{
+		auto pointCollection = m_mesh->get_PointCollection();
+		const auto localIndex = vertex->get_localIndex();
+		if ((localIndex >= 0) && (static_cast<std::size_t>(localIndex) < pointCollection->size_all()) && ((*pointCollection)[localIndex] == vertex))
+		{
+			return localIndex;
+		}
+		auto it = m_extraPointIndex.find(vertex);
+		return it != m_extraPointIndex.end() ? it->second : -1;
+	}
+
+	std::string VTUWriter::StepFileName(int timeStep)
+	{
+		return m_name + "_" + PaddedNumber(timeStep, m_nDigitsExtensionTime);
+	}
+
+	std::string VTUWriter::PieceFileName(Types::uint_t partition)
+	{
+		return StepFileName(m_currentTimeStep) + "_" + PaddedNumber(static_cast<int>(partition) + 1, m_nDigitsExtensionPartition) + ".vtu";
+	}
+
+	std::shared_ptr<VTUWriter::Snapshot> VTUWriter::TakeSnapshot()
+	{
+		auto snapshot = std::make_shared<Snapshot>();
+
+		snapshot->PieceFile = m_singleFile ? StepFileName(m_currentTimeStep) + ".vtu" : PieceFileName(m_partition);
+		if (m_partition == 0)
+		{
+			snapshot->ParentFile = StepFileName(m_currentTimeStep) + ".pvtu";
+			for (Types::uint_t partition = 0; partition != m_nPartition; ++partition)
+			{
+				snapshot->PieceSources.push_back(FileBaseName(PieceFileName(partition)));
+			}
+			for (std::size_t step = 0; step != m_timeValues.size(); ++step)
+			{
+				snapshot->Steps.emplace_back(m_timeValues[step], FileBaseName(StepFileName(static_cast<int>(step))) + (m_singleFile ? ".vtu" : ".pvtu"));
+			}
+		}
+		snapshot->CellVariables = m_cellVariables;
+		snapshot->PointVariables = m_pointVariables;
+
+		auto pointCollection = m_mesh->get_PointCollection();
+		const std::size_t nCollectionPoints = pointCollection->size_all();
+		const std::size_t nPoints = nCollectionPoints + m_extraPoints.size();
+		const std::size_t nCells = m_types.size();
+		snapshot->NumberOfPoints = nPoints;
+
+		//Coordinates
+		auto& coordinates = snapshot->Coordinates;
+		coordinates.resize(3 * nPoints);
+		for (std::size_t i = 0; i != nPoints; ++i)
+		{
+			const auto& xyz = (i < nCollectionPoints ? (*pointCollection)[i] : m_extraPoints[i - nCollectionPoints])->get_coordinates();
+			coordinates[3 * i] = xyz.x;
+			coordinates[3 * i + 1] = xyz.y;
+			coordinates[3 * i + 2] = xyz.z;
+		}
+
+		//Variables, elements or points not covered by a part holding the variable are set to NaN
+		auto& pointValues = snapshot->PointValues;
+		pointValues.reserve(m_pointVariables.size());
+		for (auto const& variable : m_pointVariables)
+		{
+			pointValues.emplace_back(nPoints*variable.second, std::numeric_limits<double>::quiet_NaN());
+			FillPointVariable(&m_PointParts, variable.first, variable.second, pointValues.back());
+			FillPointVariable(&m_LineParts, variable.first, variable.second, pointValues.back());
+			FillPointVariable(&m_PolygonParts, variable.first, variable.second, pointValues.back());
+			FillPointVariable(&m_PolyhedronParts, variable.first, variable.second, pointValues.back());
+		}
+
+		auto& cellValues = snapshot->CellValues;
+		cellValues.reserve(m_cellVariables.size());
+		for (auto const& variable : m_cellVariables)
+		{
+			cellValues.emplace_back();
+			cellValues.back().reserve(nCells*variable.second);
+			FillCellVariable(&m_PointParts, variable.first, variable.second, cellValues.back());
+			FillCellVariable(&m_LineParts, variable.first, variable.second, cellValues.back());
+			FillCellVariable(&m_PolygonParts, variable.first, variable.second, cellValues.back());
+			FillCellVariable(&m_PolyhedronParts, variable.first, variable.second, cellValues.back());
+		}
+
+		return snapshot;
+	}
+
+	/**
+	 * \brief Appended arrays of a dump in the order they are declared. sections holds the index of the first point data, cell data,
+	 * points and cells arrays, followed by the number of arrays.
+	 */
+	void VTUWriter::CollectArrays(const Snapshot& snapshot, std::vector<AppendedArray>& arrays, std::vector<std::size_t>& sections)
+	{
+		sections.clear();
+
+		sections.push_back(arrays.size());
+		auto pointValue = snapshot.PointValues.begin();
+		for (auto const& variable : snapshot.PointVariables)
+		{
+			arrays.emplace_back(variable.first, "Float64", variable.second, pointValue->data(), pointValue->size() * sizeof(double));
+			++pointValue;
+		}
+
+		sections.push_back(arrays.size());
+		auto cellValue = snapshot.CellValues.begin();
+		for (auto const& variable : snapshot.CellVariables)
+		{
+			arrays.emplace_back(variable.first, "Float64", variable.second, cellValue->data(), cellValue->size() * sizeof(double));
+			++cellValue;
+		}
+		arrays.emplace_back("Part", "Int32", 1, m_partIndex.data(), m_partIndex.size() * sizeof(std::int32_t), true);
+
+		sections.push_back(arrays.size());
+		arrays.emplace_back("Points", "Float64", 3, snapshot.Coordinates.data(), snapshot.Coordinates.size() * sizeof(double));
+
+		sections.push_back(arrays.size());
+		arrays.emplace_back("connectivity", "Int32", 1, m_connectivity.data(), m_connectivity.size() * sizeof(std::int32_t), true);
+		arrays.emplace_back("offsets", "Int64", 1, m_offsets.data(), m_offsets.size() * sizeof(std::int64_t), true);
+		arrays.emplace_back("types", "UInt8", 1, m_types.data(), m_types.size() * sizeof(std::uint8_t), true);
+
+		sections.push_back(arrays.size());
+	}
+
+	std::string VTUWriter::MakeHeader(const std::vector<AppendedArray>& arrays, const std::vector<std::size_t>& sections, const std::vector<std::uint64_t>& offsets,
+		std::uint64_t nPoints, std::uint64_t nCells, bool compressed)
+	{
+		std::ostringstream header;
+		header << "<?xml version=\"1.0\"?>\n";
+		header << "<VTKFile type=\"UnstructuredGrid\" version=\"1.0\" byte_order=\"" << ByteOrder() << "\" header_type=\"UInt64\"";
+		if (compressed)
+		{
+			header << " compressor=\"vtkZLibDataCompressor\"";
+		}
+		header << ">\n";
+		header << "  <UnstructuredGrid>\n";
+		header << "    <Piece NumberOfPoints=\"" << nPoints << "\" NumberOfCells=\"" << nCells << "\">\n";
+		header << "      <PointData>\n";
+		WriteDataArrays(header, arrays, sections[0], sections[1], offsets);
+		header << "      </PointData>\n";
+		header << "      <CellData>\n";
+		WriteDataArrays(header, arrays, sections[1], sections[2], offsets);
+		header << "      </CellData>\n";
+		header << "      <Points>\n";
+		WriteDataArrays(header, arrays, sections[2], sections[3], offsets);
+		header << "      </Points>\n";
+		header << "      <Cells>\n";
+		WriteDataArrays(header, arrays, sections[3], sections[4], offsets);
+		header << "      </Cells>\n";
+		header << "    </Piece>\n";
+		header << "  </UnstructuredGrid>\n";
+		header << "  <AppendedData encoding=\"raw\">\n";
+		header << "   _";
+		return header.str();
+	}
+
+	void VTUWriter::MakePieceFile(const Snapshot& snapshot)
+	{
+		std::vector<AppendedArray> arrays;
+		std::vector<std::size_t> sections;
+		CollectArrays(snapshot, arrays, sections);
+
+		//Encode if needed and compute offsets in the appended data section
+		std::vector<std::vector<char>> encodedArrays(m_compression ? arrays.size() : 0);
+		std::vector<const std::vector<char>*> encoded(encodedArrays.size());
+		std::vector<std::uint64_t> offsets(arrays.size() + 1, 0);
+		for (std::size_t i = 0; i != arrays.size(); ++i)
+		{
+			if (m_compression)
+			{
+				if (arrays[i].Static)
+				{
+					auto cached = m_encodedStaticArrays.find(arrays[i].Name);
+					if (cached == m_encodedStaticArrays.end())
+					{
+						cached = m_encodedStaticArrays.emplace(arrays[i].Name, std::vector<char>()).first;
+						EncodeArray(arrays[i], cached->second);
+					}
+					encoded[i] = &cached->second;
+				}
+				else
+				{
+					EncodeArray(arrays[i], encodedArrays[i]);
+					encoded[i] = &encodedArrays[i];
+				}
+				offsets[i + 1] = offsets[i] + encoded[i]->size();
+			}
+			else
+			{
+				offsets[i + 1] = offsets[i] + sizeof(std::uint64_t) + arrays[i].Size;
+			}
+		}
+
+		//Write
+		std::ofstream file(snapshot.PieceFile, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!file)
+		{
+			LOGERROR("Unable to open " + snapshot.PieceFile);
+		}
+
+		const std::string header = MakeHeader(arrays, sections, offsets, snapshot.NumberOfPoints, m_types.size(), m_compression);
+		file.write(header.data(), header.size());
+		for (std::size_t i = 0; i != arrays.size(); ++i)
+		{
+			if (m_compression)
+			{
+				file.write(encoded[i]->data(), encoded[i]->size());
+			}
+			else
+			{
+				const std::uint64_t size = arrays[i].Size;
+				file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+				file.write(arrays[i].Data, arrays[i].Size);
+			}
+		}
+		file << "\n  </AppendedData>\n";
+		file << "</VTKFile>\n";
+	}
+
+	/**
+	 * \brief Write all partitions in one file. Each appended array is the concatenation of the partition slices in rank order,
+	 * the slice offsets are obtained with an exclusive scan of the local sizes. Point indices and cell offsets are shifted to be global.
+	 */
+	void VTUWriter::MakeSharedFile(const Snapshot& snapshot)
+	{
+		std::vector<AppendedArray> arrays;
+		std::vector<std::size_t> sections;
+		CollectArrays(snapshot, arrays, sections);
+
+		//Number of points, cells and connectivity entries before this partition and in total
+		std::vector<std::uint64_t> localCounts = { snapshot.NumberOfPoints, m_types.size(), m_connectivity.size() };
+		std::vector<std::uint64_t> countsBefore(localCounts.size(), 0);
+		std::vector<std::uint64_t> totalCounts(localCounts);
+#ifdef WITH_MPI
+		MPI_Exscan(localCounts.data(), countsBefore.data(), static_cast<int>(localCounts.size()), MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD);
+		MPI_Allreduce(localCounts.data(), totalCounts.data(), static_cast<int>(localCounts.size()), MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD);
+		if (m_partition == 0)
+		{
+			std::fill(countsBefore.begin(), countsBefore.end(), 0);
+		}
+#endif
+
+		std::vector<std::int64_t> connectivity(m_connectivity.begin(), m_connectivity.end());
+		for (auto& vertex : connectivity)
+		{
+			vertex += countsBefore[0];
+		}
+		std::vector<std::int64_t> offsets(m_offsets);
+		for (auto& offset : offsets)
+		{
+			offset += countsBefore[2];
+		}
+		arrays[sections[3]] = AppendedArray("connectivity", "Int64", 1, connectivity.data(), connectivity.size() * sizeof(std::int64_t));
+		arrays[sections[3] + 1] = AppendedArray("offsets", "Int64", 1, offsets.data(), offsets.size() * sizeof(std::int64_t));
+
+		//Bytes of each array before this partition and in total
+		const std::size_t nArrays = arrays.size();
+		std::vector<std::uint64_t> localSizes(nArrays);
+		for (std::size_t i = 0; i != nArrays; ++i)
+		{
+			localSizes[i] = arrays[i].Size;
+		}
+		std::vector<std::uint64_t> sizesBefore(nArrays, 0);
+		std::vector<std::uint64_t> totalSizes(localSizes);
+#ifdef WITH_MPI
+		MPI_Exscan(localSizes.data(), sizesBefore.data(), static_cast<int>(nArrays), MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD);
+		MPI_Allreduce(localSizes.data(), totalSizes.data(), static_cast<int>(nArrays), MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD);
+		if (m_partition == 0)
+		{
+			std::fill(sizesBefore.begin(), sizesBefore.end(), 0);
+		}
+#endif
+
+		std::vector<std::uint64_t> appendedOffsets(nArrays + 1, 0);
+		for (std::size_t i = 0; i != nArrays; ++i)
+		{
+			appendedOffsets[i + 1] = appendedOffsets[i] + sizeof(std::uint64_t) + totalSizes[i];
+		}
+
+		//The header only depends on global sizes, every partition knows where the appended data starts
+		const std::string header = MakeHeader(arrays, sections, appendedOffsets, totalCounts[0], totalCounts[1], false);
+		const std::string footer = "\n  </AppendedData>\n</VTKFile>\n";
+
+#ifdef WITH_MPI
+		const std::uint64_t appendedStart = header.size();
+
+		//Collective writes take an int count: slices are written in chunks, every partition issuing the same number of calls
+		const std::uint64_t chunkSize = 1 << 30;
+		std::vector<std::uint64_t> nChunks(nArrays);
+		for (std::size_t i = 0; i != nArrays; ++i)
+		{
+			nChunks[i] = (localSizes[i] + chunkSize - 1) / chunkSize;
+		}
+		MPI_Allreduce(MPI_IN_PLACE, nChunks.data(), static_cast<int>(nArrays), MPI_UINT64_T, MPI_MAX, MPI_COMM_WORLD);
+
+		MPI_Info info;
+		MPI_Info_create(&info);
+		MPI_Info_set(info, const_cast<char*>("romio_cb_write"), const_cast<char*>("enable"));
+		if (m_nAggregators > 0)
+		{
+			MPI_Info_set(info, const_cast<char*>("cb_nodes"), const_cast<char*>(std::to_string(m_nAggregators).c_str()));
+		}
+
+		MPI_File file;
+		if (MPI_File_open(MPI_COMM_WORLD, const_cast<char*>(snapshot.PieceFile.c_str()), MPI_MODE_CREATE | MPI_MODE_WRONLY, info, &file) != MPI_SUCCESS)
+		{
+			LOGERROR("Unable to open " + snapshot.PieceFile);
+		}
+		MPI_File_set_size(file, 0);
+
+		if (m_partition == 0)
+		{
+			MPI_File_write_at(file, 0, const_cast<char*>(header.data()), static_cast<int>(header.size()), MPI_BYTE, MPI_STATUS_IGNORE);
+			for (std::size_t i = 0; i != nArrays; ++i)
+			{
+				MPI_File_write_at(file, appendedStart + appendedOffsets[i], &totalSizes[i], 1, MPI_UINT64_T, MPI_STATUS_IGNORE);
+			}
+			MPI_File_write_at(file, appendedStart + appendedOffsets[nArrays], const_cast<char*>(footer.data()), static_cast<int>(footer.size()), MPI_BYTE, MPI_STATUS_IGNORE);
+		}
+
+		for (std::size_t i = 0; i != nArrays; ++i)
+		{
+			const MPI_Offset position = appendedStart + appendedOffsets[i] + sizeof(std::uint64_t) + sizesBefore[i];
+			for (std::uint64_t chunk = 0; chunk != nChunks[i]; ++chunk)
+			{
+				const std::uint64_t begin = std::min(chunk * chunkSize, localSizes[i]);
+				const std::uint64_t size = std::min(chunkSize, localSizes[i] - begin);
+				MPI_File_write_at_all(file, position + begin, const_cast<char*>(arrays[i].Data + begin), static_cast<int>(size), MPI_BYTE, MPI_STATUS_IGNORE);
+			}
+		}
+
+		MPI_File_close(&file);
+		MPI_Info_free(&info);
+#else
+		std::ofstream file(snapshot.PieceFile, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!file)
+		{
+			LOGERROR("Unable to open " + snapshot.PieceFile);
+		}
+
+		file.write(header.data(), header.size());
+		for (std::size_t i = 0; i != nArrays; ++i)
+		{
+			file.write(reinterpret_cast<const char*>(&totalSizes[i]), sizeof(std::uint64_t));
+			file.write(arrays[i].Data, arrays[i].Size);
+		}
+		file.write(footer.data(), footer.size());
+#endif
+	}
+
+	void VTUWriter::MakeParentFile(const Snapshot& snapshot)
+	{
+		std::ofstream file(snapshot.ParentFile, std::ios::out | std::ios::trunc);
+		if (!file)
+		{
+			LOGERROR("Unable to open " + snapshot.ParentFile);
+		}
+
+		file << "<?xml version=\"1.0\"?>\n";
+		file << "<VTKFile type=\"PUnstructuredGrid\" version=\"1.0\" byte_order=\"" << ByteOrder() << "\" header_type=\"UInt64\">\n";
+		file << "  <PUnstructuredGrid GhostLevel=\"0\">\n";
+		file << "    <PPointData>\n";
+		for (auto const& variable : snapshot.PointVariables)
+		{
+			file << "      <PDataArray type=\"Float64\" Name=\"" << variable.first << "\" NumberOfComponents=\"" << variable.second << "\"/>\n";
+		}
+		file << "    </PPointData>\n";
+		file << "    <PCellData>\n";
+		for (auto const& variable : snapshot.CellVariables)
+		{
+			file << "      <PDataArray type=\"Float64\" Name=\"" << variable.first << "\" NumberOfComponents=\"" << variable.second << "\"/>\n";
+		}
+		file << "      <PDataArray type=\"Int32\" Name=\"Part\" NumberOfComponents=\"1\"/>\n";
+		file << "    </PCellData>\n";
+		file << "    <PPoints>\n";
+		file << "      <PDataArray type=\"Float64\" NumberOfComponents=\"3\"/>\n";
+		file << "    </PPoints>\n";
+		for (auto const& source : snapshot.PieceSources)
+		{
+			file << "    <Piece Source=\"" << source << "\"/>\n";
+		}
+		file << "  </PUnstructuredGrid>\n";
+		file << "</VTKFile>\n";
+	}
+
+	void VTUWriter::MakeCollectionFile(const Snapshot& snapshot)
+	{
+		const std::string filename = m_name + ".pvd";
+		std::ofstream file(filename, std::ios::out | std::ios::trunc);
+		if (!file)
+		{
+			LOGERROR("Unable to open " + filename);
+		}
+
+		file << std::setprecision(std::numeric_limits<double>::max_digits10);
+		file << "<?xml version=\"1.0\"?>\n";
+		file << "<VTKFile type=\"Collection\" version=\"1.0\" byte_order=\"" << ByteOrder() << "\">\n";
+		file << "  <Collection>\n";
+		for (auto const& step : snapshot.Steps)
+		{
+			file << "    <DataSet timestep=\"" << step.first << "\" part=\"0\" file=\"" << step.second << "\"/>\n";
+		}
+		file << "  </Collection>\n";
+		file << "</VTKFile>\n";
+	}
+
+	void VTUWriter::WriteDataArrays(std::ostream& file, const std::vector<AppendedArray>& arrays, std::size_t begin, std::size_t end, const std::vector<std::uint64_t>& offsets)
+	{
+		for (std::size_t i = begin; i != end; ++i)
+		{
+			file << "        <DataArray type=\"" << arrays[i].Type << "\" Name=\"" << arrays[i].Name << "\" NumberOfComponents=\"" << arrays[i].NumberOfComponents
+				<< "\" format=\"appended\" offset=\"" << offsets[i] << "\"/>\n";
+		}
+	}
+
+	/**
+	 * \brief Compress an array in the vtkZLibDataCompressor layout: a header holding the number of blocks, the block size,
+	 * the size of the last partial block and the compressed size of each block, followed by the compressed blocks.
+	 */
+	void VTUWriter::EncodeArray(const AppendedArray& array, std::vector<char>& encoded)
+	{
+#ifdef WITH_ZLIB
+		const std::uint64_t blockSize = 1 << 16;
+		const std::uint64_t nBlocks = (array.Size + blockSize - 1) / blockSize;
+
+		std::vector<std::uint64_t> header(3 + nBlocks);
+		header[0] = nBlocks;
+		header[1] = blockSize;
+		header[2] = array.Size % blockSize;
+
+		std::vector<char> blocks(nBlocks*compressBound(blockSize));
+		std::size_t position = 0;
+		for (std::uint64_t block = 0; block != nBlocks; ++block)
+		{
+			const std::uint64_t begin = block*blockSize;
+			const std::uint64_t size = std::min(blockSize, array.Size - begin);
+			uLongf compressedSize = static_cast<uLongf>(blocks.size() - position);
+			//Favor throughput over ratio
+			if (compress2(reinterpret_cast<Bytef*>(&blocks[position]), &compressedSize, reinterpret_cast<const Bytef*>(array.Data + begin), static_cast<uLong>(size), Z_BEST_SPEED) != Z_OK)
+			{
+				LOGERROR("Compression of array " + array.Name + " failed");
+			}
+			header[3 + block] = compressedSize;
+			position += compressedSize;
+		}
+
+		const char* headerBytes = reinterpret_cast<const char*>(header.data());
+		encoded.assign(headerBytes, headerBytes + header.size() * sizeof(std::uint64_t));
+		encoded.insert(encoded.end(), blocks.begin(), blocks.begin() + position);
+#else
+		(void)array;
+		encoded.clear();
+		LOGERROR("PAMELA is built without zlib");
+#endif
+	}
+
+}
@@ -0,0 +1,218 @@
+/*
+ * ------------------------------------------------------------------------------------------------------------
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ * Copyright (c) 2018-2020 Lawrence Livermore National Security LLC
+ * Copyright (c) 2018-2020 The Board of Trustees of the Leland Stanford Junior University
+ * Copyright (c) 2018-2020 Total, S.A
+ * Copyright (c) 2020-     GEOSX Contributors
+ * All right reserved
+ *
+ * See top level LICENSE, COPYRIGHT, CONTRIBUTORS, NOTICE, and ACKNOWLEDGEMENTS files for details.
+ * ------------------------------------------------------------------------------------------------------------
+ */
+#pragma once
+// Library includes
+#include "MeshDataWriters/MeshDataWriter.hpp"
+#include "Mesh/Mesh.hpp"
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <unordered_map>
+
+namespace PAMELA
+{
+
+	//Native VTK XML writer: one binary .vtu per partition with raw appended arrays, and a .pvtu index written by partition 0.
+	//Does not depend on VTK. Arrays may be zlib-compressed if PAMELA is built with WITH_ZLIB.
+	//In single-file mode, all partitions write their slice of each array into one .vtu per step with MPI-IO collective writes.
+	class VTUWriter : public MeshDataWriter
+	{
+
+	public:
+
+		VTUWriter(Mesh * mesh, std::string name) : MeshDataWriter(mesh, name), m_compression(false), m_singleFile(false), m_nAggregators(0) {}
+		~VTUWriter() { WaitNoThrow(); }
+
+		virtual void Init() final;
+		virtual void Dump() final;
+
+		void set_Compression(bool compression);
+
+		//Write one shared file per step instead of one file per partition. Arrays are not compressed in this mode.
+		//nAggregators is the number of ranks performing the collective writes, 0 lets MPI-IO decide.
+		void set_SingleFile(bool singleFile, int nAggregators = 0);
+
+	private:
+
+		struct AppendedArray
+		{
+			AppendedArray(std::string name, std::string type, int nComponents, const void* data, std::size_t size, bool isStatic = false)
+				: Name(name), Type(type), NumberOfComponents(nComponents), Data(static_cast<const char*>(data)), Size(size), Static(isStatic) {}
+			std::string Name;
+			std::string Type;
+			int NumberOfComponents;
+			const char* Data;
+			std::size_t Size;
+			bool Static;	//Unchanged since Init
+		};
+
+		//Data of one dump, owned so that it can be written in the background
+		struct Snapshot
+		{
+			std::string PieceFile;
+			std::string ParentFile;
+			std::vector<std::string> PieceSources;
+			std::vector<std::pair<double, std::string>> Steps;
+			std::map<std::string, int> CellVariables;
+			std::map<std::string, int> PointVariables;
+			std::size_t NumberOfPoints;
+			std::vector<double> Coordinates;
+			std::vector<std::vector<double>> PointValues;
+			std::vector<std::vector<double>> CellValues;
+		};
+
+		std::shared_ptr<Snapshot> TakeSnapshot();
+
+		void CollectArrays(const Snapshot& snapshot, std::vector<AppendedArray>& arrays, std::vector<std::size_t>& sections);
+		std::string MakeHeader(const std::vector<AppendedArray>& arrays, const std::vector<std::size_t>& sections, const std::vector<std::uint64_t>& offsets,
+			std::uint64_t nPoints, std::uint64_t nCells, bool compressed);
+
+		void MakePieceFile(const Snapshot& snapshot);
+		void MakeSharedFile(const Snapshot& snapshot);
+		void MakeParentFile(const Snapshot& snapshot);
+		void MakeCollectionFile(const Snapshot& snapshot);
+
+		void WriteDataArrays(std::ostream& file, const std::vector<AppendedArray>& arrays, std::size_t begin, std::size_t end, const std::vector<std::uint64_t>& offsets);
+		void EncodeArray(const AppendedArray& array, std::vector<char>& encoded);
+
+		template<typename T>
+		void AddCells(const PartMap<T>* parts);
+
+		//Index of a vertex in the written points: its local index if it belongs to the point collection, otherwise
+		//its position after the collection (e.g. vertices of implicit well lines, well heads)
+		std::int32_t AddPoint(Point* vertex);
+		std::int32_t get_PointIndex(const Point* vertex) const;
+
+		template<typename T>
+		void AddVariableNames(const PartMap<T>* parts);
+
+		template<typename T>
+		void FillCellVariable(const PartMap<T>* parts, const std::string& label, int nComponents, std::vector<double>& values);
+
+		template<typename T>
+		void FillPointVariable(const PartMap<T>* parts, const std::string& label, int nComponents, std::vector<double>& values);
+
+		std::string StepFileName(int timeStep);
+		std::string PieceFileName(Types::uint_t partition);
+
+		bool m_compression;
+		bool m_singleFile;
+		int m_nAggregators;
+
+		//Geometry
+		std::vector<Point*> m_extraPoints;
+		std::unordered_map<const Point*, std::int32_t> m_extraPointIndex;
+		std::vector<std::int32_t> m_connectivity;
+		std::vector<std::int64_t> m_offsets;
+		std::vector<std::uint8_t> m_types;
+		std::vector<std::int32_t> m_partIndex;
+
+		//Compressed static arrays, reused at each step
+		std::map<std::string, std::vector<char>> m_encodedStaticArrays;
+
+		//Variables, label and number of components
+		std::map<std::string, int> m_cellVariables;
+		std::map<std::string, int> m_pointVariables;
+
+	};
+
+	template <typename T>
+	void VTUWriter::AddCells(const PartMap<T>* parts)
+	{
+		for (auto it = parts->begin(); it != parts->end(); ++it)
+		{
+			auto partptr = it->second;
+			for (auto it2 = partptr->Collection->begin_owned(); it2 != partptr->Collection->end_owned(); ++it2)
+			{
+				for (auto vertex : (*it2)->get_vertexList())
+				{
+					m_connectivity.push_back(AddPoint(vertex));
+				}
+				m_offsets.push_back(m_connectivity.size());
+				m_types.push_back(static_cast<std::uint8_t>((*it2)->get_vtkType()));
+				m_partIndex.push_back(partptr->Index);
+			}
+		}
+	}
+
+	template <typename T>
+	void VTUWriter::AddVariableNames(const PartMap<T>* parts)
+	{
+		for (auto it = parts->begin(); it != parts->end(); ++it)
+		{
+			auto partptr = it->second;
+			for (auto variable : partptr->PerElementVariable)
+			{
+				m_cellVariables[variable->Label] = static_cast<int>(variable->offset);
+			}
+			for (auto variable : partptr->PerNodeVariable)
+			{
+				m_pointVariables[variable->Label] = static_cast<int>(variable->offset);
+			}
+		}
+	}
+
+	template <typename T>
+	void VTUWriter::FillCellVariable(const PartMap<T>* parts, const std::string& label, int nComponents, std::vector<double>& values)
+	{
+		for (auto it = parts->begin(); it != parts->end(); ++it)
+		{
+			auto partptr = it->second;
+			const std::size_t nValues = partptr->Collection->size_owned()*nComponents;
+
+			VariableDouble* variable = nullptr;
+			for (auto var : partptr->PerElementVariable)
+			{
+				if (var->Label == label)
+				{
+					variable = var;
+				}
+			}
+
+			if ((variable != nullptr) && (static_cast<int>(variable->offset) == nComponents))
+			{
+				const auto& data = variable->get_data();
+				values.insert(values.end(), data.begin(), data.begin() + nValues);
+			}
+			else
+			{
+				values.insert(values.end(), nValues, std::numeric_limits<double>::quiet_NaN());
+			}
+		}
+	}
+
+	template <typename T>
+	void VTUWriter::FillPointVariable(const PartMap<T>* parts, const std::string& label, int nComponents, std::vector<double>& values)
+	{
+		for (auto it = parts->begin(); it != parts->end(); ++it)
+		{
+			auto partptr = it->second;
+			for (auto variable : partptr->PerNodeVariable)
+			{
+				if ((variable->Label != label) || (static_cast<int>(variable->offset) != nComponents))
+				{
+					continue;
+				}
+				const auto& data = variable->get_data();
+				for (std::size_t i = 0; i != partptr->Points.size(); ++i)
+				{
+					const auto index = get_PointIndex(partptr->Points[i])*nComponents;
+					std::copy(data.begin() + i*nComponents, data.begin() + (i + 1)*nComponents, values.begin() + index);
+				}
+			}
+		}
+	}
+
+}
@@ -48,7 +48,7 @@ namespace PAMELA
 	template<class T>
 	struct Variable
 	{
-		Variable(VARIABLE_DIMENSION dim, VARIABLE_TYPE type, std::string label, size_t size) : Label(label), Dimension(dim), Type(type)
+		Variable(VARIABLE_DIMENSION dim, VARIABLE_TYPE type, std::string label, size_t size) : Label(label), Dimension(dim), Type(type), Modified(true)
 		{
 			offset = VariableDimensionToSize.at(static_cast<int>(dim));
 			Data = std::vector<T>(size*offset);
@@ -59,20 +59,27 @@ namespace PAMELA
 		VARIABLE_DIMENSION Dimension;
 		VARIABLE_TYPE Type;
 
+		//Set since the last time step was written
+		bool Modified;
+
 		size_t size() { return Data.size(); }
 
 		void set_data(T cst)
 		{
 			std::fill(Data.begin(), Data.end(), cst);
+			Modified = true;
 		}
 
 		void set_data(typename std::vector<T>::iterator it_begin_vec, typename std::vector<T>::iterator it_end_vec)
 		{
 			ASSERT(static_cast<size_t>(it_end_vec - it_begin_vec) == Data.size(), "Mismatch sizes");
 			Data.assign(it_begin_vec, it_end_vec);
+			Modified = true;
 		}
 
 
+		const std::vector<T>& get_data() const { return Data; }
+
 		std::vector<T> get_data(int i)
 		{
 			if (offset == 1)
@@ -17,6 +17,7 @@
 // Project includes
 #include <Utils/Assert.hpp>
 #include <Utils/Utils.hpp>
+#include <Utils/Statistics.hpp>
 
 namespace PAMELA
 {
@@ -30,6 +31,7 @@ namespace PAMELA
 	}
 	void Communicator::finalize()
 	{
+		Statistics::PrintFromEnvironment();
 #ifdef WITH_MPI
 		MPI_Finalize();
 #endif
@@ -133,11 +133,11 @@ namespace PAMELA
 
 
     //Shrink
-    virtual void Shrink(std::set<int> owned, std::set<int> ghost, int dimension = 1)
+    virtual void Shrink(const std::set<int>& owned, const std::set<int>& ghost, int dimension = 1)
     {
       //Copy ghost elements amd owned elements in temporary vector
       std::vector<T> ghost_vec_temp; ghost_vec_temp.reserve(ghost.size() * dimension);
-      std::vector<T> owned_vec_temp; ghost_vec_temp.reserve(owned.size() * dimension);
+      std::vector<T> owned_vec_temp; owned_vec_temp.reserve(owned.size() * dimension);
       for (auto it = m_data.begin(); it != m_data.end(); ++it)
       {
         if (ghost.count(static_cast<int>((it - m_data.begin())/ dimension)) == 1)
@@ -148,18 +148,14 @@ namespace PAMELA
         {
           owned_vec_temp.push_back(*it);
         }
-        else
-        {
-          //delete *it;  //TODO, need to delete dynamics objects but delete multiple time now. Smart pointer?
-          //*it = nullptr;
-        }
       }
 
-      //Rebuilt data
-      m_data.clear();
-      m_data.reserve(ghost_vec_temp.size() * dimension + owned_vec_temp.size() * dimension);
-      m_data.insert(m_data.end(), owned_vec_temp.begin(), owned_vec_temp.end());
-      m_data.insert(m_data.end(), ghost_vec_temp.begin(), ghost_vec_temp.end());
+      //Rebuilt data, releasing the storage of the global ensemble
+      std::vector<T> data;
+      data.reserve(ghost_vec_temp.size() + owned_vec_temp.size());
+      data.insert(data.end(), owned_vec_temp.begin(), owned_vec_temp.end());
+      data.insert(data.end(), ghost_vec_temp.begin(), ghost_vec_temp.end());
+      m_data.swap(data);
       resize_owned(static_cast<int>(owned_vec_temp.size() ));
       resize_ghost(static_cast<int>(ghost_vec_temp.size() ));
 
@@ -168,6 +164,9 @@ namespace PAMELA
 
     }
 
+    //Memory
+    virtual std::size_t get_MemoryFootprint() const { return sizeof(*this) + m_data.capacity() * sizeof(T); }
+
     //Data
     std::vector<T>& data_all() { return m_data; }
 
@@ -68,7 +68,7 @@ namespace PAMELA
 
                 VARIABLE_DIMENSION GetProperty_dimension(const std::string& label) { return m_dimension.at(label); }
 
-		void ClearAfterPartitioning(std::set<int> owned, std::set<int> ghost)
+		void ClearAfterPartitioning(const std::set<int>& owned, const std::set<int>& ghost)
 		{
 
 			for (auto it = m_data.begin(); it != m_data.end(); ++it)
@@ -77,6 +77,16 @@ namespace PAMELA
 			}
 		}
 
+		std::size_t get_MemoryFootprint() const
+		{
+			std::size_t size = 0;
+			for (auto it = m_data.begin(); it != m_data.end(); ++it)
+			{
+				size += it->second.get_MemoryFootprint();
+			}
+			return size;
+		}
+
 
 	protected:
 
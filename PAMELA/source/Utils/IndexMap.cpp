@@ -0,0 +1,133 @@
+/*
+ * ------------------------------------------------------------------------------------------------------------
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ * Copyright (c) 2018-2020 Lawrence Livermore National Security LLC
+ * Copyright (c) 2018-2020 The Board of Trustees of the Leland Stanford Junior University
+ * Copyright (c) 2018-2020 Total, S.A
+ * Copyright (c) 2020-     GEOSX Contributors
+ * All right reserved
+ *
+ * See top level LICENSE, COPYRIGHT, CONTRIBUTORS, NOTICE, and ACKNOWLEDGEMENTS files for details.
+ * ------------------------------------------------------------------------------------------------------------
+ */
+
+#include "Utils/IndexMap.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace PAMELA
+{
+
+	void IndexMap::Build(std::vector<std::pair<int, int>> pairs, DUPLICATES duplicates)
+	{
+		clear();
+		if (pairs.empty())
+		{
+			return;
+		}
+
+		auto minmax = std::minmax_element(pairs.begin(), pairs.end(),
+			[](const std::pair<int, int>& a, const std::pair<int, int>& b) { return a.first < b.first; });
+		m_MinKey = minmax.first->first;
+		auto range = static_cast<long long>(minmax.second->first) - m_MinKey + 1;
+		m_IsDense = range <= static_cast<long long>(DENSITY_FACTOR) * static_cast<long long>(pairs.size());
+
+		if (m_IsDense)
+		{
+			m_Values.assign(static_cast<std::size_t>(range), -1);
+			for (auto it = pairs.begin(); it != pairs.end(); ++it)
+			{
+				auto& value = m_Values[it->first - m_MinKey];
+				if (value == -1)
+				{
+					value = it->second;
+					m_Size++;
+				}
+				else if (duplicates == DUPLICATES::KEEP_LAST)
+				{
+					value = it->second;
+				}
+			}
+		}
+		else
+		{
+			//Power of two capacity, at most half full
+			std::size_t capacity = 2;
+			m_Shift = 31;
+			while (capacity < 2 * pairs.size())
+			{
+				capacity *= 2;
+				m_Shift--;
+			}
+			m_Table.assign(capacity, std::make_pair(0, -1));
+			auto mask = capacity - 1;
+			for (auto it = pairs.begin(); it != pairs.end(); ++it)
+			{
+				auto slot = Slot(it->first);
+				while (m_Table[slot].second != -1 && m_Table[slot].first != it->first)
+				{
+					slot = (slot + 1) & mask;
+				}
+				if (m_Table[slot].second == -1)
+				{
+					m_Table[slot] = *it;
+					m_Size++;
+				}
+				else if (duplicates == DUPLICATES::KEEP_LAST)
+				{
+					m_Table[slot].second = it->second;
+				}
+			}
+		}
+	}
+
+	void IndexMap::Build(const std::vector<int>& keys, DUPLICATES duplicates)
+	{
+		std::vector<std::pair<int, int>> pairs(keys.size());
+		for (std::size_t i = 0; i != keys.size(); ++i)
+		{
+			pairs[i] = std::make_pair(keys[i], static_cast<int>(i));
+		}
+		Build(std::move(pairs), duplicates);
+	}
+
+	int IndexMap::at(int key) const
+	{
+		auto value = find(key);
+		if (value < 0)
+		{
+			throw std::out_of_range("IndexMap: key " + std::to_string(key) + " not found");
+		}
+		return value;
+	}
+
+	void IndexMap::clear()
+	{
+		m_IsDense = true;
+		m_MinKey = 0;
+		m_Size = 0;
+		std::vector<int>().swap(m_Values);
+		std::vector<std::pair<int, int>>().swap(m_Table);
+		m_Shift = 32;
+	}
+
+	int IndexMap::findHashed(int key) const
+	{
+		if (m_Table.empty())
+		{
+			return -1;
+		}
+		auto mask = m_Table.size() - 1;
+		for (auto slot = Slot(key); m_Table[slot].second != -1; slot = (slot + 1) & mask)
+		{
+			if (m_Table[slot].first == key)
+			{
+				return m_Table[slot].second;
+			}
+		}
+		return -1;
+	}
+
+}
@@ -0,0 +1,80 @@
+/*
+ * ------------------------------------------------------------------------------------------------------------
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ * Copyright (c) 2018-2020 Lawrence Livermore National Security LLC
+ * Copyright (c) 2018-2020 The Board of Trustees of the Leland Stanford Junior University
+ * Copyright (c) 2018-2020 Total, S.A
+ * Copyright (c) 2020-     GEOSX Contributors
+ * All right reserved
+ *
+ * See top level LICENSE, COPYRIGHT, CONTRIBUTORS, NOTICE, and ACKNOWLEDGEMENTS files for details.
+ * ------------------------------------------------------------------------------------------------------------
+ */
+
+#pragma once
+#include <vector>
+#include <utility>
+#include <cstddef>
+
+namespace PAMELA
+{
+
+	/**
+	* \brief Read-only map from integer keys (global indices) to integer values (local indices).
+	* Stored as a dense array when the key range is compact, as an open addressing hash table otherwise.
+	*/
+	class IndexMap
+	{
+
+	public:
+
+		//Value kept for a key given several times
+		enum class DUPLICATES { KEEP_FIRST, KEEP_LAST };
+
+		IndexMap() = default;
+
+		//Build from (key, value) pairs
+		void Build(std::vector<std::pair<int, int>> pairs, DUPLICATES duplicates = DUPLICATES::KEEP_FIRST);
+
+		//Build mapping keys[i] -> i
+		void Build(const std::vector<int>& keys, DUPLICATES duplicates = DUPLICATES::KEEP_FIRST);
+
+		int find(int key) const   //-1 if key is absent
+		{
+			if (m_IsDense)
+			{
+				auto offset = static_cast<std::size_t>(static_cast<unsigned int>(key) - static_cast<unsigned int>(m_MinKey));
+				return offset < m_Values.size() ? m_Values[offset] : -1;
+			}
+			return findHashed(key);
+		}
+
+		int at(int key) const;   //throws std::out_of_range if key is absent
+		std::size_t count(int key) const { return find(key) >= 0 ? 1 : 0; }
+
+		std::size_t size() const { return m_Size; }
+		bool empty() const { return m_Size == 0; }
+		bool IsDense() const { return m_IsDense; }
+		std::size_t get_MemoryFootprint() const { return sizeof(IndexMap) + m_Values.capacity() * sizeof(int) + m_Table.capacity() * sizeof(std::pair<int, int>); }
+
+		void clear();
+
+	private:
+
+		int findHashed(int key) const;
+		std::size_t Slot(int key) const { return (static_cast<unsigned int>(key) * 2654435761u) >> m_Shift; }
+
+		//Dense storage is used while the key range is at most DENSITY_FACTOR times the number of keys
+		static const int DENSITY_FACTOR = 4;
+
+		bool m_IsDense {true};
+		int m_MinKey {0};
+		std::size_t m_Size {0};
+		std::vector<int> m_Values {};                //Values indexed by key - m_MinKey, -1 for absent keys (dense storage)
+		std::vector<std::pair<int, int>> m_Table {}; //Linear probing table of (key, value), value -1 for empty slots (sparse storage)
+		unsigned int m_Shift {32};
+
+	};
+
+}
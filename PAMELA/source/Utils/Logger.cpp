@@ -29,7 +29,8 @@ namespace PAMELA
     return &s_instance;
   }
 
-  Logger::Logger(std::string LevelLogFile, std::string file_name, std::string LevelScreen)
+  Logger::Logger(std::string LevelLogFile, std::string file_name, std::string LevelScreen) :
+    m_flush_size(1 << 16), m_screen_rank0_only(false), m_rank(-1), m_time(0)
   {
 
     //Log file
@@ -51,44 +52,124 @@ namespace PAMELA
       m_screen_level = VerbosityLevelScreen::BRIEF;
     if (LevelScreen == "ALL")
       m_screen_level = VerbosityLevelScreen::ALL;
+
+    UpdateEnabled();
   }
 
+  Logger::~Logger()
+  {
+    Flush();
+  }
 
-  void Logger::LogERROR(std::string msg)
+  void Logger::UpdateEnabled()
+  {
+    const VerbosityLevelLogFile levels[] = { VerbosityLevelLogFile::ERROR, VerbosityLevelLogFile::WARNING, VerbosityLevelLogFile::DEBUG, VerbosityLevelLogFile::INFO };
+    for (auto level : levels)
+    {
+      auto i = static_cast<int>(level);
+      m_file_enabled[i] = (level == VerbosityLevelLogFile::ERROR) || (m_log_level >= level);
+      m_screen_enabled[i] = m_screen_level >= (level == VerbosityLevelLogFile::DEBUG ? VerbosityLevelScreen::ALL : VerbosityLevelScreen::BRIEF);
+      if (m_screen_rank0_only && (get_rank() != 0) && ((level == VerbosityLevelLogFile::INFO) || (level == VerbosityLevelLogFile::DEBUG)))
+      {
+        m_screen_enabled[i] = false;
+      }
+      m_enabled[i] = m_file_enabled[i] || m_screen_enabled[i];
+    }
+  }
+
+  void Logger::set_FlushSize(std::size_t flushSize)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_flush_size = flushSize;
+    if (m_screen_buffer.size() + m_file_buffer.size() > m_flush_size)
+    {
+      FlushUnlocked();
+    }
+  }
+
+  void Logger::set_ScreenRank0Only(bool rank0Only)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_screen_rank0_only = rank0Only;
+    UpdateEnabled();
+  }
+
+  void Logger::Write(VerbosityLevelLogFile level, const char* file_prefix, const std::string& msg)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto i = static_cast<int>(level);
+    if (m_file_enabled[i])
+    {
+      m_file_buffer += "[";
+      m_file_buffer += get_time();
+      m_file_buffer += "] ";
+      m_file_buffer += file_prefix;
+      m_file_buffer += msg;
+      m_file_buffer += '\n';
+    }
+    if (m_screen_enabled[i])
+    {
+#ifdef WITH_MPI
+      m_screen_buffer += std::to_string(get_rank()) + " >>> ";
+#endif
+      if (level == VerbosityLevelLogFile::ERROR)
+      {
+        m_screen_buffer += "ERROR:   ";
+      }
+      else if (level == VerbosityLevelLogFile::WARNING)
+      {
+        m_screen_buffer += "WARNING: ";
+      }
+      m_screen_buffer += msg;
+      m_screen_buffer += '\n';
+    }
+    if ((level == VerbosityLevelLogFile::ERROR) || (level == VerbosityLevelLogFile::WARNING) || (m_screen_buffer.size() + m_file_buffer.size() > m_flush_size))
+    {
+      FlushUnlocked();
+    }
+  }
+
+  void Logger::Flush()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    FlushUnlocked();
+  }
+
+  void Logger::FlushUnlocked()
   {
+    if (!m_file_buffer.empty())
+    {
+      m_logfile.write(m_file_buffer.data(), static_cast<std::streamsize>(m_file_buffer.size()));
+      m_logfile.flush();
+      m_file_buffer.clear();
+    }
+    if (!m_screen_buffer.empty())
+    {
+      std::cout.write(m_screen_buffer.data(), static_cast<std::streamsize>(m_screen_buffer.size()));
+      std::cout.flush();
+      m_screen_buffer.clear();
+    }
+  }
 
-    std::string message = "[" + get_time() + "] ERROR:   " + msg.c_str();
-    write_file(message);
-    if (m_screen_level >= VerbosityLevelScreen::BRIEF)
-      write_screen("ERROR:   " + msg + " in file " + __FILE__ + " line " + std::to_string(__LINE__));
-                abort();
+  void Logger::LogERROR(std::string msg)
+  {
+    Write(VerbosityLevelLogFile::ERROR, "ERROR:   ", msg + " in file " + __FILE__ + " line " + std::to_string(__LINE__));
+    abort();
   }
 
   void Logger::LogWARNING(std::string msg)
   {
-    std::string message = "[" + get_time() + "] WARNING: " + msg.c_str();
-    if (m_log_level >= VerbosityLevelLogFile::WARNING)
-      write_file(message);
-    if (m_screen_level >= VerbosityLevelScreen::BRIEF)
-      write_screen("WARNING: " + msg);
+    Write(VerbosityLevelLogFile::WARNING, "WARNING: ", msg);
   }
 
   void Logger::LogINFO(std::string msg)
   {
-    std::string message = "[" + get_time() + "] INFO:    " + msg.c_str();
-    if (m_log_level >= VerbosityLevelLogFile::INFO)
-      write_file(message);
-    if (m_screen_level >= VerbosityLevelScreen::BRIEF)
-      write_screen(msg);
+    Write(VerbosityLevelLogFile::INFO, "INFO:    ", msg);
   }
 
   void Logger::LogDEBUG(std::string msg)
   {
-    std::string message = "[" + get_time() + "] DEBUG:   " + msg.c_str();
-    if (m_log_level >= VerbosityLevelLogFile::DEBUG)
-      write_file(message);
-    if (m_screen_level >= VerbosityLevelScreen::ALL)
-      write_screen(msg);
+    Write(VerbosityLevelLogFile::DEBUG, "DEBUG:   ", msg);
   }
 
 
@@ -114,12 +195,35 @@ namespace PAMELA
     }
   }
 
+  int Logger::get_rank()
+  {
+#ifdef WITH_MPI
+    if (m_rank < 0)
+    {
+      int initialized = 0;
+      MPI_Initialized(&initialized);
+      if (!initialized)
+      {
+        return 0;
+      }
+      m_rank = static_cast<int>(Communicator::worldRank());
+    }
+    return m_rank;
+#else
+    return 0;
+#endif
+  }
 
-
-  std::string Logger::get_time()
+  //Formatted once per second
+  const std::string& Logger::get_time()
   {
-    std::stringstream res;
     time_t t = time(nullptr);
+    if ((t == m_time) && !m_time_string.empty())
+    {
+      return m_time_string;
+    }
+    m_time = t;
+    std::stringstream res;
     struct tm *now;
 #ifdef WIN32
     struct tm now_st;
@@ -130,7 +234,8 @@ namespace PAMELA
 #endif
     // res << std::put_time(now, "%Y-%m-%d %H:%M:%S");
     res << (now->tm_year + 1900) << "-" << (now->tm_mon + 1) << "-" << (now->tm_mday) << "-" << now->tm_hour << ":" << now->tm_min << ":" << now->tm_sec;
-    return res.str();
+    m_time_string = res.str();
+    return m_time_string;
   }
 
 }
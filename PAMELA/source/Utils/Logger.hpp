@@ -21,14 +21,22 @@
 // Std library includes
 #include <fstream>
 #include <chrono>
+#include <ctime>
 #include <iostream>
 #include <iomanip>
+#include <mutex>
+
+//Most detailed level compiled in: 0 ERROR, 1 WARNING, 2 INFO, 3 DEBUG
+#ifndef PAMELA_LOG_LEVEL
+#define PAMELA_LOG_LEVEL 3
+#endif
 
 ////Macros
-#define LOGWARNING(msg) do {Logger::instance()->LogWARNING(msg);} while (0)
+//The message is only evaluated if its level is compiled in and enabled
+#define LOGWARNING(msg) do { if ((PAMELA_LOG_LEVEL >= 1) && Logger::instance()->IsEnabled(VerbosityLevelLogFile::WARNING)) Logger::instance()->LogWARNING(msg); } while (0)
 #define LOGERROR(msg) do {Logger::instance()->LogERROR(msg);} while (0)
-#define LOGINFO(msg) do {Logger::instance()->LogINFO(msg);} while (0)
-#define LOGDEBUG(msg) do {Logger::instance()->LogDEBUG(msg);} while (0)
+#define LOGINFO(msg) do { if ((PAMELA_LOG_LEVEL >= 2) && Logger::instance()->IsEnabled(VerbosityLevelLogFile::INFO)) Logger::instance()->LogINFO(msg); } while (0)
+#define LOGDEBUG(msg) do { if ((PAMELA_LOG_LEVEL >= 3) && Logger::instance()->IsEnabled(VerbosityLevelLogFile::DEBUG)) Logger::instance()->LogDEBUG(msg); } while (0)
 
 //ADGPRS Native style
 #define LogFatal(msg) do {Logger::instance()->Log((*(LogMessage::instance(VerbosityLevelLogFile::ERROR))<<msg));} while (0)
@@ -70,6 +78,8 @@ namespace PAMELA
 		static Logger* instance();
 		static void init(std::string LevelLogFile, std::string file_name, std::string LevelScreen);
 
+		~Logger();
+
 		[[ noreturn ]] void LogERROR(std::string msg) __attribute__((noreturn));
 		void LogWARNING(std::string msg);
 		void LogINFO(std::string msg);
@@ -77,6 +87,18 @@ namespace PAMELA
 
 		void Log(LogMessage& msg);
 
+		//Whether a message of this level is written anywhere by this rank
+		bool IsEnabled(VerbosityLevelLogFile level) const { return m_enabled[static_cast<int>(level)]; }
+
+		//Messages are buffered until flushSize bytes are pending, warnings and errors are written at once. 0 writes every message.
+		void set_FlushSize(std::size_t flushSize);
+
+		//Only rank 0 prints information and debug messages on screen, warnings and errors are printed by every rank.
+		//To be called once MPI is initialized.
+		void set_ScreenRank0Only(bool rank0Only);
+
+		void Flush();
+
 	protected:
 		Logger(std::string level_logfile, std::string file_name, std::string level_screen);
 	private:
@@ -87,58 +109,32 @@ namespace PAMELA
 		//Log file
 		VerbosityLevelLogFile m_log_level;
 
-
-
 		std::ofstream m_logfile;
 
-		template<typename T>
-		static void write_screen(T &&t);
+		//Levels enabled on screen, in the log file, and on either of them
+		bool m_screen_enabled[4];
+		bool m_file_enabled[4];
+		bool m_enabled[4];
+		void UpdateEnabled();
 
-		template<typename Head, typename Tail, typename... Tails>
-		static void write_screen(Head &&head, Tail &&tail, Tails&&... tails);
+		//Pending output
+		std::string m_screen_buffer;
+		std::string m_file_buffer;
+		std::size_t m_flush_size;
+		bool m_screen_rank0_only;
+		std::mutex m_mutex;
 
-		template<typename T>
-		void write_file(T &&t);
+		void Write(VerbosityLevelLogFile level, const char* file_prefix, const std::string& msg);
+		void FlushUnlocked();
 
-		template<typename Head, typename Tail, typename... Tails>
-		void write_file(Head &&head, Tail &&tail, Tails&&... tails);
+		//-1 until MPI is initialized
+		int m_rank;
+		int get_rank();
 
-		static std::string get_time();
+		std::time_t m_time;
+		std::string m_time_string;
+		const std::string& get_time();
 
 	};
 
-
-	template<typename T>
-	void Logger::write_screen(T &&t)
-	{
-          std::string MPI_prefix;
-#ifdef WITH_MPI
-          MPI_prefix = std::to_string(Communicator::worldRank()) + " >>> ";
-#else
-          MPI_prefix = "";
-#endif
-          std::cout << MPI_prefix;
-          std::cout << t << std::endl;
-	}
-
-	template<typename Head, typename Tail, typename... Tails>
-	void Logger::write_screen(Head &&head, Tail &&tail, Tails&&... tails)
-	{
-		std::cout << head;
-		write_screen(std::forward<Tail>(tail), std::forward<Tails>(tails)...);
-	}
-
-	template<typename T>
-	void Logger::write_file(T &&t)
-	{
-		m_logfile << t << std::endl;
-	}
-
-	template<typename Head, typename Tail, typename... Tails>
-	void Logger::write_file(Head &&head, Tail &&tail, Tails&&... tails)
-	{
-		m_logfile << head;
-		write_file(std::forward<Tail>(tail), std::forward<Tails>(tails)...);
-	}
-
 }
@@ -0,0 +1,61 @@
+/*
+ * ------------------------------------------------------------------------------------------------------------
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ * Copyright (c) 2018-2020 Lawrence Livermore National Security LLC
+ * Copyright (c) 2018-2020 The Board of Trustees of the Leland Stanford Junior University
+ * Copyright (c) 2018-2020 Total, S.A
+ * Copyright (c) 2020-     GEOSX Contributors
+ * All right reserved
+ *
+ * See top level LICENSE, COPYRIGHT, CONTRIBUTORS, NOTICE, and ACKNOWLEDGEMENTS files for details.
+ * ------------------------------------------------------------------------------------------------------------
+ */
+
+#pragma once
+
+// Std library includes
+#include <cstddef>
+#include <vector>
+
+namespace PAMELA
+{
+
+	/**
+	* \brief Non-owning view of a contiguous array, valid as long as the storage it refers to
+	*/
+	template <typename T>
+	class Span
+	{
+	public:
+
+		using value_type = T;
+		using iterator = T*;
+
+		Span() : m_data(nullptr), m_size(0) {}
+		Span(T* data, std::size_t size) : m_data(data), m_size(size) {}
+
+		template <typename U>
+		Span(std::vector<U>& vector) : m_data(vector.data()), m_size(vector.size()) {}
+
+		template <typename U>
+		Span(const std::vector<U>& vector) : m_data(vector.data()), m_size(vector.size()) {}
+
+		T* data() const { return m_data; }
+		std::size_t size() const { return m_size; }
+		std::size_t size_bytes() const { return m_size * sizeof(T); }
+		bool empty() const { return m_size == 0; }
+
+		T& operator[](std::size_t i) const { return m_data[i]; }
+
+		iterator begin() const { return m_data; }
+		iterator end() const { return m_data + m_size; }
+
+	private:
+
+		T* m_data;
+		std::size_t m_size;
+
+	};
+
+}
@@ -12,3 +12,636 @@
  * ------------------------------------------------------------------------------------------------------------
  */
 
+#include "Utils/Statistics.hpp"
+#include "Utils/Logger.hpp"
+#include "Parallel/Communicator.hpp"
+
+// Std library includes
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+#ifdef PAMELA_COUNT_ALLOCATIONS
+namespace
+{
+	std::atomic<std::uint64_t> g_allocationCount(0);
+	std::atomic<std::uint64_t> g_allocatedBytes(0);
+
+	void* CountedAllocation(std::size_t size)
+	{
+		g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+		g_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+		return std::malloc(size == 0 ? 1 : size);
+	}
+}
+
+void* operator new(std::size_t size)
+{
+	void* p = CountedAllocation(size);
+	if (p == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+void* operator new[](std::size_t size)
+{
+	return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	return CountedAllocation(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+	return CountedAllocation(size);
+}
+
+void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+	std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept
+{
+	std::free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept
+{
+	std::free(p);
+}
+#endif
+
+namespace PAMELA
+{
+
+	namespace
+	{
+		using Clock = std::chrono::steady_clock;
+
+		struct Region
+		{
+			std::string Name;
+			std::vector<std::unique_ptr<Region>> Children;
+			std::uint64_t Calls = 0;
+			double Time = 0;
+			std::size_t PeakRSS = 0;
+			std::size_t RSSGrowth = 0;
+			std::uint64_t Allocations = 0;
+			std::uint64_t AllocatedBytes = 0;
+		};
+
+		struct OpenRegion
+		{
+			Region* region;
+			std::size_t PeakRSS;
+			std::uint64_t Allocations;
+			std::uint64_t AllocatedBytes;
+			Clock::time_point Start;
+		};
+
+		struct Registry
+		{
+			std::mutex Mutex;
+			Region Root;
+		};
+
+		Registry& registry()
+		{
+			static Registry s_registry;
+			return s_registry;
+		}
+
+		thread_local std::vector<OpenRegion> t_openRegions;
+
+		const char PATH_SEPARATOR = '/';
+		const double MB = 1024.0 * 1024.0;
+
+		void Reset(Region& region)
+		{
+			region.Calls = 0;
+			region.Time = 0;
+			region.PeakRSS = 0;
+			region.RSSGrowth = 0;
+			region.Allocations = 0;
+			region.AllocatedBytes = 0;
+			for (auto& child : region.Children)
+			{
+				Reset(*child);
+			}
+		}
+
+		//Depth first, children in order of first call
+		void Flatten(const Region& region, const std::string& prefix, std::vector<std::string>& paths, std::map<std::string, Region>& regions)
+		{
+			for (auto& child : region.Children)
+			{
+				std::string path = prefix.empty() ? child->Name : prefix + PATH_SEPARATOR + child->Name;
+				paths.push_back(path);
+				auto& copy = regions[path];
+				copy.Calls = child->Calls;
+				copy.Time = child->Time;
+				copy.PeakRSS = child->PeakRSS;
+				copy.RSSGrowth = child->RSSGrowth;
+				copy.Allocations = child->Allocations;
+				copy.AllocatedBytes = child->AllocatedBytes;
+				Flatten(*child, path, paths, regions);
+			}
+		}
+
+#ifdef WITH_MPI
+		//Regions entered by at least one rank, in the order of the region tree of rank 0 then of the others
+		struct PathTree
+		{
+			std::vector<std::pair<std::string, std::unique_ptr<PathTree>>> Children;
+
+			void Insert(const std::string& path)
+			{
+				PathTree* node = this;
+				std::size_t begin = 0;
+				while (begin <= path.size())
+				{
+					auto end = std::min(path.find(PATH_SEPARATOR, begin), path.size());
+					auto name = path.substr(begin, end - begin);
+					auto it = std::find_if(node->Children.begin(), node->Children.end(),
+						[&name](const std::pair<std::string, std::unique_ptr<PathTree>>& child) { return child.first == name; });
+					if (it == node->Children.end())
+					{
+						node->Children.emplace_back(name, std::unique_ptr<PathTree>(new PathTree()));
+						it = node->Children.end() - 1;
+					}
+					node = it->second.get();
+					begin = end + 1;
+				}
+			}
+
+			void Flatten(const std::string& prefix, std::vector<std::string>& paths) const
+			{
+				for (auto& child : Children)
+				{
+					std::string path = prefix.empty() ? child.first : prefix + PATH_SEPARATOR + child.first;
+					paths.push_back(path);
+					child.second->Flatten(path, paths);
+				}
+			}
+		};
+
+		std::vector<std::string> MergePaths(const std::vector<std::string>& paths, int rank, int nRank)
+		{
+			std::string local;
+			for (auto& path : paths)
+			{
+				local += path + '\n';
+			}
+
+			int length = static_cast<int>(local.size());
+			std::vector<int> lengths(nRank);
+			MPI_Gather(&length, 1, MPI_INT, lengths.data(), 1, MPI_INT, 0, MPI_COMM_WORLD);
+			std::vector<int> displs(nRank + 1, 0);
+			for (int r = 0; r != nRank; ++r)
+			{
+				displs[r + 1] = displs[r] + lengths[r];
+			}
+			std::string all(rank == 0 ? displs[nRank] : 0, '\0');
+			MPI_Gatherv(&local[0], length, MPI_CHAR, &all[0], lengths.data(), displs.data(), MPI_CHAR, 0, MPI_COMM_WORLD);
+
+			std::string merged;
+			if (rank == 0)
+			{
+				PathTree tree;
+				std::istringstream lines(all);
+				std::string path;
+				while (std::getline(lines, path))
+				{
+					tree.Insert(path);
+				}
+				std::vector<std::string> mergedPaths;
+				tree.Flatten("", mergedPaths);
+				for (auto& mergedPath : mergedPaths)
+				{
+					merged += mergedPath + '\n';
+				}
+			}
+
+			length = static_cast<int>(merged.size());
+			MPI_Bcast(&length, 1, MPI_INT, 0, MPI_COMM_WORLD);
+			merged.resize(length);
+			MPI_Bcast(&merged[0], length, MPI_CHAR, 0, MPI_COMM_WORLD);
+
+			std::vector<std::string> mergedPaths;
+			std::istringstream lines(merged);
+			std::string path;
+			while (std::getline(lines, path))
+			{
+				mergedPaths.push_back(path);
+			}
+			return mergedPaths;
+		}
+#endif
+
+		//Region reduced over the ranks which entered it
+		struct ReducedRegion
+		{
+			std::string Path;
+			std::string Name;
+			int Depth;
+			int nRank;
+			std::uint64_t Calls;
+			double TimeMin;
+			double TimeAvg;
+			double TimeMax;
+			int TimeMaxRank;
+			double PeakRSS;
+			int PeakRSSRank;
+			double RSSGrowth;
+			double AllocationsAvg;
+			double AllocationsMax;
+			double AllocatedBytesAvg;
+		};
+
+		std::vector<ReducedRegion> Reduce(int rank, int nRank)
+		{
+			std::vector<std::string> paths;
+			std::map<std::string, Region> regions;
+			{
+				auto& reg = registry();
+				std::lock_guard<std::mutex> lock(reg.Mutex);
+				Flatten(reg.Root, "", paths, regions);
+			}
+#ifdef WITH_MPI
+			paths = MergePaths(paths, rank, nRank);
+#endif
+			auto nPath = paths.size();
+
+			//Regions not entered by a rank do not contribute to the min and max
+			std::vector<double> minimum(nPath, std::numeric_limits<double>::max());
+			std::vector<double> sum(4 * nPath, 0.0);
+			std::vector<double> maximum(3 * nPath, 0.0);
+			std::vector<double> maxlocValue(2 * nPath, -1.0);
+			std::vector<int> maxlocRank(2 * nPath, rank);
+			for (std::size_t i = 0; i != nPath; ++i)
+			{
+				auto it = regions.find(paths[i]);
+				if (it == regions.end())
+				{
+					continue;
+				}
+				auto& region = it->second;
+				minimum[i] = region.Time;
+				sum[4 * i] = region.Time;
+				sum[4 * i + 1] = static_cast<double>(region.Allocations);
+				sum[4 * i + 2] = static_cast<double>(region.AllocatedBytes);
+				sum[4 * i + 3] = 1;
+				maximum[3 * i] = static_cast<double>(region.Calls);
+				maximum[3 * i + 1] = static_cast<double>(region.RSSGrowth);
+				maximum[3 * i + 2] = static_cast<double>(region.Allocations);
+				maxlocValue[2 * i] = region.Time;
+				maxlocValue[2 * i + 1] = static_cast<double>(region.PeakRSS);
+			}
+
+#ifdef WITH_MPI
+			struct DoubleInt
+			{
+				double value;
+				int rank;
+			};
+			std::vector<DoubleInt> maxloc(2 * nPath), maxlocReduced(2 * nPath);
+			for (std::size_t i = 0; i != 2 * nPath; ++i)
+			{
+				maxloc[i].value = maxlocValue[i];
+				maxloc[i].rank = rank;
+			}
+			auto count = static_cast<int>(nPath);
+			MPI_Reduce(rank == 0 ? MPI_IN_PLACE : minimum.data(), minimum.data(), count, MPI_DOUBLE, MPI_MIN, 0, MPI_COMM_WORLD);
+			MPI_Reduce(rank == 0 ? MPI_IN_PLACE : sum.data(), sum.data(), 4 * count, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+			MPI_Reduce(rank == 0 ? MPI_IN_PLACE : maximum.data(), maximum.data(), 3 * count, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+			MPI_Reduce(maxloc.data(), maxlocReduced.data(), 2 * count, MPI_DOUBLE_INT, MPI_MAXLOC, 0, MPI_COMM_WORLD);
+			for (std::size_t i = 0; i != 2 * nPath; ++i)
+			{
+				maxlocValue[i] = maxlocReduced[i].value;
+				maxlocRank[i] = maxlocReduced[i].rank;
+			}
+#else
+			(void)nRank;
+#endif
+
+			std::vector<ReducedRegion> reduced;
+			if (rank != 0)
+			{
+				return reduced;
+			}
+			reduced.resize(nPath);
+			for (std::size_t i = 0; i != nPath; ++i)
+			{
+				auto& region = reduced[i];
+				auto separator = paths[i].find_last_of(PATH_SEPARATOR);
+				double nEntered = std::max(1.0, sum[4 * i + 3]);
+				region.Path = paths[i];
+				region.Name = separator == std::string::npos ? paths[i] : paths[i].substr(separator + 1);
+				region.Depth = static_cast<int>(std::count(paths[i].begin(), paths[i].end(), PATH_SEPARATOR));
+				region.nRank = static_cast<int>(sum[4 * i + 3]);
+				region.Calls = static_cast<std::uint64_t>(maximum[3 * i]);
+				region.TimeMin = minimum[i];
+				region.TimeAvg = sum[4 * i] / nEntered;
+				region.TimeMax = maxlocValue[2 * i];
+				region.TimeMaxRank = maxlocRank[2 * i];
+				region.PeakRSS = maxlocValue[2 * i + 1] / MB;
+				region.PeakRSSRank = maxlocRank[2 * i + 1];
+				region.RSSGrowth = maximum[3 * i + 1] / MB;
+				region.AllocationsAvg = sum[4 * i + 1] / nEntered;
+				region.AllocationsMax = maximum[3 * i + 2];
+				region.AllocatedBytesAvg = sum[4 * i + 2] / nEntered / MB;
+			}
+			return reduced;
+		}
+
+		std::string JSONString(const std::string& value)
+		{
+			std::string escaped = "\"";
+			for (auto c : value)
+			{
+				if ((c == '"') || (c == '\\'))
+				{
+					escaped += '\\';
+				}
+				escaped += c;
+			}
+			return escaped + "\"";
+		}
+
+		bool CountsAllocations()
+		{
+#ifdef PAMELA_COUNT_ALLOCATIONS
+			return true;
+#else
+			return false;
+#endif
+		}
+
+		std::string FormatTable(const std::vector<ReducedRegion>& regions, int nRank)
+		{
+			std::size_t nameWidth = 6;
+			for (auto& region : regions)
+			{
+				nameWidth = std::max(nameWidth, 2 * region.Depth + region.Name.size());
+			}
+
+			std::ostringstream table;
+			table << "PAMELA statistics over " << nRank << " rank(s), times in s, memory in MB\n";
+			table << std::left << std::setw(nameWidth) << "Region" << std::right
+				<< std::setw(7) << "Ranks" << std::setw(9) << "Calls"
+				<< std::setw(11) << "Min" << std::setw(11) << "Avg" << std::setw(11) << "Max" << std::setw(9) << "MaxRank"
+				<< std::setw(11) << "PeakRSS" << std::setw(9) << "RSSRank" << std::setw(11) << "RSSGrowth";
+			if (CountsAllocations())
+			{
+				table << std::setw(13) << "AllocsAvg" << std::setw(13) << "AllocsMax" << std::setw(11) << "AllocMBAvg";
+			}
+			table << "\n";
+
+			table << std::fixed;
+			for (auto& region : regions)
+			{
+				table << std::left << std::setw(nameWidth) << (std::string(2 * region.Depth, ' ') + region.Name) << std::right
+					<< std::setw(7) << region.nRank << std::setw(9) << region.Calls << std::setprecision(3)
+					<< std::setw(11) << region.TimeMin << std::setw(11) << region.TimeAvg << std::setw(11) << region.TimeMax
+					<< std::setw(9) << region.TimeMaxRank << std::setprecision(1)
+					<< std::setw(11) << region.PeakRSS << std::setw(9) << region.PeakRSSRank << std::setw(11) << region.RSSGrowth;
+				if (CountsAllocations())
+				{
+					table << std::setprecision(0) << std::setw(13) << region.AllocationsAvg << std::setw(13) << region.AllocationsMax
+						<< std::setprecision(1) << std::setw(11) << region.AllocatedBytesAvg;
+				}
+				table << "\n";
+			}
+			return table.str();
+		}
+
+		std::string FormatJSON(const std::vector<ReducedRegion>& regions, int nRank)
+		{
+			std::ostringstream json;
+			json << std::setprecision(9);
+			json << "{\n  \"ranks\": " << nRank << ",\n  \"allocation_counts\": " << (CountsAllocations() ? "true" : "false") << ",\n  \"regions\": [";
+			for (std::size_t i = 0; i != regions.size(); ++i)
+			{
+				auto& region = regions[i];
+				json << (i == 0 ? "\n" : ",\n") << "    {"
+					<< "\"path\": " << JSONString(region.Path)
+					<< ", \"name\": " << JSONString(region.Name)
+					<< ", \"depth\": " << region.Depth
+					<< ", \"ranks\": " << region.nRank
+					<< ", \"calls\": " << region.Calls
+					<< ", \"time_min\": " << region.TimeMin
+					<< ", \"time_avg\": " << region.TimeAvg
+					<< ", \"time_max\": " << region.TimeMax
+					<< ", \"time_max_rank\": " << region.TimeMaxRank
+					<< ", \"peak_rss_mb\": " << region.PeakRSS
+					<< ", \"peak_rss_rank\": " << region.PeakRSSRank
+					<< ", \"rss_growth_mb\": " << region.RSSGrowth;
+				if (CountsAllocations())
+				{
+					json << ", \"allocations_avg\": " << region.AllocationsAvg
+						<< ", \"allocations_max\": " << region.AllocationsMax
+						<< ", \"allocated_mb_avg\": " << region.AllocatedBytesAvg;
+				}
+				json << "}";
+			}
+			json << "\n  ]\n}\n";
+			return json.str();
+		}
+	}
+
+	void Statistics::BeginRegion(const char* name)
+	{
+		auto& reg = registry();
+		Region* parent = t_openRegions.empty() ? &reg.Root : t_openRegions.back().region;
+		Region* region = nullptr;
+		{
+			std::lock_guard<std::mutex> lock(reg.Mutex);
+			for (auto& child : parent->Children)
+			{
+				if (child->Name == name)
+				{
+					region = child.get();
+					break;
+				}
+			}
+			if (region == nullptr)
+			{
+				parent->Children.emplace_back(new Region());
+				region = parent->Children.back().get();
+				region->Name = name;
+			}
+		}
+
+		OpenRegion open;
+		open.region = region;
+		open.PeakRSS = get_PeakRSS();
+		open.Allocations = get_AllocationCount();
+		open.AllocatedBytes = get_AllocatedBytes();
+		open.Start = Clock::now();
+		t_openRegions.push_back(open);
+	}
+
+	void Statistics::EndRegion()
+	{
+		auto end = Clock::now();
+		if (t_openRegions.empty())
+		{
+			LOGWARNING("Statistics::EndRegion called without open region");
+			return;
+		}
+		auto open = t_openRegions.back();
+		t_openRegions.pop_back();
+		auto peakRSS = get_PeakRSS();
+		auto allocations = get_AllocationCount();
+		auto allocatedBytes = get_AllocatedBytes();
+
+		auto& reg = registry();
+		std::lock_guard<std::mutex> lock(reg.Mutex);
+		auto region = open.region;
+		region->Calls++;
+		region->Time += std::chrono::duration<double>(end - open.Start).count();
+		region->PeakRSS = std::max(region->PeakRSS, peakRSS);
+		region->RSSGrowth += peakRSS - open.PeakRSS;
+		region->Allocations += allocations - open.Allocations;
+		region->AllocatedBytes += allocatedBytes - open.AllocatedBytes;
+	}
+
+	void Statistics::Reset()
+	{
+		auto& reg = registry();
+		std::lock_guard<std::mutex> lock(reg.Mutex);
+		PAMELA::Reset(reg.Root);
+	}
+
+	std::string Statistics::Report(ReportFormat format)
+	{
+		int rank = static_cast<int>(Communicator::worldRank());
+		int nRank = static_cast<int>(Communicator::worldSize());
+		auto regions = Reduce(rank, nRank);
+		if (rank != 0)
+		{
+			return "";
+		}
+		return format == ReportFormat::JSON ? FormatJSON(regions, nRank) : FormatTable(regions, nRank);
+	}
+
+	void Statistics::Print(ReportFormat format, const std::string& file_path)
+	{
+		auto report = Report(format);
+		if (Communicator::worldRank() != 0)
+		{
+			return;
+		}
+		if (file_path.empty())
+		{
+			Logger::instance()->Flush();
+			std::cout << report << std::flush;
+			return;
+		}
+		std::ofstream file(file_path);
+		if (!file)
+		{
+			LOGWARNING("Cannot write statistics to " + file_path);
+			return;
+		}
+		file << report;
+	}
+
+	void Statistics::PrintFromEnvironment()
+	{
+		const char* env = std::getenv("PAMELA_STATISTICS");
+		if (env == nullptr)
+		{
+			return;
+		}
+		std::string value = env;
+		ReportFormat format;
+		if ((value == "table") || (value == "TABLE"))
+		{
+			format = ReportFormat::TABLE;
+		}
+		else if ((value == "json") || (value == "JSON"))
+		{
+			format = ReportFormat::JSON;
+		}
+		else
+		{
+			LOGWARNING("PAMELA_STATISTICS must be table or json");
+			return;
+		}
+		const char* file = std::getenv("PAMELA_STATISTICS_FILE");
+		Print(format, file == nullptr ? "" : file);
+	}
+
+	std::size_t Statistics::get_PeakRSS()
+	{
+#if defined(__unix__) || defined(__APPLE__)
+		struct rusage usage;
+		if (getrusage(RUSAGE_SELF, &usage) != 0)
+		{
+			return 0;
+		}
+#ifdef __APPLE__
+		return static_cast<std::size_t>(usage.ru_maxrss);
+#else
+		return static_cast<std::size_t>(usage.ru_maxrss) * 1024;
+#endif
+#else
+		return 0;
+#endif
+	}
+
+	std::uint64_t Statistics::get_AllocationCount()
+	{
+#ifdef PAMELA_COUNT_ALLOCATIONS
+		return g_allocationCount.load(std::memory_order_relaxed);
+#else
+		return 0;
+#endif
+	}
+
+	std::uint64_t Statistics::get_AllocatedBytes()
+	{
+#ifdef PAMELA_COUNT_ALLOCATIONS
+		return g_allocatedBytes.load(std::memory_order_relaxed);
+#else
+		return 0;
+#endif
+	}
+
+}
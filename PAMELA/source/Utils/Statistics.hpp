@@ -12,3 +12,74 @@
  * ------------------------------------------------------------------------------------------------------------
  */
 
+#pragma once
+
+// Std library includes
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace PAMELA
+{
+
+	/**
+	* \brief Timers and memory probes of the pipeline stages.
+	* Regions nest per thread: a region opened while another one is open on the same thread is recorded as its child,
+	* a region opened on a worker thread with no open region is a top-level one.
+	* Each region accumulates its number of calls, wall time, peak RSS of the process at its end and the growth of that
+	* peak while it was open, and, with PAMELA_COUNT_ALLOCATIONS, the heap allocations of the process while it was open.
+	*/
+	class Statistics
+	{
+	public:
+
+		enum class ReportFormat { TABLE, JSON };
+
+		static void BeginRegion(const char* name);
+		static void EndRegion();
+
+		//Zero the counters, regions stay open
+		static void Reset();
+
+		//Collective: regions are reduced over the ranks (min/avg/max with the rank of the max), the report is returned on rank 0 only
+		static std::string Report(ReportFormat format);
+
+		//Collective: rank 0 writes the report to the screen, or to file_path if not empty
+		static void Print(ReportFormat format, const std::string& file_path = "");
+
+		//Called by Communicator::finalize: prints the report if PAMELA_STATISTICS is "table" or "json",
+		//to the file PAMELA_STATISTICS_FILE if set
+		static void PrintFromEnvironment();
+
+		//Process peak resident set size in bytes, 0 if unknown
+		static std::size_t get_PeakRSS();
+
+		//Heap allocations of the process so far, 0 without PAMELA_COUNT_ALLOCATIONS
+		static std::uint64_t get_AllocationCount();
+		static std::uint64_t get_AllocatedBytes();
+
+	private:
+		Statistics() = delete;
+
+	};
+
+	/**
+	* \brief Region open for the lifetime of the object
+	*/
+	class ScopedRegion
+	{
+	public:
+
+		explicit ScopedRegion(const char* name) { Statistics::BeginRegion(name); }
+		~ScopedRegion() { Statistics::EndRegion(); }
+
+		ScopedRegion(const ScopedRegion&) = delete;
+		ScopedRegion& operator=(const ScopedRegion&) = delete;
+
+	};
+
+#define PAMELA_REGION_CONCAT_(a, b) a##b
+#define PAMELA_REGION_CONCAT(a, b) PAMELA_REGION_CONCAT_(a, b)
+#define PAMELA_REGION(name) PAMELA::ScopedRegion PAMELA_REGION_CONCAT(pamela_region_, __LINE__)(name)
+
+}
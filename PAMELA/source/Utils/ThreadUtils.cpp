@@ -0,0 +1,119 @@
+/*
+ * ------------------------------------------------------------------------------------------------------------
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ * Copyright (c) 2018-2020 Lawrence Livermore National Security LLC
+ * Copyright (c) 2018-2020 The Board of Trustees of the Leland Stanford Junior University
+ * Copyright (c) 2018-2020 Total, S.A
+ * Copyright (c) 2020-     GEOSX Contributors
+ * All right reserved
+ *
+ * See top level LICENSE, COPYRIGHT, CONTRIBUTORS, NOTICE, and ACKNOWLEDGEMENTS files for details.
+ * ------------------------------------------------------------------------------------------------------------
+ */
+
+#include "Utils/ThreadUtils.hpp"
+#include <cstdlib>
+
+namespace PAMELA
+{
+
+	namespace threadUtils
+	{
+
+		int NumberOfThreads()
+		{
+			static const int nThreads = []()
+			{
+				const char* env = std::getenv("PAMELA_NUM_THREADS");
+				if (env != nullptr)
+				{
+					int n = std::atoi(env);
+					if (n > 0)
+					{
+						return n;
+					}
+				}
+				int n = static_cast<int>(std::thread::hardware_concurrency());
+				return n > 0 ? n : 1;
+			}();
+			return nThreads;
+		}
+
+		TaskQueue::TaskQueue(std::size_t maxPending) : m_maxPending(std::max<std::size_t>(1, maxPending)), m_nPending(0), m_stop(false)
+		{
+			m_thread = std::thread(&TaskQueue::Run, this);
+		}
+
+		TaskQueue::~TaskQueue()
+		{
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_stop = true;
+			}
+			m_taskPushed.notify_one();
+			m_thread.join();
+		}
+
+		void TaskQueue::Push(std::function<void()> task)
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_taskDone.wait(lock, [this]() { return m_nPending < m_maxPending; });
+			m_tasks.push_back(std::move(task));
+			++m_nPending;
+			lock.unlock();
+			m_taskPushed.notify_one();
+		}
+
+		void TaskQueue::Wait()
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_taskDone.wait(lock, [this]() { return m_nPending == 0; });
+			if (m_exception)
+			{
+				auto exception = m_exception;
+				m_exception = nullptr;
+				std::rethrow_exception(exception);
+			}
+		}
+
+		void TaskQueue::Run()
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			while (true)
+			{
+				m_taskPushed.wait(lock, [this]() { return m_stop || !m_tasks.empty(); });
+				if (m_tasks.empty())
+				{
+					//Stopping, all tasks are done
+					return;
+				}
+
+				auto task = std::move(m_tasks.front());
+				m_tasks.pop_front();
+				lock.unlock();
+
+				std::exception_ptr exception;
+				try
+				{
+					task();
+				}
+				catch (...)
+				{
+					exception = std::current_exception();
+				}
+				//Release the task data before accepting a new one
+				task = nullptr;
+
+				lock.lock();
+				if (exception && !m_exception)
+				{
+					m_exception = exception;
+				}
+				--m_nPending;
+				m_taskDone.notify_all();
+			}
+		}
+
+	}
+}
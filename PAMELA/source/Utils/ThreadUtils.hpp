@@ -0,0 +1,108 @@
+/*
+ * ------------------------------------------------------------------------------------------------------------
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ * Copyright (c) 2018-2020 Lawrence Livermore National Security LLC
+ * Copyright (c) 2018-2020 The Board of Trustees of the Leland Stanford Junior University
+ * Copyright (c) 2018-2020 Total, S.A
+ * Copyright (c) 2020-     GEOSX Contributors
+ * All right reserved
+ *
+ * See top level LICENSE, COPYRIGHT, CONTRIBUTORS, NOTICE, and ACKNOWLEDGEMENTS files for details.
+ * ------------------------------------------------------------------------------------------------------------
+ */
+
+#pragma once
+
+// Std library includes
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace PAMELA
+{
+
+	namespace threadUtils
+	{
+
+		/**
+		* \brief Number of worker threads used by the shared-memory kernels.
+		* Defaults to the hardware concurrency, can be overridden with the PAMELA_NUM_THREADS environment variable.
+		*/
+		int NumberOfThreads();
+
+		/**
+		* \brief Split [0,n) in nChunks contiguous chunks and call f(chunk, begin, end) on each of them.
+		* Chunk 0 runs on the calling thread, the others on their own std::thread.
+		*/
+		template <typename SizeType, typename Function>
+		void ParallelChunks(SizeType n, int nChunks, Function f)
+		{
+			if (static_cast<long long>(nChunks) > static_cast<long long>(n))
+			{
+				nChunks = static_cast<int>(n);
+			}
+			nChunks = std::max(1, nChunks);
+			if (nChunks == 1)
+			{
+				f(0, SizeType(0), n);
+				return;
+			}
+
+			auto chunkStart = [n, nChunks](int chunk)
+			{
+				return static_cast<SizeType>(static_cast<long long>(n) * chunk / nChunks);
+			};
+
+			std::vector<std::thread> workers;
+			workers.reserve(nChunks - 1);
+			for (int chunk = 1; chunk < nChunks; ++chunk)
+			{
+				workers.emplace_back(f, chunk, chunkStart(chunk), chunkStart(chunk + 1));
+			}
+			f(0, SizeType(0), chunkStart(1));
+
+			for (auto& worker : workers)
+			{
+				worker.join();
+			}
+		}
+
+		/**
+		* \brief Tasks run in submission order by a single background thread.
+		* Push blocks while maxPending tasks are queued or running, which bounds the memory held by the tasks.
+		* The first exception thrown by a task is rethrown by Wait.
+		*/
+		class TaskQueue
+		{
+		public:
+			explicit TaskQueue(std::size_t maxPending);
+			~TaskQueue();
+
+			TaskQueue(const TaskQueue&) = delete;
+			TaskQueue& operator=(const TaskQueue&) = delete;
+
+			void Push(std::function<void()> task);
+			void Wait();
+
+		private:
+			void Run();
+
+			std::size_t m_maxPending;
+			std::size_t m_nPending;
+			bool m_stop;
+			std::deque<std::function<void()>> m_tasks;
+			std::exception_ptr m_exception;
+			std::mutex m_mutex;
+			std::condition_variable m_taskPushed;
+			std::condition_variable m_taskDone;
+			std::thread m_thread;
+		};
+
+	}
+}
@@ -18,6 +18,7 @@
 
 // Std library includes
 #include <cstddef>
+#include <cstdint>
 
 
 namespace PAMELA
@@ -42,5 +43,17 @@ namespace PAMELA
 		using proc_id_t = unsigned int;
 		using weight_t = double;
 
+		// for adjacency sparse matrices: row offsets may need 64 bits well before the element indices do
+#ifdef PAMELA_CSR_32BIT_OFFSETS
+		using csr_offset_t = std::int32_t;
+#else
+		using csr_offset_t = std::int64_t;
+#endif
+#ifdef PAMELA_CSR_64BIT_INDICES
+		using csr_index_t = std::int64_t;
+#else
+		using csr_index_t = std::int32_t;
+#endif
+
 	}
 }
@@ -0,0 +1,84 @@
+/*
+ * ------------------------------------------------------------------------------------------------------------
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ * Copyright (c) 2018-2020 Lawrence Livermore National Security LLC
+ * Copyright (c) 2018-2020 The Board of Trustees of the Leland Stanford Junior University
+ * Copyright (c) 2018-2020 Total, S.A
+ * Copyright (c) 2020-     GEOSX Contributors
+ * All right reserved
+ *
+ * See top level LICENSE, COPYRIGHT, CONTRIBUTORS, NOTICE, and ACKNOWLEDGEMENTS files for details.
+ * ------------------------------------------------------------------------------------------------------------
+ */
+
+#include "benchmark_io.h"
+#include "Adjacency/Adjacency.hpp"
+#include "benchmark/benchmark.h"
+
+using namespace PAMELA;
+
+namespace {
+  const ELEMENTS::FAMILY POINT = ELEMENTS::FAMILY::POINT;
+  const ELEMENTS::FAMILY POLYGON = ELEMENTS::FAMILY::POLYGON;
+  const ELEMENTS::FAMILY POLYHEDRON = ELEMENTS::FAMILY::POLYHEDRON;
+}
+
+//Derivation from the primitive adjacencies, including the derived ones it depends on
+static void BM_TopologicalAdjacency(benchmark::State& state, ELEMENTS::FAMILY source, ELEMENTS::FAMILY target, ELEMENTS::FAMILY base) {
+  int n = static_cast<int>(state.range(0));
+  Mesh* mesh = make_cartesian_mesh(n);
+  auto adjacencySet = mesh->getAdjacencySet();
+  for (auto _ : state) {
+    state.PauseTiming();
+    adjacencySet->InvalidateTopologicalAdjacencies();
+    state.ResumeTiming();
+    benchmark::DoNotOptimize(adjacencySet->get_TopologicalAdjacency(source, target, base));
+  }
+  state.SetItemsProcessed(state.iterations() * n * n * n);
+  delete mesh;
+}
+BENCHMARK_CAPTURE(BM_TopologicalAdjacency, PolyhedronToPoint, POLYHEDRON, POINT, POLYHEDRON)->Arg(16)->Arg(32)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_TopologicalAdjacency, PolygonToPoint, POLYGON, POINT, POLYGON)->Arg(16)->Arg(32)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_TopologicalAdjacency, PointToPolyhedron, POINT, POLYHEDRON, POLYHEDRON)->Arg(16)->Arg(32)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_TopologicalAdjacency, PointToPolygon, POINT, POLYGON, POLYGON)->Arg(16)->Arg(32)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_TopologicalAdjacency, PolygonToPolyhedron, POLYGON, POLYHEDRON, POLYHEDRON)->Arg(16)->Arg(32)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_TopologicalAdjacency, PolyhedronToPolyhedronThroughPolygon, POLYHEDRON, POLYHEDRON, POLYGON)->Arg(16)->Arg(32)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_TopologicalAdjacency, PolyhedronToPolyhedronThroughPoint, POLYHEDRON, POLYHEDRON, POINT)->Arg(16)->Arg(32)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_TopologicalAdjacency, PolygonToPolygonThroughPoint, POLYGON, POLYGON, POINT)->Arg(16)->Arg(32)->Unit(benchmark::kMillisecond);
+
+//Polyhedron to Polygon matrix registered by CreateFacesFromCells
+static void BM_CSRMatrixTranspose(benchmark::State& state) {
+  int n = static_cast<int>(state.range(0));
+  Mesh* mesh = make_cartesian_mesh(n);
+  auto matrix = mesh->getAdjacencySet()->get_TopologicalAdjacency(POLYHEDRON, POLYGON, POLYHEDRON)->get_adjacencySparseMatrix();
+  for (auto _ : state) {
+    CSRMatrix* transposed = CSRMatrix::transpose(matrix);
+    benchmark::DoNotOptimize(transposed);
+    state.PauseTiming();
+    delete transposed;
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * matrix->nnz);
+  delete mesh;
+}
+BENCHMARK(BM_CSRMatrixTranspose)->Arg(16)->Arg(32)->Unit(benchmark::kMillisecond);
+
+//Polyhedron to Polyhedron through Polygon: product of the Polyhedron to Polygon matrix by its transpose
+static void BM_CSRMatrixProduct(benchmark::State& state) {
+  int n = static_cast<int>(state.range(0));
+  Mesh* mesh = make_cartesian_mesh(n);
+  auto matrix = mesh->getAdjacencySet()->get_TopologicalAdjacency(POLYHEDRON, POLYGON, POLYHEDRON)->get_adjacencySparseMatrix();
+  CSRMatrix* transposed = CSRMatrix::transpose(matrix);
+  for (auto _ : state) {
+    CSRMatrix* product = CSRMatrix::product(matrix, transposed);
+    benchmark::DoNotOptimize(product);
+    state.PauseTiming();
+    delete product;
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * matrix->nnz);
+  delete transposed;
+  delete mesh;
+}
+BENCHMARK(BM_CSRMatrixProduct)->Arg(16)->Arg(32)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,139 @@
+/*
+ * ------------------------------------------------------------------------------------------------------------
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ * Copyright (c) 2018-2020 Lawrence Livermore National Security LLC
+ * Copyright (c) 2018-2020 The Board of Trustees of the Leland Stanford Junior University
+ * Copyright (c) 2018-2020 Total, S.A
+ * Copyright (c) 2020-     GEOSX Contributors
+ * All right reserved
+ *
+ * See top level LICENSE, COPYRIGHT, CONTRIBUTORS, NOTICE, and ACKNOWLEDGEMENTS files for details.
+ * ------------------------------------------------------------------------------------------------------------
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "Mesh/MeshFactory.hpp"
+
+namespace PAMELA {
+
+  //Cartesian mesh of n x n x n unit cells with its faces
+  inline Mesh* make_cartesian_mesh(int n, bool createFaces = true) {
+    Mesh* mesh = MeshFactory::makeMesh(n, n, n, 1., 1., 1.);
+    if (createFaces) {
+      mesh->CreateFacesFromCells();
+    }
+    return mesh;
+  }
+
+  //Pillars and corner depths of a regular n x n x n corner-point grid
+  inline void make_corner_point_grid(int n, std::vector<double>& coord, std::vector<double>& zcorn) {
+    coord.clear();
+    zcorn.clear();
+    for (int j = 0; j <= n; ++j) {
+      for (int i = 0; i <= n; ++i) {
+        double pillar[6] = { double(i), double(j), 0., double(i), double(j), double(n) };
+        coord.insert(coord.end(), pillar, pillar + 6);
+      }
+    }
+    //k, top/bottom, j and its two corners, i and its two corners
+    for (int k = 0; k < n; ++k) {
+      for (int tb = 0; tb < 2; ++tb) {
+        zcorn.insert(zcorn.end(), 4 * n * n, double(k + tb));
+      }
+    }
+  }
+
+  inline std::string write_grdecl_deck(const std::string& file_path, int n) {
+    std::vector<double> coord, zcorn;
+    make_corner_point_grid(n, coord, zcorn);
+    std::ofstream file(file_path);
+    file << "SPECGRID\n" << n << " " << n << " " << n << " 1 F /\n\n";
+    file << "COORD\n";
+    for (std::size_t i = 0; i != coord.size(); ++i) {
+      file << coord[i] << ((i % 6 == 5) ? "\n" : " ");
+    }
+    file << "/\n\nZCORN\n";
+    for (std::size_t i = 0; i != zcorn.size(); ++i) {
+      file << zcorn[i] << ((i % 8 == 7) ? "\n" : " ");
+    }
+    file << "/\n\nACTNUM\n" << n * n * n << "*1 /\n\n";
+    file << "PORO\n" << n * n * n << "*0.2 /\n";
+    return file_path;
+  }
+
+  //Eclipse binary files are big-endian Fortran records, data split in records of 1000 values
+  class EclipseBinaryWriter {
+  public:
+    explicit EclipseBinaryWriter(const std::string& file_path) : m_file(file_path, std::ios::binary) {}
+
+    void write(const std::string& keyword, const std::vector<int>& data) {
+      write_header(keyword, data.size(), "INTE");
+      write_data(data);
+    }
+
+    void write(const std::string& keyword, const std::vector<float>& data) {
+      write_header(keyword, data.size(), "REAL");
+      write_data(data);
+    }
+
+  private:
+    std::ofstream m_file;
+
+    void write_int(std::int32_t value) {
+      std::uint32_t bits;
+      std::memcpy(&bits, &value, 4);
+      write_bits(bits);
+    }
+
+    void write_bits(std::uint32_t bits) {
+      char bytes[4] = { char(bits >> 24), char(bits >> 16), char(bits >> 8), char(bits) };
+      m_file.write(bytes, 4);
+    }
+
+    void write_header(std::string keyword, std::size_t size, const char* type) {
+      keyword.resize(8, ' ');
+      write_int(16);
+      m_file.write(keyword.data(), 8);
+      write_int(static_cast<std::int32_t>(size));
+      m_file.write(type, 4);
+      write_int(16);
+    }
+
+    template <typename T>
+    void write_data(const std::vector<T>& data) {
+      for (std::size_t begin = 0; begin < data.size(); begin += 1000) {
+        std::size_t end = std::min(data.size(), begin + 1000);
+        write_int(static_cast<std::int32_t>(4 * (end - begin)));
+        for (std::size_t i = begin; i != end; ++i) {
+          std::uint32_t bits;
+          std::memcpy(&bits, &data[i], 4);
+          write_bits(bits);
+        }
+        write_int(static_cast<std::int32_t>(4 * (end - begin)));
+      }
+    }
+  };
+
+  inline std::string write_egrid_deck(const std::string& file_path, int n) {
+    std::vector<double> coord, zcorn;
+    make_corner_point_grid(n, coord, zcorn);
+    std::vector<int> gridhead(100, 0);
+    gridhead[0] = 1;
+    gridhead[1] = gridhead[2] = gridhead[3] = n;
+
+    EclipseBinaryWriter file(file_path);
+    file.write("GRIDHEAD", gridhead);
+    file.write("COORD", std::vector<float>(coord.begin(), coord.end()));
+    file.write("ZCORN", std::vector<float>(zcorn.begin(), zcorn.end()));
+    file.write("ACTNUM", std::vector<int>(n * n * n, 1));
+    return file_path;
+  }
+
+}
@@ -0,0 +1,47 @@
+/*
+ * ------------------------------------------------------------------------------------------------------------
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ * Copyright (c) 2018-2020 Lawrence Livermore National Security LLC
+ * Copyright (c) 2018-2020 The Board of Trustees of the Leland Stanford Junior University
+ * Copyright (c) 2018-2020 Total, S.A
+ * Copyright (c) 2020-     GEOSX Contributors
+ * All right reserved
+ *
+ * See top level LICENSE, COPYRIGHT, CONTRIBUTORS, NOTICE, and ACKNOWLEDGEMENTS files for details.
+ * ------------------------------------------------------------------------------------------------------------
+ */
+
+#include "benchmark_io.h"
+#include "benchmark/benchmark.h"
+
+using namespace PAMELA;
+
+//Synthetic n x n x n corner-point decks written in the working directory
+static void BM_ImportGRDECL(benchmark::State& state) {
+  int n = static_cast<int>(state.range(0));
+  auto file_path = write_grdecl_deck("benchmark_" + std::to_string(n) + ".GRDECL", n);
+  for (auto _ : state) {
+    Mesh* mesh = MeshFactory::makeMesh(file_path);
+    benchmark::DoNotOptimize(mesh);
+    state.PauseTiming();
+    delete mesh;
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * n * n * n);
+}
+BENCHMARK(BM_ImportGRDECL)->Arg(8)->Arg(16)->Arg(32)->Unit(benchmark::kMillisecond);
+
+static void BM_ImportEGRID(benchmark::State& state) {
+  int n = static_cast<int>(state.range(0));
+  auto file_path = write_egrid_deck("benchmark_" + std::to_string(n) + ".EGRID", n);
+  for (auto _ : state) {
+    Mesh* mesh = MeshFactory::makeMesh(file_path);
+    benchmark::DoNotOptimize(mesh);
+    state.PauseTiming();
+    delete mesh;
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * n * n * n);
+}
+BENCHMARK(BM_ImportEGRID)->Arg(8)->Arg(16)->Arg(32)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,81 @@
+/*
+ * ------------------------------------------------------------------------------------------------------------
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ * Copyright (c) 2018-2020 Lawrence Livermore National Security LLC
+ * Copyright (c) 2018-2020 The Board of Trustees of the Leland Stanford Junior University
+ * Copyright (c) 2018-2020 Total, S.A
+ * Copyright (c) 2020-     GEOSX Contributors
+ * All right reserved
+ *
+ * See top level LICENSE, COPYRIGHT, CONTRIBUTORS, NOTICE, and ACKNOWLEDGEMENTS files for details.
+ * ------------------------------------------------------------------------------------------------------------
+ */
+
+
+#include <algorithm>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "Utils/IndexMap.hpp"
+#include "benchmark/benchmark.h"
+
+using namespace PAMELA;
+
+//Global to local index lookups of IndexMap against std::unordered_map<int,int>, queries in random order.
+//"Compact" keys are a permutation of a contiguous range (partitioned mesh), "scattered" keys are spread over the int range.
+namespace {
+
+  std::vector<int> make_keys(int nKeys, bool compact) {
+    std::mt19937 generator(42);
+    std::vector<int> keys(nKeys);
+    if (compact) {
+      for (int i = 0; i != nKeys; ++i) {
+        keys[i] = 3 * nKeys / 2 + i;
+      }
+    } else {
+      std::uniform_int_distribution<int> distribution(0, 2000000000);
+      std::generate(keys.begin(), keys.end(), [&]() { return distribution(generator); });
+      std::sort(keys.begin(), keys.end());
+      keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    }
+    std::shuffle(keys.begin(), keys.end(), generator);
+    return keys;
+  }
+
+  template <class Map>
+  void run_lookups(benchmark::State& state, const Map& map, std::vector<int> queries) {
+    std::shuffle(queries.begin(), queries.end(), std::mt19937(7));
+    for (auto _ : state) {
+      long long checksum = 0;
+      for (auto key : queries) {
+        checksum += map.at(key);
+      }
+      benchmark::DoNotOptimize(checksum);
+    }
+    state.SetItemsProcessed(state.iterations() * queries.size());
+  }
+
+}
+
+static void BM_IndexMapLookup(benchmark::State& state, bool compact) {
+  auto keys = make_keys(static_cast<int>(state.range(0)), compact);
+  IndexMap map;
+  map.Build(keys);
+  state.counters["bytes"] = static_cast<double>(map.get_MemoryFootprint());
+  run_lookups(state, map, keys);
+}
+BENCHMARK_CAPTURE(BM_IndexMapLookup, compact, true)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK_CAPTURE(BM_IndexMapLookup, scattered, false)->Arg(1 << 16)->Arg(1 << 20);
+
+static void BM_UnorderedMapLookup(benchmark::State& state, bool compact) {
+  auto keys = make_keys(static_cast<int>(state.range(0)), compact);
+  std::unordered_map<int, int> map;
+  for (std::size_t i = 0; i != keys.size(); ++i) {
+    map.insert(std::make_pair(keys[i], static_cast<int>(i)));
+  }
+  run_lookups(state, map, keys);
+}
+BENCHMARK_CAPTURE(BM_UnorderedMapLookup, compact, true)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK_CAPTURE(BM_UnorderedMapLookup, scattered, false)->Arg(1 << 16)->Arg(1 << 20);
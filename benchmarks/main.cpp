@@ -0,0 +1,31 @@
+/*
+ * ------------------------------------------------------------------------------------------------------------
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ * Copyright (c) 2018-2020 Lawrence Livermore National Security LLC
+ * Copyright (c) 2018-2020 The Board of Trustees of the Leland Stanford Junior University
+ * Copyright (c) 2018-2020 Total, S.A
+ * Copyright (c) 2020-     GEOSX Contributors
+ * All right reserved
+ *
+ * See top level LICENSE, COPYRIGHT, CONTRIBUTORS, NOTICE, and ACKNOWLEDGEMENTS files for details.
+ * ------------------------------------------------------------------------------------------------------------
+ */
+
+#include "Parallel/Communicator.hpp"
+#include "benchmark/benchmark.h"
+
+using namespace PAMELA;
+
+//Run with --benchmark_out=<file> --benchmark_out_format=json to record the results
+int main(int argc, char **argv) {
+  Communicator::initialize();
+  ::benchmark::Initialize(&argc, argv);
+  if (::benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    Communicator::finalize();
+    return 1;
+  }
+  ::benchmark::RunSpecifiedBenchmarks();
+  Communicator::finalize();
+  return 0;
+}
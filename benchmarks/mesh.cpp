@@ -0,0 +1,66 @@
+/*
+ * ------------------------------------------------------------------------------------------------------------
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ * Copyright (c) 2018-2020 Lawrence Livermore National Security LLC
+ * Copyright (c) 2018-2020 The Board of Trustees of the Leland Stanford Junior University
+ * Copyright (c) 2018-2020 Total, S.A
+ * Copyright (c) 2020-     GEOSX Contributors
+ * All right reserved
+ *
+ * See top level LICENSE, COPYRIGHT, CONTRIBUTORS, NOTICE, and ACKNOWLEDGEMENTS files for details.
+ * ------------------------------------------------------------------------------------------------------------
+ */
+
+#include "benchmark_io.h"
+#include "benchmark/benchmark.h"
+
+using namespace PAMELA;
+
+static void BM_CartesianMesh(benchmark::State& state) {
+  int n = static_cast<int>(state.range(0));
+  for (auto _ : state) {
+    Mesh* mesh = make_cartesian_mesh(n, false);
+    benchmark::DoNotOptimize(mesh);
+    state.PauseTiming();
+    delete mesh;
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * n * n * n);
+}
+BENCHMARK(BM_CartesianMesh)->Arg(8)->Arg(16)->Arg(32)->Unit(benchmark::kMillisecond);
+
+static void BM_CreateFacesFromCells(benchmark::State& state) {
+  int n = static_cast<int>(state.range(0));
+  for (auto _ : state) {
+    state.PauseTiming();
+    Mesh* mesh = make_cartesian_mesh(n, false);
+    state.ResumeTiming();
+    mesh->CreateFacesFromCells();
+    state.PauseTiming();
+    delete mesh;
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * n * n * n);
+}
+BENCHMARK(BM_CreateFacesFromCells)->Arg(8)->Arg(16)->Arg(32)->Unit(benchmark::kMillisecond);
+
+//With a single rank METIS falls back to the trivial partitioning, run under mpirun to time it
+static void BM_PerformPolyhedronPartitioning(benchmark::State& state, const std::string& partitioningType) {
+  int n = static_cast<int>(state.range(0));
+  for (auto _ : state) {
+    state.PauseTiming();
+    Mesh* mesh = make_cartesian_mesh(n);
+    mesh->SetPartitioning(partitioningType);
+    state.ResumeTiming();
+    mesh->PerformPolyhedronPartitioning(ELEMENTS::FAMILY::POLYGON, ELEMENTS::FAMILY::POLYGON);
+    state.PauseTiming();
+    delete mesh;
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * n * n * n);
+}
+BENCHMARK_CAPTURE(BM_PerformPolyhedronPartitioning, TRIVIAL, std::string("TRIVIAL"))->Arg(8)->Arg(16)->Unit(benchmark::kMillisecond);
+#ifdef WITH_METIS
+BENCHMARK_CAPTURE(BM_PerformPolyhedronPartitioning, METIS, std::string("METIS"))->Arg(8)->Arg(16)->Unit(benchmark::kMillisecond);
+#endif
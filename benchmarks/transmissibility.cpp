@@ -0,0 +1,45 @@
+/*
+ * ------------------------------------------------------------------------------------------------------------
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ * Copyright (c) 2018-2020 Lawrence Livermore National Security LLC
+ * Copyright (c) 2018-2020 The Board of Trustees of the Leland Stanford Junior University
+ * Copyright (c) 2018-2020 Total, S.A
+ * Copyright (c) 2020-     GEOSX Contributors
+ * All right reserved
+ *
+ * See top level LICENSE, COPYRIGHT, CONTRIBUTORS, NOTICE, and ACKNOWLEDGEMENTS files for details.
+ * ------------------------------------------------------------------------------------------------------------
+ */
+
+#include <algorithm>
+
+#include "benchmark_io.h"
+#include "Adjacency/Adjacency.hpp"
+#include "Mesh/Transmissibility.hpp"
+#include "benchmark/benchmark.h"
+
+using namespace PAMELA;
+
+//Two-point flux transmissibilities of a Cartesian mesh with a uniform permeability, from the cached geometry
+static void BM_TPFATransmissibilities(benchmark::State& state) {
+  int n = static_cast<int>(state.range(0));
+  Mesh* mesh = make_cartesian_mesh(n);
+  auto faceToCell = mesh->getAdjacencySet()->get_TopologicalAdjacency(ELEMENTS::FAMILY::POLYGON, ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::FAMILY::POLYHEDRON);
+  const auto& cells = mesh->get_PolyhedronGeometry();
+  const auto& faces = mesh->get_PolygonGeometry();
+  tpfa::Permeability permeability;
+  permeability.resize(mesh->get_PolyhedronCollection()->size_all());
+  std::fill(permeability.xx.begin(), permeability.xx.end(), 1e-13);
+  std::fill(permeability.yy.begin(), permeability.yy.end(), 1e-13);
+  std::fill(permeability.zz.begin(), permeability.zz.end(), 1e-14);
+  for (auto _ : state) {
+    CSRMatrix connections;
+    std::vector<double> transmissibilities;
+    tpfa::ComputeTransmissibilities(cells, faces, *faceToCell->get_adjacencySparseMatrix(), permeability, connections, transmissibilities);
+    benchmark::DoNotOptimize(transmissibilities.data());
+  }
+  state.SetItemsProcessed(state.iterations() * n * n * n);
+  delete mesh;
+}
+BENCHMARK(BM_TPFATransmissibilities)->Arg(16)->Arg(32)->Unit(benchmark::kMillisecond);
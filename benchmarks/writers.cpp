@@ -0,0 +1,44 @@
+/*
+ * ------------------------------------------------------------------------------------------------------------
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ * Copyright (c) 2018-2020 Lawrence Livermore National Security LLC
+ * Copyright (c) 2018-2020 The Board of Trustees of the Leland Stanford Junior University
+ * Copyright (c) 2018-2020 Total, S.A
+ * Copyright (c) 2020-     GEOSX Contributors
+ * All right reserved
+ *
+ * See top level LICENSE, COPYRIGHT, CONTRIBUTORS, NOTICE, and ACKNOWLEDGEMENTS files for details.
+ * ------------------------------------------------------------------------------------------------------------
+ */
+
+#include "benchmark_io.h"
+#include "MeshDataWriters/MeshDataWriterFactory.hpp"
+#include "benchmark/benchmark.h"
+
+using namespace PAMELA;
+
+//Writer construction, Init and one Dump of a cell and a point variable, files written in the working directory.
+//The writers need numbered cell groups, which the Cartesian mesh does not have: the mesh is imported from a synthetic deck.
+static void BM_Writer(benchmark::State& state, const std::string& extension, ENCODING encoding) {
+  int n = static_cast<int>(state.range(0));
+  Mesh* mesh = MeshFactory::makeMesh(write_grdecl_deck("benchmark_writer_" + std::to_string(n) + ".GRDECL", n));
+  mesh->CreateFacesFromCells();
+  mesh->PerformPolyhedronPartitioning(ELEMENTS::FAMILY::POLYGON, ELEMENTS::FAMILY::POLYGON);
+  for (auto _ : state) {
+    MeshDataWriter* writer = MeshDataWriterFactory::makeWriter(mesh, "benchmark_writer." + extension, encoding);
+    writer->DeclareVariable(FAMILY::POLYHEDRON, VARIABLE_DIMENSION::SCALAR, VARIABLE_LOCATION::PER_CELL, "Pressure");
+    writer->DeclareVariable(FAMILY::POLYHEDRON, VARIABLE_DIMENSION::SCALAR, VARIABLE_LOCATION::PER_NODE, "Temperature");
+    writer->DeclareAndSetPartitionNumber();
+    writer->Init();
+    writer->SetVariableOnAllParts("Pressure", 1.0);
+    writer->SetVariableOnAllParts("Temperature", 2.0);
+    writer->Dump();
+    delete writer;
+  }
+  state.SetItemsProcessed(state.iterations() * n * n * n);
+  delete mesh;
+}
+BENCHMARK_CAPTURE(BM_Writer, VTU, std::string("vtu"), ENCODING::ASCII)->Arg(16)->Arg(32)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_Writer, EnsightGoldASCII, std::string("case"), ENCODING::ASCII)->Arg(16)->Arg(32)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_Writer, EnsightGoldBinary, std::string("case"), ENCODING::BINARY)->Arg(16)->Arg(32)->Unit(benchmark::kMillisecond);
@@ -6,6 +6,26 @@ if(ENABLE_MPI)
                      LIBRARIES ${METIS_LIBRARIES})
 endif()
 
+#zlib
+if(PAMELA_WITH_ZLIB)
+  find_package(ZLIB REQUIRED)
+   blt_import_library(NAME zlib
+                     INCLUDES ${ZLIB_INCLUDE_DIRS}
+                     TREAT_INCLUDES_AS_SYSTEM ON
+                     LIBRARIES ${ZLIB_LIBRARIES})
+   message(STATUS "Found zlib")
+endif()
+
+#HDF5
+if(PAMELA_WITH_HDF5)
+  find_package(HDF5 REQUIRED COMPONENTS C)
+   blt_import_library(NAME hdf5
+                     INCLUDES ${HDF5_INCLUDE_DIRS}
+                     TREAT_INCLUDES_AS_SYSTEM ON
+                     LIBRARIES ${HDF5_LIBRARIES})
+   message(STATUS "Found HDF5, parallel: ${HDF5_IS_PARALLEL}")
+endif()
+
 #VTK
 if(PAMELA_WITH_VTK)
   find_package(VTK REQUIRED COMPONENTS vtkParallelMPI vtkIOParallelXML)
@@ -41,6 +41,8 @@ int main(int argc, char **argv) {
   args::CompletionFlag completion(parser, { "complete" });
   args::ValueFlag<std::string> input(parser, "", "The input mesh", { "input" });
   args::ValueFlag<std::string> output(parser, "", "The output mesh", { "output" });
+  args::Flag binary(parser, "", "Binary output, if supported by the output format", { "binary" });
+  args::ValueFlag<std::string> partitionCache(parser, "", "Directory where the partitions of the input mesh are saved and read back", { "partition-cache" });
   args::ValueFlag<std::string> nx(parser, "", "Number of cells in x direction", { "nx" });
   args::ValueFlag<std::string> ny(parser, "", "Number of cells in y direction", { "ny" });
   args::ValueFlag<std::string> nz(parser, "", "Number of cells in z direction", { "nz" });
@@ -68,6 +70,9 @@ int main(int argc, char **argv) {
         std::stod(args::get(dy)),
         std::stod(args::get(dz)));
   }
+  else if (partitionCache) {
+    input_mesh = MeshFactory::makePartitionedMesh(args::get(input), args::get(partitionCache));
+  }
   else {
     const std::string input_mesh_filename = args::get(input);
     input_mesh = MeshFactory::makeMesh(input_mesh_filename);
@@ -75,13 +80,15 @@ int main(int argc, char **argv) {
 
   const std::string output_mesh_filename = args::get(output);
 
-  input_mesh->CreateFacesFromCells();
-  input_mesh->PerformPolyhedronPartitioning(
-      ELEMENTS::FAMILY::POLYGON, ELEMENTS::FAMILY::POLYGON);
+  if (!input || !partitionCache) {
+    input_mesh->CreateFacesFromCells();
+    input_mesh->PerformPolyhedronPartitioning(
+        ELEMENTS::FAMILY::POLYGON, ELEMENTS::FAMILY::POLYGON);
+  }
   input_mesh->CreateLineGroupWithAdjacency("TopologicalC2C", input_mesh->getAdjacencySet()->get_TopologicalAdjacency(ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::FAMILY::POLYGON));
 
   MeshDataWriter* output_mesh = MeshDataWriterFactory::makeWriter(
-      input_mesh, output_mesh_filename);
+      input_mesh, output_mesh_filename, binary ? ENCODING::BINARY : ENCODING::ASCII);
 
   auto mesh_props = input_mesh->get_PolyhedronProperty_double()->get_PropertyMap();
   for (auto it = mesh_props.begin(); it != mesh_props.end(); ++it)
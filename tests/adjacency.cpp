@@ -0,0 +1,196 @@
+/*
+ * ------------------------------------------------------------------------------------------------------------
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ * Copyright (c) 2018-2020 Lawrence Livermore National Security LLC
+ * Copyright (c) 2018-2020 The Board of Trustees of the Leland Stanford Junior University
+ * Copyright (c) 2018-2020 Total, S.A
+ * Copyright (c) 2020-     GEOSX Contributors
+ * All right reserved
+ *
+ * See top level LICENSE, COPYRIGHT, CONTRIBUTORS, NOTICE, and ACKNOWLEDGEMENTS files for details.
+ * ------------------------------------------------------------------------------------------------------------
+ */
+
+
+#include <algorithm>
+#include <vector>
+
+#include "Parallel/Communicator.hpp"
+#include "Mesh/MeshFactory.hpp"
+#include "Adjacency/Adjacency.hpp"
+#include "gtest/gtest.h"
+
+using namespace PAMELA;
+
+int main(int argc, char **argv) {
+    Communicator::initialize();
+    ::testing::InitGoogleTest(&argc, argv);
+    int const result = RUN_ALL_TESTS();
+    Communicator::finalize();
+    return result;
+}
+
+TEST(testAdjacency, derivedFamiliesAndCollections)
+{
+    Mesh* mesh = MeshFactory::makeMesh(2, 2, 2, 1., 1., 1.);
+    mesh->CreateFacesFromCells();
+    auto adjacencySet = mesh->getAdjacencySet();
+
+    //Transposition of the registered Polyhedron to Polygon adjacency
+    auto faceToCell = adjacencySet->get_TopologicalAdjacency(ELEMENTS::FAMILY::POLYGON, ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::FAMILY::POLYHEDRON);
+    EXPECT_EQ(faceToCell->get_sourceFamily(), ELEMENTS::FAMILY::POLYGON);
+    EXPECT_EQ(faceToCell->get_targetFamily(), ELEMENTS::FAMILY::POLYHEDRON);
+    EXPECT_EQ(faceToCell->get_sourceElementCollection(), mesh->get_PolygonCollection());
+    EXPECT_EQ(faceToCell->get_targetElementCollection(), mesh->get_PolyhedronCollection());
+    EXPECT_EQ(faceToCell->get_adjacencySparseMatrix()->dimRow, static_cast<int>(mesh->get_PolygonCollection()->size_all()));
+
+    //Product Polyhedron -> Polygon -> Point
+    auto cellToPoint = adjacencySet->get_TopologicalAdjacency(ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::FAMILY::POINT, ELEMENTS::FAMILY::POLYGON);
+    EXPECT_EQ(cellToPoint->get_sourceFamily(), ELEMENTS::FAMILY::POLYHEDRON);
+    EXPECT_EQ(cellToPoint->get_targetFamily(), ELEMENTS::FAMILY::POINT);
+    EXPECT_EQ(cellToPoint->get_baseFamily(), ELEMENTS::FAMILY::POLYGON);
+    EXPECT_EQ(cellToPoint->get_sourceElementCollection(), mesh->get_PolyhedronCollection());
+    EXPECT_EQ(cellToPoint->get_targetElementCollection(), mesh->get_PointCollection());
+    EXPECT_EQ(cellToPoint->get_baseElementCollection(), mesh->get_PolygonCollection());
+    EXPECT_EQ(cellToPoint->get_adjacencySparseMatrix()->dimRow, 8);
+    EXPECT_EQ(cellToPoint->get_adjacencySparseMatrix()->dimColumn, 27);
+
+    //Each cell of a 2x2x2 grid shares a face with 3 others
+    auto cellToCell = adjacencySet->get_TopologicalAdjacency(ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::FAMILY::POLYGON);
+    auto csr = cellToCell->get_adjacencySparseMatrix();
+    for (int i = 0; i != csr->dimRow; ++i)
+    {
+        int neighbors = 0;
+        for (auto j = csr->rowPtr[i]; j != csr->rowPtr[i + 1]; ++j)
+        {
+            neighbors += csr->columnIndex[j] != i;
+        }
+        EXPECT_EQ(neighbors, 3);
+    }
+
+    delete mesh;
+}
+
+TEST(testAdjacency, cacheAndInvalidation)
+{
+    Mesh* mesh = MeshFactory::makeMesh(2, 2, 2, 1., 1., 1.);
+    mesh->CreateFacesFromCells();
+    auto adjacencySet = mesh->getAdjacencySet();
+
+    auto cellToCell = adjacencySet->get_TopologicalAdjacency(ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::FAMILY::POLYGON);
+    EXPECT_EQ(adjacencySet->get_TopologicalAdjacency(ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::FAMILY::POLYGON), cellToCell);
+
+    //Adding lines and points must drop the cached adjacencies built on the old collections
+    auto lineToPoint = adjacencySet->get_TopologicalAdjacency(ELEMENTS::FAMILY::LINE, ELEMENTS::FAMILY::POINT, ELEMENTS::FAMILY::LINE);
+    EXPECT_EQ(lineToPoint->get_adjacencySparseMatrix()->dimRow, 0);
+    EXPECT_EQ(lineToPoint->get_adjacencySparseMatrix()->dimColumn, 27);
+
+    mesh->CreateLineGroupWithAdjacency("TopologicalC2C", cellToCell);
+    auto nLines = static_cast<int>(mesh->get_LineCollection()->size_all());
+    auto nPoints = static_cast<int>(mesh->get_PointCollection()->size_all());
+    EXPECT_GT(nLines, 0);
+    EXPECT_GT(nPoints, 27);
+
+    lineToPoint = adjacencySet->get_TopologicalAdjacency(ELEMENTS::FAMILY::LINE, ELEMENTS::FAMILY::POINT, ELEMENTS::FAMILY::LINE);
+    EXPECT_EQ(lineToPoint->get_adjacencySparseMatrix()->dimRow, nLines);
+    EXPECT_EQ(lineToPoint->get_adjacencySparseMatrix()->dimColumn, nPoints);
+
+    delete mesh;
+}
+
+TEST(testAdjacency, edgesFromCells)
+{
+    //n x n x n grid: 3 n (n+1)^2 edges, each cell has 12, an inner edge is shared by 4 cells
+    const int n = 2;
+    Mesh* mesh = MeshFactory::makeMesh(n, n, n, 1., 1., 1.);
+    mesh->CreateFacesFromCells();
+    mesh->CreateEdgesFromCells();
+    auto adjacencySet = mesh->getAdjacencySet();
+
+    auto nLines = static_cast<int>(mesh->get_LineCollection()->size_all());
+    EXPECT_EQ(nLines, 3 * n * (n + 1) * (n + 1));
+
+    auto cellToEdge = adjacencySet->get_TopologicalAdjacency(ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::FAMILY::LINE, ELEMENTS::FAMILY::POLYHEDRON);
+    auto csr = cellToEdge->get_adjacencySparseMatrix();
+    EXPECT_EQ(csr->dimRow, n * n * n);
+    EXPECT_EQ(csr->dimColumn, nLines);
+    for (int i = 0; i != csr->dimRow; ++i)
+    {
+        EXPECT_EQ(csr->rowPtr[i + 1] - csr->rowPtr[i], 12);
+    }
+
+    //Every edge is connected to 1, 2 or 4 cells, and its end points are vertices of these cells
+    auto edgeToCell = adjacencySet->get_TopologicalAdjacency(ELEMENTS::FAMILY::LINE, ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::FAMILY::POLYHEDRON);
+    auto csrT = edgeToCell->get_adjacencySparseMatrix();
+    EXPECT_EQ(csrT->dimRow, nLines);
+    std::vector<int> edgesPerValence(5, 0);
+    for (int e = 0; e != csrT->dimRow; ++e)
+    {
+        auto valence = csrT->rowPtr[e + 1] - csrT->rowPtr[e];
+        ASSERT_TRUE(valence == 1 || valence == 2 || valence == 4);
+        ++edgesPerValence[valence];
+        auto& edgeVertices = (*mesh->get_LineCollection())[e]->get_vertexList();
+        for (auto j = csrT->rowPtr[e]; j != csrT->rowPtr[e + 1]; ++j)
+        {
+            auto& cellVertices = (*mesh->get_PolyhedronCollection())[csrT->columnIndex[j]]->get_vertexList();
+            for (auto vertex : edgeVertices)
+            {
+                EXPECT_NE(std::find(cellVertices.begin(), cellVertices.end(), vertex), cellVertices.end());
+            }
+        }
+    }
+    EXPECT_EQ(edgesPerValence[1], 12 * n);
+    EXPECT_EQ(edgesPerValence[4], 3 * n * (n - 1) * (n - 1));
+    EXPECT_EQ(edgesPerValence[2], nLines - edgesPerValence[1] - edgesPerValence[4]);
+
+    //Calling it again reuses the existing lines
+    mesh->CreateEdgesFromCells();
+    EXPECT_EQ(static_cast<int>(mesh->get_LineCollection()->size_all()), nLines);
+
+    delete mesh;
+}
+
+TEST(testAdjacency, edgesAfterPartitioning)
+{
+    const int n = 3;
+    Mesh* mesh = MeshFactory::makeMesh(n, n, n, 1., 1., 1.);
+    mesh->SetPartitioning("TRIVIAL");
+    mesh->CreateFacesFromCells();
+    mesh->CreateEdgesFromCells();
+    auto nLines = static_cast<int>(mesh->get_LineCollection()->size_all());
+    mesh->PerformPolyhedronPartitioning(ELEMENTS::FAMILY::POLYGON, ELEMENTS::FAMILY::POLYGON);
+    auto adjacencySet = mesh->getAdjacencySet();
+
+    //The edge adjacencies registered before partitioning are kept on the partition numbering
+    auto lines = mesh->get_LineCollection();
+    EXPECT_EQ(static_cast<int>(lines->size_all()), nLines);
+    auto cellToEdge = adjacencySet->get_TopologicalAdjacency(ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::FAMILY::LINE, ELEMENTS::FAMILY::POLYHEDRON);
+    auto csr = cellToEdge->get_adjacencySparseMatrix();
+    EXPECT_EQ(csr->dimRow, static_cast<int>(mesh->get_PolyhedronCollection()->size_all()));
+    EXPECT_EQ(csr->dimColumn, nLines);
+    for (int i = 0; i != csr->dimRow; ++i)
+    {
+        ASSERT_EQ(csr->rowPtr[i + 1] - csr->rowPtr[i], 12);
+        auto& cellVertices = (*mesh->get_PolyhedronCollection())[i]->get_vertexList();
+        for (auto j = csr->rowPtr[i]; j != csr->rowPtr[i + 1]; ++j)
+        {
+            EXPECT_EQ(csr->values[j], i);
+            for (auto vertex : (*lines)[csr->columnIndex[j]]->get_vertexList())
+            {
+                EXPECT_NE(std::find(cellVertices.begin(), cellVertices.end(), vertex), cellVertices.end());
+            }
+        }
+    }
+
+    auto faceToEdge = adjacencySet->get_TopologicalAdjacency(ELEMENTS::FAMILY::POLYGON, ELEMENTS::FAMILY::LINE, ELEMENTS::FAMILY::POLYGON);
+    EXPECT_EQ(faceToEdge->get_adjacencySparseMatrix()->dimRow, static_cast<int>(mesh->get_PolygonCollection()->size_all()));
+    EXPECT_EQ(faceToEdge->get_adjacencySparseMatrix()->nnz, 4 * faceToEdge->get_adjacencySparseMatrix()->dimRow);
+
+    //Adjacencies derived from the edges are built again on demand
+    auto edgeToCell = adjacencySet->get_TopologicalAdjacency(ELEMENTS::FAMILY::LINE, ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::FAMILY::POLYHEDRON);
+    EXPECT_EQ(edgeToCell->get_adjacencySparseMatrix()->dimRow, nLines);
+    EXPECT_EQ(edgeToCell->get_adjacencySparseMatrix()->nnz, csr->nnz);
+
+    delete mesh;
+}
@@ -0,0 +1,178 @@
+/*
+ * ------------------------------------------------------------------------------------------------------------
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ * Copyright (c) 2018-2020 Lawrence Livermore National Security LLC
+ * Copyright (c) 2018-2020 The Board of Trustees of the Leland Stanford Junior University
+ * Copyright (c) 2018-2020 Total, S.A
+ * Copyright (c) 2020-     GEOSX Contributors
+ * All right reserved
+ *
+ * See top level LICENSE, COPYRIGHT, CONTRIBUTORS, NOTICE, and ACKNOWLEDGEMENTS files for details.
+ * ------------------------------------------------------------------------------------------------------------
+ */
+
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "Parallel/Communicator.hpp"
+#include "Mesh/MeshFactory.hpp"
+#include "Mesh/MeshCheckpoint.hpp"
+#include "Adjacency/Adjacency.hpp"
+#include "gtest/gtest.h"
+
+using namespace PAMELA;
+
+int main(int argc, char **argv) {
+    Communicator::initialize();
+    ::testing::InitGoogleTest(&argc, argv);
+    int const result = RUN_ALL_TESTS();
+    Communicator::finalize();
+    return result;
+}
+
+namespace {
+
+    //Corner-point grid of nx x ny x nz unit cells with a distinct porosity and permeability per cell
+    std::string writeDeck(const std::string& path, int nx, int ny, int nz) {
+        std::ofstream file(path);
+        file << "SPECGRID\n" << nx << " " << ny << " " << nz << " 1 F /\n\nCOORD\n";
+        for (int j = 0; j <= ny; ++j) {
+            for (int i = 0; i <= nx; ++i) {
+                file << i << " " << j << " 0 " << i << " " << j << " " << nz << "\n";
+            }
+        }
+        file << "/\n\nZCORN\n";
+        for (int k = 0; k < nz; ++k) {
+            for (int tb = 0; tb < 2; ++tb) {
+                file << 4 * nx * ny << "*" << k + tb << "\n";
+            }
+        }
+        file << "/\n\nACTNUM\n" << nx * ny * nz << "*1 /\n";
+        const char* keywords[] = { "PORO", "PERMX", "PERMY", "PERMZ" };
+        for (int p = 0; p < 4; ++p) {
+            file << "\n" << keywords[p] << "\n";
+            for (int c = 0; c < nx * ny * nz; ++c) {
+                file << 0.01 * (c + 1) + p << "\n";
+            }
+            file << "/\n";
+        }
+        return path;
+    }
+
+    template <class Collection>
+    void expectSameElements(Collection* expected, Collection* actual) {
+        ASSERT_EQ(expected->size_all(), actual->size_all());
+        EXPECT_EQ(expected->size_owned(), actual->size_owned());
+        for (std::size_t i = 0; i != expected->size_all(); ++i) {
+            auto a = (*expected)[i];
+            auto b = (*actual)[i];
+            EXPECT_EQ(a->get_localIndex(), b->get_localIndex());
+            EXPECT_EQ(a->get_globalIndex(), b->get_globalIndex());
+            EXPECT_EQ(a->get_partitionOwner(), b->get_partitionOwner());
+            EXPECT_EQ(a->get_vtkType(), b->get_vtkType());
+            auto& va = a->get_vertexList();
+            auto& vb = b->get_vertexList();
+            ASSERT_EQ(va.size(), vb.size());
+            for (std::size_t k = 0; k != va.size(); ++k) {
+                EXPECT_EQ(va[k]->get_localIndex(), vb[k]->get_localIndex());
+                EXPECT_EQ(va[k]->get_globalIndex(), vb[k]->get_globalIndex());
+            }
+        }
+    }
+
+    void expectSameAdjacency(Adjacency* expected, Adjacency* actual) {
+        auto a = expected->get_adjacencySparseMatrix();
+        auto b = actual->get_adjacencySparseMatrix();
+        EXPECT_EQ(a->dimRow, b->dimRow);
+        EXPECT_EQ(a->dimColumn, b->dimColumn);
+        EXPECT_EQ(a->nnz, b->nnz);
+        EXPECT_EQ(a->rowPtr, b->rowPtr);
+        EXPECT_EQ(a->columnIndex, b->columnIndex);
+        EXPECT_EQ(a->values, b->values);
+        EXPECT_EQ(expected->get_Weights(), actual->get_Weights());
+        EXPECT_EQ(expected->get_sourceFamily(), actual->get_sourceFamily());
+        EXPECT_EQ(expected->get_targetFamily(), actual->get_targetFamily());
+        EXPECT_EQ(expected->get_baseFamily(), actual->get_baseFamily());
+    }
+
+}
+
+TEST(testCheckpoint, roundTrip)
+{
+    Mesh* mesh = MeshFactory::makeMesh(writeDeck("checkpoint.grdecl", 4, 3, 2));
+    mesh->CreateFacesFromCells();
+    mesh->PerformPolyhedronPartitioning(ELEMENTS::FAMILY::POLYGON, ELEMENTS::FAMILY::POLYGON);
+    mesh->CreateEdgesFromCells();
+    auto adjacencySet = mesh->getAdjacencySet();
+    auto cellToCell = adjacencySet->get_TopologicalAdjacency(ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::FAMILY::POLYGON);
+
+    //Weighted non-topological adjacency, as transmissibilities would be
+    auto weighted = new Adjacency(ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::FAMILY::UNKNOWN,
+        mesh->get_PolyhedronCollection(), mesh->get_PolyhedronCollection(), nullptr, new CSRMatrix(*cellToCell->get_adjacencySparseMatrix()));
+    for (std::size_t i = 0; i != weighted->get_adjacencySparseMatrix()->columnIndex.size(); ++i) {
+        weighted->get_Weights().push_back(0.5 * static_cast<double>(i));
+    }
+    adjacencySet->Add_NonTopologicalAdjacency("TRANS", weighted);
+
+    mesh->Save("checkpoint.pmesh");
+    Mesh* loaded = MeshFactory::makeMesh("checkpoint.pmesh");
+    ASSERT_NE(loaded, nullptr);
+
+    EXPECT_EQ(loaded->get_PolyhedronCollection()->size_all(), 24u);
+    expectSameElements(mesh->get_PointCollection(), loaded->get_PointCollection());
+    expectSameElements(mesh->get_LineCollection(), loaded->get_LineCollection());
+    expectSameElements(mesh->get_PolygonCollection(), loaded->get_PolygonCollection());
+    expectSameElements(mesh->get_PolyhedronCollection(), loaded->get_PolyhedronCollection());
+
+    auto& properties = mesh->get_PolyhedronProperty_double()->get_PropertyMap();
+    auto& loadedProperties = loaded->get_PolyhedronProperty_double()->get_PropertyMap();
+    EXPECT_EQ(properties.size(), loadedProperties.size());
+    ASSERT_EQ(loadedProperties.count("PORO"), 1u);
+    ASSERT_EQ(loadedProperties.count("PERM"), 1u);
+    for (auto& property : properties) {
+        ASSERT_EQ(loadedProperties.count(property.first), 1u);
+        auto& loadedProperty = loadedProperties.at(property.first);
+        EXPECT_EQ(property.second.size_owned(), loadedProperty.size_owned());
+        EXPECT_EQ(property.second.data_all(), loadedProperty.data_all());
+    }
+
+    //Cached adjacencies are read back, not derived again
+    auto loadedSet = loaded->getAdjacencySet();
+    EXPECT_GT(loadedSet->get_MemoryFootprint(ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::FAMILY::POLYGON), 0u);
+    EXPECT_GT(loadedSet->get_MemoryFootprint(ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::FAMILY::POLYGON, ELEMENTS::FAMILY::POLYHEDRON), 0u);
+    expectSameAdjacency(cellToCell, loadedSet->get_TopologicalAdjacency(ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::FAMILY::POLYGON));
+    expectSameAdjacency(adjacencySet->get_TopologicalAdjacency(ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::FAMILY::POLYGON, ELEMENTS::FAMILY::POLYHEDRON),
+        loadedSet->get_TopologicalAdjacency(ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::FAMILY::POLYGON, ELEMENTS::FAMILY::POLYHEDRON));
+    expectSameAdjacency(weighted, loadedSet->get_NonTopologicalAdjacency("TRANS"));
+
+    //Adjacencies derived after loading match the ones of the original mesh
+    expectSameAdjacency(adjacencySet->get_TopologicalAdjacency(ELEMENTS::FAMILY::LINE, ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::FAMILY::POLYHEDRON),
+        loadedSet->get_TopologicalAdjacency(ELEMENTS::FAMILY::LINE, ELEMENTS::FAMILY::POLYHEDRON, ELEMENTS::FAMILY::POLYHEDRON));
+
+    EXPECT_EQ(mesh->getNeighborList(), loaded->getNeighborList());
+
+    delete loaded;
+    delete mesh;
+}
+
+TEST(testCheckpoint, versionMismatch)
+{
+    Mesh* mesh = MeshFactory::makeMesh(writeDeck("checkpoint_version.grdecl", 2, 2, 1));
+    mesh->CreateFacesFromCells();
+    mesh->Save("checkpoint_version.pmesh");
+    delete mesh;
+
+    //The version follows the 8 bytes of the magic number. The error is logged on the standard output, hence the empty death message
+    std::fstream file("checkpoint_version.pmesh", std::ios::in | std::ios::out | std::ios::binary);
+    std::uint32_t version = MeshCheckpoint::VERSION + 1;
+    file.seekp(8);
+    file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    file.close();
+
+    ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+    EXPECT_DEATH(MeshCheckpoint::Load("checkpoint_version.pmesh"), "");
+}
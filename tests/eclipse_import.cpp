@@ -0,0 +1,163 @@
+/*
+ * ------------------------------------------------------------------------------------------------------------
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ * Copyright (c) 2018-2020 Lawrence Livermore National Security LLC
+ * Copyright (c) 2018-2020 The Board of Trustees of the Leland Stanford Junior University
+ * Copyright (c) 2018-2020 Total, S.A
+ * Copyright (c) 2020-     GEOSX Contributors
+ * All right reserved
+ *
+ * See top level LICENSE, COPYRIGHT, CONTRIBUTORS, NOTICE, and ACKNOWLEDGEMENTS files for details.
+ * ------------------------------------------------------------------------------------------------------------
+ */
+
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "Parallel/Communicator.hpp"
+#include "Mesh/MeshFactory.hpp"
+#include "Adjacency/Adjacency.hpp"
+#include "gtest/gtest.h"
+
+using namespace PAMELA;
+
+int main(int argc, char **argv) {
+    Communicator::initialize();
+    ::testing::InitGoogleTest(&argc, argv);
+    int const result = RUN_ALL_TESTS();
+    Communicator::finalize();
+    return result;
+}
+
+namespace {
+
+    //Eclipse binary files are big-endian Fortran records
+    class BinaryWriter {
+    public:
+        explicit BinaryWriter(const std::string& path) : m_file(path, std::ios::binary) {}
+
+        void write(std::string keyword, const std::vector<int>& data) { write(keyword, data, "INTE"); }
+        void write(std::string keyword, const std::vector<float>& data) { write(keyword, data, "REAL"); }
+
+    private:
+        std::ofstream m_file;
+
+        void writeBits(std::uint32_t bits) {
+            char bytes[4] = { char(bits >> 24), char(bits >> 16), char(bits >> 8), char(bits) };
+            m_file.write(bytes, 4);
+        }
+
+        template <typename T>
+        void write(std::string keyword, const std::vector<T>& data, const char* type) {
+            keyword.resize(8, ' ');
+            writeBits(16);
+            m_file.write(keyword.data(), 8);
+            writeBits(static_cast<std::uint32_t>(data.size()));
+            m_file.write(type, 4);
+            writeBits(16);
+            writeBits(static_cast<std::uint32_t>(4 * data.size()));
+            for (auto value : data) {
+                std::uint32_t bits;
+                std::memcpy(&bits, &value, 4);
+                writeBits(bits);
+            }
+            writeBits(static_cast<std::uint32_t>(4 * data.size()));
+        }
+    };
+
+    //Row of 3 x 1 x 1 unit cells whose first cell is active but flat, so that it is not added to the mesh.
+    //An NNC joins cells 2 and 3 and a producer heads in cell 3 with a completion in cell completionI.
+    std::string writeDeck(const std::string& name, int completionI) {
+        const int nx = 3;
+        std::vector<int> gridhead(100, 0);
+        gridhead[0] = 1;
+        gridhead[1] = nx;
+        gridhead[2] = gridhead[3] = 1;
+        std::vector<float> coord;
+        for (int j = 0; j <= 1; ++j) {
+            for (int i = 0; i <= nx; ++i) {
+                std::vector<float> pillar = { float(i), float(j), 0.f, float(i), float(j), 1.f };
+                coord.insert(coord.end(), pillar.begin(), pillar.end());
+            }
+        }
+        std::vector<float> zcorn(8 * nx, 1.f);
+        std::fill(zcorn.begin(), zcorn.begin() + 4 * nx, 0.f);
+        zcorn[4 * nx] = zcorn[4 * nx + 1] = zcorn[6 * nx] = zcorn[6 * nx + 1] = 0.f;
+
+        BinaryWriter egrid(name + ".EGRID");
+        egrid.write("GRIDHEAD", gridhead);
+        egrid.write("COORD", coord);
+        egrid.write("ZCORN", zcorn);
+        egrid.write("ACTNUM", std::vector<int>(nx, 1));
+        std::vector<int> nnchead(10, 0);
+        nnchead[0] = 1;
+        egrid.write("NNCHEAD", nnchead);
+        egrid.write("NNC1", std::vector<int>{ 2 });
+        egrid.write("NNC2", std::vector<int>{ 3 });
+
+        BinaryWriter init(name + ".INIT");
+        init.write("TRANNNC", std::vector<float>{ 0.5f });
+
+        std::vector<int> intehead(100, 0);
+        intehead[16] = 1;
+        intehead[17] = 1;
+        intehead[24] = 10;
+        intehead[32] = 5;
+        intehead[33] = 5;
+        std::vector<int> iwel(10, 0);
+        iwel[0] = nx;
+        iwel[1] = iwel[2] = 1;
+        iwel[4] = 1;
+        iwel[6] = 1;
+        std::vector<int> icon = { 1, completionI, 1, 1, 0 };
+        BinaryWriter unrst(name + ".UNRST");
+        unrst.write("INTEHEAD", intehead);
+        unrst.write("IWEL", iwel);
+        unrst.write("ICON", icon);
+        unrst.write("SCON", std::vector<float>{ 1.f, 0.f, 0.f, 1.f, 0.f });
+        return name + ".EGRID";
+    }
+
+}
+
+TEST(testEclipseImport, connectionsSkipFlatHexa)
+{
+    Mesh* mesh = MeshFactory::makeMesh(writeDeck("eclipse_flat", 2));
+    auto polyhedra = mesh->get_PolyhedronCollection();
+    ASSERT_EQ(polyhedra->size_all(), 2u);
+
+    //The NNC between cells 2 and 3 joins the two polyhedra
+    auto nnc = mesh->getAdjacencySet()->get_NonTopologicalAdjacency("NNCs");
+    auto csr = nnc->get_adjacencySparseMatrix();
+    EXPECT_EQ(csr->dimRow, 2);
+    ASSERT_EQ(csr->columnIndex.size(), 1u);
+    EXPECT_EQ(csr->rowPtr[1], 1);
+    EXPECT_EQ(csr->columnIndex[0], 1);
+    ASSERT_EQ(nnc->get_Weights().size(), 1u);
+    EXPECT_EQ(nnc->get_Weights()[0], 0.5);
+
+    //The well heads at the centroid of cell 3 and is completed at the centroid of cell 2
+    auto wells = mesh->get_ImplicitLineCollection();
+    ASSERT_EQ(wells->size_all(), 1u);
+    auto& vertices = (*wells)[0]->get_vertexList();
+    ASSERT_EQ(vertices.size(), 2u);
+    EXPECT_DOUBLE_EQ(vertices[0]->get_coordinates().x, 2.5);
+    EXPECT_DOUBLE_EQ(vertices[0]->get_coordinates().y, 0.5);
+    EXPECT_DOUBLE_EQ(vertices[1]->get_coordinates().x, 1.5);
+    EXPECT_DOUBLE_EQ(vertices[1]->get_coordinates().y, 0.5);
+    EXPECT_DOUBLE_EQ(vertices[1]->get_coordinates().z, 0.5);
+    delete mesh;
+}
+
+TEST(testEclipseImport, completionInFlatHexa)
+{
+    //The error is logged on the standard output, hence the empty death message
+    auto deck = writeDeck("eclipse_flat_completion", 1);
+    ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+    EXPECT_DEATH(MeshFactory::makeMesh(deck), "");
+}
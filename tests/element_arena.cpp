@@ -0,0 +1,228 @@
+/*
+ * ------------------------------------------------------------------------------------------------------------
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ * Copyright (c) 2018-2020 Lawrence Livermore National Security LLC
+ * Copyright (c) 2018-2020 The Board of Trustees of the Leland Stanford Junior University
+ * Copyright (c) 2018-2020 Total, S.A
+ * Copyright (c) 2020-     GEOSX Contributors
+ * All right reserved
+ *
+ * See top level LICENSE, COPYRIGHT, CONTRIBUTORS, NOTICE, and ACKNOWLEDGEMENTS files for details.
+ * ------------------------------------------------------------------------------------------------------------
+ */
+
+
+#include <vector>
+
+#include "Parallel/Communicator.hpp"
+#include "Elements/ElementArena.hpp"
+#include "Elements/ElementFactory.hpp"
+#include "Mesh/MeshFactory.hpp"
+#include "Mesh/UnstructuredMesh.hpp"
+#include "gtest/gtest.h"
+
+using namespace PAMELA;
+
+int main(int argc, char **argv) {
+    Communicator::initialize();
+    ::testing::InitGoogleTest(&argc, argv);
+    int const result = RUN_ALL_TESTS();
+    Communicator::finalize();
+    return result;
+}
+
+namespace {
+
+    //Counts the live instances to check that the arena runs the destructors
+    struct Counted {
+        explicit Counted(int v) : value(v) { ++live; }
+        ~Counted() { --live; }
+        int value;
+        static int live;
+    };
+    int Counted::live = 0;
+
+    class CompactedMesh : public UnstructuredMesh {
+    public:
+        using UnstructuredMesh::ReleaseUnreferencedElements;
+    };
+
+}
+
+TEST(testElementArena, releaseAndReuse)
+{
+    ElementArena arena;
+    std::vector<Counted*> elements;
+    for (int i = 0; i != 10; ++i) {
+        elements.push_back(arena.Create<Counted>(i));
+    }
+    EXPECT_EQ(Counted::live, 10);
+    EXPECT_EQ(arena.get_ElementCount(), 10u);
+
+    EXPECT_TRUE(arena.Release(elements[3]));
+    EXPECT_EQ(Counted::live, 9);
+    EXPECT_EQ(arena.get_ElementCount(), 9u);
+
+    //A released slot is not released twice, and foreign pointers are rejected
+    EXPECT_FALSE(arena.Release(elements[3]));
+    int notOwned = 0;
+    EXPECT_FALSE(arena.Owns(&notOwned));
+    EXPECT_FALSE(arena.Release(&notOwned));
+    EXPECT_EQ(Counted::live, 9);
+
+    //The freed slot is the next one used
+    Counted* reused = arena.Create<Counted>(42);
+    EXPECT_EQ(reused, elements[3]);
+    EXPECT_EQ(reused->value, 42);
+    EXPECT_EQ(elements[4]->value, 4);
+    EXPECT_EQ(arena.get_ElementCount(), 10u);
+}
+
+TEST(testElementArena, clear)
+{
+    ElementArena arena;
+    std::vector<Counted*> elements;
+    for (int i = 0; i != 3000; ++i) {
+        elements.push_back(arena.Create<Counted>(i));
+    }
+    arena.Create<double>(1.);
+    EXPECT_EQ(Counted::live, 3000);
+    auto footprint = arena.get_MemoryFootprint();
+    EXPECT_GT(footprint, 3000 * sizeof(Counted));
+
+    arena.Clear();
+    EXPECT_EQ(Counted::live, 0);
+    EXPECT_EQ(arena.get_ElementCount(), 0u);
+    EXPECT_LE(arena.get_MemoryFootprint() + 3000 * sizeof(Counted), footprint);
+    EXPECT_FALSE(arena.Owns(elements.front()));
+    EXPECT_FALSE(arena.Owns(elements.back()));
+
+    //The arena is usable after being cleared
+    Counted* element = arena.Create<Counted>(7);
+    EXPECT_TRUE(arena.Owns(element));
+    EXPECT_EQ(Counted::live, 1);
+    arena.Clear();
+    EXPECT_EQ(Counted::live, 0);
+}
+
+TEST(testElementArena, duplicatedImplicitLine)
+{
+    Mesh* mesh = MeshFactory::makeMesh(1, 1, 1, 1., 1., 1.);
+    auto& arena = mesh->get_ElementArena();
+    std::vector<Point*> points;
+    for (int i = 0; i != 3; ++i) {
+        points.push_back(ElementFactory::makePoint(arena, ELEMENTS::TYPE::VTK_VERTEX, -1, 0., 0., static_cast<double>(i)));
+    }
+    mesh->AddImplicitLine(ELEMENTS::TYPE::VTK_LINE, "WELL", points);
+    auto nElements = arena.get_ElementCount();
+    EXPECT_EQ(mesh->get_ImplicitLineCollection()->size_all(), 2u);
+
+    //The lines rejected as duplicates go back to the arena
+    mesh->AddImplicitLine(ELEMENTS::TYPE::VTK_LINE, "WELL", points);
+    EXPECT_EQ(mesh->get_ImplicitLineCollection()->size_all(), 2u);
+    EXPECT_EQ(arena.get_ElementCount(), nElements);
+    delete mesh;
+}
+
+TEST(testElementArena, compactRelocatesMeshElements)
+{
+    //Several blocks of points and tetrahedra, with unreferenced elements scattered among them
+    const int n = 15;
+    CompactedMesh mesh;
+    auto& arena = mesh.get_ElementArena();
+    auto pointIndex = [n](int i, int j, int k) { return i + n * (j + n * k); };
+    for (int k = 0; k != n; ++k) {
+        for (int j = 0; j != n; ++j) {
+            for (int i = 0; i != n; ++i) {
+                mesh.addPoint(ELEMENTS::TYPE::VTK_VERTEX, pointIndex(i, j, k), (i % 2 == 0) ? "EVEN" : "ODD", i, j, k);
+                if (pointIndex(i, j, k) % 3 == 0) {
+                    ElementFactory::makePoint(arena, ELEMENTS::TYPE::VTK_VERTEX, -1, -1., -1., -1.);
+                }
+            }
+        }
+    }
+    auto points = mesh.get_PointCollection();
+    std::vector<std::vector<int>> tetraVertices;
+    for (int k = 0; k != n - 1; ++k) {
+        for (int j = 0; j != n - 1; ++j) {
+            for (int i = 0; i != n - 1; ++i) {
+                std::vector<int> vertices = { pointIndex(i, j, k), pointIndex(i + 1, j, k), pointIndex(i, j + 1, k), pointIndex(i, j, k + 1) };
+                std::vector<Point*> vertexList;
+                for (auto v : vertices) {
+                    vertexList.push_back((*points)[v]);
+                }
+                int index = static_cast<int>(tetraVertices.size());
+                mesh.addPolyhedron(ELEMENTS::TYPE::VTK_TETRA, index, (index % 2 == 0) ? "EVEN" : "ODD", vertexList);
+                tetraVertices.push_back(vertices);
+                if (index % 4 == 1) {
+                    ElementFactory::makePolyhedron(arena, ELEMENTS::TYPE::VTK_TETRA, -1, vertexList);
+                }
+            }
+        }
+    }
+    auto polyhedra = mesh.get_PolyhedronCollection();
+    const std::size_t nPoints = n * n * n;
+    const std::size_t nTetras = tetraVertices.size();
+    ASSERT_EQ(points->size_all(), nPoints);
+    ASSERT_EQ(polyhedra->size_all(), nTetras);
+    ASSERT_GT(nPoints, 2048u);
+    ASSERT_GT(nTetras, 2048u);
+
+    std::vector<const void*> before;
+    for (std::size_t i = 0; i != nPoints; ++i) {
+        before.push_back((*points)[i]);
+    }
+    for (std::size_t i = 0; i != nTetras; ++i) {
+        before.push_back((*polyhedra)[i]);
+    }
+    auto footprint = arena.get_MemoryFootprint();
+
+    mesh.ReleaseUnreferencedElements();
+
+    EXPECT_EQ(arena.get_ElementCount(), nPoints + nTetras);
+    EXPECT_LT(arena.get_MemoryFootprint(), footprint);
+    std::size_t nMoved = 0;
+    for (std::size_t i = 0; i != nPoints; ++i) {
+        Point* point = (*points)[i];
+        nMoved += (point != before[i]) ? 1 : 0;
+        ASSERT_TRUE(arena.Owns(point));
+        EXPECT_EQ(point->get_localIndex(), static_cast<int>(i));
+        EXPECT_EQ(point->get_globalIndex(), static_cast<int>(i));
+        auto coordinates = point->get_coordinates();
+        EXPECT_EQ(pointIndex(static_cast<int>(coordinates.x), static_cast<int>(coordinates.y), static_cast<int>(coordinates.z)), static_cast<int>(i));
+    }
+    for (std::size_t i = 0; i != nTetras; ++i) {
+        Polyhedron* tetra = (*polyhedra)[i];
+        nMoved += (tetra != before[nPoints + i]) ? 1 : 0;
+        ASSERT_TRUE(arena.Owns(tetra));
+        EXPECT_EQ(tetra->get_localIndex(), static_cast<int>(i));
+        EXPECT_EQ(tetra->get_globalIndex(), static_cast<int>(i));
+        auto& vertexList = tetra->get_vertexList();
+        ASSERT_EQ(vertexList.size(), 4u);
+        for (std::size_t v = 0; v != 4; ++v) {
+            EXPECT_EQ(vertexList[v], (*points)[tetraVertices[i][v]]);
+        }
+    }
+    EXPECT_GT(nMoved, 0u);
+
+    //Groups hold the relocated elements of their collection
+    std::size_t nGrouped = 0;
+    for (auto& group : points->get_labelToGroupMap()) {
+        for (std::size_t i = 0; i != group.second->size_all(); ++i) {
+            Point* point = (*group.second)[i];
+            ASSERT_TRUE(arena.Owns(point));
+            EXPECT_EQ(point, (*points)[point->get_localIndex()]);
+            ++nGrouped;
+        }
+    }
+    for (auto& group : polyhedra->get_labelToGroupMap()) {
+        for (std::size_t i = 0; i != group.second->size_all(); ++i) {
+            Polyhedron* tetra = (*group.second)[i];
+            ASSERT_TRUE(arena.Owns(tetra));
+            EXPECT_EQ(tetra, (*polyhedra)[tetra->get_localIndex()]);
+            ++nGrouped;
+        }
+    }
+    EXPECT_EQ(nGrouped, nPoints + nTetras);
+}
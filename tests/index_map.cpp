@@ -0,0 +1,60 @@
+/*
+ * ------------------------------------------------------------------------------------------------------------
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ * Copyright (c) 2018-2020 Lawrence Livermore National Security LLC
+ * Copyright (c) 2018-2020 The Board of Trustees of the Leland Stanford Junior University
+ * Copyright (c) 2018-2020 Total, S.A
+ * Copyright (c) 2020-     GEOSX Contributors
+ * All right reserved
+ *
+ * See top level LICENSE, COPYRIGHT, CONTRIBUTORS, NOTICE, and ACKNOWLEDGEMENTS files for details.
+ * ------------------------------------------------------------------------------------------------------------
+ */
+
+
+#include <stdexcept>
+#include <vector>
+
+#include "Utils/IndexMap.hpp"
+#include "gtest/gtest.h"
+
+using namespace PAMELA;
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
+
+//Compact keys are stored densely, spread ones in a hash table
+static const std::vector<int> compactKeys = { 12, 10, -1, 11, -1, 13 };
+static const std::vector<int> scatteredKeys = { 1000000, 7, -1, 2000000000, -1, 42 };
+
+TEST(testIndexMap, lookup)
+{
+    for (auto keys : { compactKeys, scatteredKeys })
+    {
+        IndexMap map;
+        map.Build(keys);
+        EXPECT_EQ(map.IsDense(), keys == compactKeys);
+        EXPECT_EQ(map.size(), 5u);
+        EXPECT_EQ(map.at(keys[0]), 0);
+        EXPECT_EQ(map.at(keys[5]), 5);
+        EXPECT_EQ(map.find(3), -1);
+        EXPECT_EQ(map.count(3), 0u);
+        EXPECT_THROW(map.at(3), std::out_of_range);
+    }
+}
+
+TEST(testIndexMap, duplicates)
+{
+    for (auto keys : { compactKeys, scatteredKeys })
+    {
+        IndexMap first, last;
+        first.Build(keys);
+        last.Build(keys, IndexMap::DUPLICATES::KEEP_LAST);
+        EXPECT_EQ(first.at(-1), 2);
+        EXPECT_EQ(last.at(-1), 4);
+        EXPECT_EQ(last.size(), 5u);
+    }
+}
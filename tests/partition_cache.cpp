@@ -0,0 +1,94 @@
+/*
+ * ------------------------------------------------------------------------------------------------------------
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ * Copyright (c) 2018-2020 Lawrence Livermore National Security LLC
+ * Copyright (c) 2018-2020 The Board of Trustees of the Leland Stanford Junior University
+ * Copyright (c) 2018-2020 Total, S.A
+ * Copyright (c) 2020-     GEOSX Contributors
+ * All right reserved
+ *
+ * See top level LICENSE, COPYRIGHT, CONTRIBUTORS, NOTICE, and ACKNOWLEDGEMENTS files for details.
+ * ------------------------------------------------------------------------------------------------------------
+ */
+
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "Parallel/Communicator.hpp"
+#include "Mesh/MeshFactory.hpp"
+#include "Utils/File.hpp"
+#include "gtest/gtest.h"
+
+using namespace PAMELA;
+
+int main(int argc, char **argv) {
+    Communicator::initialize();
+    ::testing::InitGoogleTest(&argc, argv);
+    int const result = RUN_ALL_TESTS();
+    Communicator::finalize();
+    return result;
+}
+
+namespace {
+
+    //Deck of 2 x 2 x 1 unit cells whose grid and porosity live in an included file
+    void writeDeck(const std::string& deck, const std::string& grid, double poro) {
+        std::ofstream file(deck);
+        file << "SPECGRID\n2 2 1 1 F /\n\nINCLUDE\n'" << File(grid).getShortName() << "' /\n";
+        std::ofstream include(grid);
+        include << "COORD\n";
+        for (int j = 0; j <= 2; ++j) {
+            for (int i = 0; i <= 2; ++i) {
+                include << i << " " << j << " 0 " << i << " " << j << " 1\n";
+            }
+        }
+        include << "/\n\nZCORN\n16*0 16*1 /\n\nACTNUM\n4*1 /\n\nPORO\n4*" << poro << " /\n";
+    }
+
+}
+
+TEST(testPartitionCache, hitMissAndInvalidation)
+{
+    const std::string deck = "partition_cache.grdecl";
+    const std::string grid = "partition_cache_grid.inc";
+    const std::string cacheDirectory = ".";
+    writeDeck(deck, grid, 0.2);
+
+    //Miss: the partition is imported and saved
+    std::string partitionFile = MeshFactory::partitionCacheFile(deck, cacheDirectory, ELEMENTS::FAMILY::POLYGON, ELEMENTS::FAMILY::POLYGON, "TRIVIAL");
+    std::remove(partitionFile.c_str());
+    Mesh* mesh = MeshFactory::makePartitionedMesh(deck, cacheDirectory, ELEMENTS::FAMILY::POLYGON, ELEMENTS::FAMILY::POLYGON, "TRIVIAL");
+    EXPECT_EQ(mesh->get_PolyhedronCollection()->size_all(), 4u);
+    EXPECT_TRUE(File(partitionFile).exists());
+    delete mesh;
+
+    //Hit: the saved partition is read back, whatever it holds
+    Mesh* other = MeshFactory::makeMesh(1, 1, 1, 1., 1., 1.);
+    other->CreateFacesFromCells();
+    other->Save(partitionFile);
+    delete other;
+    EXPECT_EQ(MeshFactory::partitionCacheFile(deck, cacheDirectory, ELEMENTS::FAMILY::POLYGON, ELEMENTS::FAMILY::POLYGON, "TRIVIAL"), partitionFile);
+    mesh = MeshFactory::makePartitionedMesh(deck, cacheDirectory, ELEMENTS::FAMILY::POLYGON, ELEMENTS::FAMILY::POLYGON, "TRIVIAL");
+    EXPECT_EQ(mesh->get_PolyhedronCollection()->size_all(), 1u);
+    delete mesh;
+
+    //Other settings do not share the partition
+    EXPECT_NE(MeshFactory::partitionCacheFile(deck, cacheDirectory, ELEMENTS::FAMILY::POLYGON, ELEMENTS::FAMILY::POLYGON, "METIS"), partitionFile);
+
+    //Invalidation: editing the included file changes the key and the mesh is imported again
+    writeDeck(deck, grid, 0.3);
+    std::string newPartitionFile = MeshFactory::partitionCacheFile(deck, cacheDirectory, ELEMENTS::FAMILY::POLYGON, ELEMENTS::FAMILY::POLYGON, "TRIVIAL");
+    EXPECT_NE(newPartitionFile, partitionFile);
+    std::remove(newPartitionFile.c_str());
+    mesh = MeshFactory::makePartitionedMesh(deck, cacheDirectory, ELEMENTS::FAMILY::POLYGON, ELEMENTS::FAMILY::POLYGON, "TRIVIAL");
+    ASSERT_EQ(mesh->get_PolyhedronCollection()->size_all(), 4u);
+    EXPECT_EQ(mesh->get_PolyhedronProperty_double()->get_PropertyMap().at("PORO")[0], 0.3);
+    EXPECT_TRUE(File(newPartitionFile).exists());
+    delete mesh;
+
+    std::remove(partitionFile.c_str());
+    std::remove(newPartitionFile.c_str());
+}